@@ -49,6 +49,7 @@ THE SOFTWARE.
  * \param [in] cpu_thread_count
  * \param [in] prefetch_queue_depth
  * \param [in] output_tensor_data_type RocalTensorOutputType: Defines whether the output of rocal tensor is FP32 or FP16.
+ * \param [in] cpu_placement RocalCpuPlacement: Defines whether the loader and processing threads and buffers are pinned to the NUMA nodes.
  * \return A \ref RocalContext - The context for the pipeline
  */
 extern "C" RocalContext ROCAL_API_CALL rocalCreate(size_t batch_size,
@@ -56,7 +57,8 @@ extern "C" RocalContext ROCAL_API_CALL rocalCreate(size_t batch_size,
                                                    int gpu_id = 0,
                                                    size_t cpu_thread_count = 1,
                                                    size_t prefetch_queue_depth = 3,
-                                                   RocalTensorOutputType output_tensor_data_type = RocalTensorOutputType::ROCAL_FP32);
+                                                   RocalTensorOutputType output_tensor_data_type = RocalTensorOutputType::ROCAL_FP32,
+                                                   RocalCpuPlacement cpu_placement = RocalCpuPlacement::ROCAL_CPU_PLACEMENT_NONE);
 
 /*!
  * \brief  rocalVerify function to verify the graph for all the inputs and outputs
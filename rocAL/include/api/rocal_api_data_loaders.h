@@ -776,6 +776,32 @@ extern "C" RocalImage ROCAL_API_CALL rocalRawCIFAR10Source(RocalContext context,
  */
 extern "C" RocalStatus ROCAL_API_CALL rocalResetLoaders(RocalContext context);
 
+/*!
+ * \brief Sets the directory used to persist the per dataset sample info tables (dimensions and subsampling of the samples), so later runs skip parsing the headers. Decode failures are only remembered for the current run. The keyframe indices of the videos are persisted there as well.
+ * \ingroup group_rocal_data_loaders
+ * \param cache_dir A NULL terminated char string pointing to the cache directory on the disk, created if it does not exist. An empty string disables persisting the tables.
+ * \note Should be called before the loaders are created, tables are still kept in memory and shared by all the loaders of the process if this function is not called.
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalSetSampleInfoCacheDir(const char *cache_dir);
+
+/*!
+ * \brief Sets the number of threads of the process wide decode pool. The image loaders of all the pipelines and of all their internal shards decode on this pool instead of starting their own threads.
+ * \ingroup group_rocal_data_loaders
+ * \param thread_count The number of decode threads, defaults to the number of physical cores of the machine. The cpu_thread_count of a pipeline still caps the threads a single shard decodes a batch with.
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalSetDecodeThreadBudget(size_t thread_count);
+
+/*!
+ * \brief Sets the share of the process wide decode threads given to the pipeline when several pipelines decode at the same time.
+ * \ingroup group_rocal_data_loaders
+ * \param context Rocal context
+ * \param share Weight of the pipeline, a pipeline with share 2 gets twice the decoded samples of a pipeline with share 1 when both are waiting on the decode threads. Defaults to 1.
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalSetDecodeShare(RocalContext context, unsigned share);
+
 /*!
  * \brief Creates JPEG image reader and partial decoder for Caffe LMDB records. It allocates the resources and objects required to read and decode Jpeg images stored in Caffe2 LMDB Records. It has internal sharding capability to load/decode in parallel is user wants.
  * \ingroup group_rocal_data_loaders
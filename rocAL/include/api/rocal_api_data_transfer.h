@@ -41,6 +41,51 @@ THE SOFTWARE.
  */
 extern "C" RocalStatus ROCAL_API_CALL rocalCopyToOutput(RocalContext context, unsigned char *out_ptr, size_t out_size);
 
+/*!
+ * \brief Returns the size in bytes of the output images of the current batch when copied with rocalCopyToOutputRagged()
+ * \ingroup group_rocal_data_transfer
+ *
+ * \param [in] context
+ * \return The sum of the valid region sizes of all the samples of all the augmentation branches
+ */
+extern "C" size_t ROCAL_API_CALL rocalGetOutputRaggedSize(RocalContext context);
+
+/*!
+ * \brief Copies the output images of the current batch packed back to back, each sample keeps only its valid region (ROI) instead of being padded to the max output size
+ * \ingroup group_rocal_data_transfer
+ *
+ * \param [in] context
+ * \param [out] out_ptr Host buffer receiving the packed samples, of at least rocalGetOutputRaggedSize() bytes
+ * \param [in] out_size Size of out_ptr in bytes
+ * \param [out] shapes Height, width and channels of every sample, 3 x batch size x augmentation branch count values, ignored if NULL
+ * \param [out] offsets Byte offset of every sample in out_ptr, batch size x augmentation branch count values, ignored if NULL
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalCopyToOutputRagged(RocalContext context, unsigned char *out_ptr, size_t out_size, unsigned *shapes, size_t *offsets);
+
+/*!
+ * \brief Gives access to the output images of the current batch in place instead of copying them, the batch is laid out as with rocalCopyToOutput()
+ * \ingroup group_rocal_data_transfer
+ *
+ * \param [in] context
+ * \param [out] out_ptr Host pointer to the output images, stays valid until rocalReleaseOutputLease() is called even after later rocalRun() calls
+ * \param [out] out_size Size of the output images in bytes
+ * \param [out] lease_id Identifies the lease to rocalReleaseOutputLease()
+ * \note Only supported on CPU affinity. The internal queue holds prefetch queue depth batches, the pipeline stalls if the leases keep all of them. All leases must be released before rocalRelease().
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalLeaseOutput(RocalContext context, void **out_ptr, size_t *out_size, int *lease_id);
+
+/*!
+ * \brief Releases an output batch leased with rocalLeaseOutput(), its buffer can be reused for processing the next batches
+ * \ingroup group_rocal_data_transfer
+ *
+ * \param [in] context
+ * \param [in] lease_id The lease returned by rocalLeaseOutput()
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalReleaseOutputLease(RocalContext context, int lease_id);
+
 /*!
  * \brief  TBD
  * \ingroup group_rocal_data_transfer
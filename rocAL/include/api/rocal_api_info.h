@@ -144,4 +144,65 @@ extern "C" const char *ROCAL_API_CALL rocalGetErrorMessage(RocalContext rocal_co
  */
 extern "C" TimingInfo ROCAL_API_CALL rocalGetTimingInfo(RocalContext rocal_context);
 
+/*!
+ * \brief  rocalEnableStats
+ * \ingroup group_rocal_info
+ *
+ * \param [in] context
+ * \param [in] enable Starts or stops recording the latency histograms of the pipeline stages, they are disabled by default
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalEnableStats(RocalContext rocal_context, bool enable);
+
+/*!
+ * \brief  rocalGetPipelineStats
+ * \ingroup group_rocal_info
+ *
+ * \param [in] context
+ * \param [out] stats Per stage counters and p50/p95/p99 latencies, bytes read and buffer occupancy recorded since rocalEnableStats(). Unlike rocalGetTimingInfo(), reading them does not reset them.
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalGetPipelineStats(RocalContext rocal_context, RocalPipelineStats *stats);
+
+/*!
+ * \brief  rocalEnableAutoTune
+ * \ingroup group_rocal_info
+ *
+ * \param [in] context
+ * \param [in] memory_budget Bytes the prefetch buffers of the loader and of the output can take, they are allocated as deep as this budget allows
+ * \param [in] tuning_batch_count Number of batches during which the prefetch depth and the decode threads are adjusted to what the pipeline needs
+ * \note Must be called after rocalCreate() and before the loader is created. Video pipelines are not tuned.
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalEnableAutoTune(RocalContext rocal_context, size_t memory_budget, unsigned tuning_batch_count);
+
+/*!
+ * \brief  rocalGetAutoTuneConfig
+ * \ingroup group_rocal_info
+ *
+ * \param [in] context
+ * \param [out] config The prefetch depth and decode threads chosen so far, which can be passed to rocalCreate() to skip tuning in later runs
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalGetAutoTuneConfig(RocalContext rocal_context, RocalAutoTuneConfig *config);
+
+/*!
+ * \brief  rocalEnableTracing
+ * \ingroup group_rocal_info
+ *
+ * \param [in] trace_file Starts recording the begin and end events of the loader, decode, processing and user threads of all the pipelines, the Chrome trace JSON is written to this file at every rocalRelease(). NULL or an empty string stops recording.
+ * \note Tracing can also be turned on without changing the application by setting the ROCAL_TRACE_FILE environment variable.
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalEnableTracing(const char *trace_file);
+
+/*!
+ * \brief  rocalDumpTrace
+ * \ingroup group_rocal_info
+ *
+ * \param [in] trace_file Writes the events recorded so far as a Chrome trace JSON (chrome://tracing or ui.perfetto.dev) to this file, to the file given to rocalEnableTracing() if NULL.
+ * \return A \ref RocalStatus - A status code indicating the success or failure
+ */
+extern "C" RocalStatus ROCAL_API_CALL rocalDumpTrace(const char *trace_file);
+
 #endif // MIVISIONX_ROCAL_API_INFO_H
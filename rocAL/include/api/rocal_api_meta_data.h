@@ -60,10 +60,12 @@ extern "C" RocalMetaData ROCAL_API_CALL rocalCreateVideoLabelReader(RocalContext
  * \ingroup group_rocal_meta_data
  * \param rocal_context
  * \param source_path path to the coco json file
+ * \param user_keys_for_fields comma separated feature keys of the records given as extra meta data fields, see rocalGetMetaDataField()
  * \return RocalMetaData object, can be used to inquire about the rocal's output (processed) tensors
  */
 extern "C" RocalMetaData ROCAL_API_CALL rocalCreateTFReader(RocalContext rocal_context, const char *source_path, bool is_output,
-                                                            const char *user_key_for_label, const char *user_key_for_filename);
+                                                            const char *user_key_for_label, const char *user_key_for_filename,
+                                                            const char *user_keys_for_fields = nullptr);
 
 /*!
  * \brief  rocalCreateTFReaderDetection
@@ -82,9 +84,10 @@ extern "C" RocalMetaData ROCAL_API_CALL rocalCreateTFReaderDetection(RocalContex
  * \ingroup group_rocal_meta_data
  * \param rocal_context
  * \param source_path path to the coco json file
+ * \param mask also reads the segmentation of each box, given by rocalGetMaskCount(), rocalGetMaskCoordinates() and rocalGetMasks()
  * \return RocalMetaData object, can be used to inquire about the rocal's output (processed) tensors
  */
-extern "C" RocalMetaData ROCAL_API_CALL rocalCreateCOCOReader(RocalContext rocal_context, const char *source_path, bool is_output);
+extern "C" RocalMetaData ROCAL_API_CALL rocalCreateCOCOReader(RocalContext rocal_context, const char *source_path, bool is_output, bool mask = false);
 
 /*!
  * \brief  rocalCreateCOCOReaderKeyPoints
@@ -191,6 +194,7 @@ extern "C" unsigned ROCAL_API_CALL rocalGetBoundingBoxCount(RocalContext rocal_c
  * \ingroup group_rocal_meta_data
  * \param rocal_context
  * \param buf The user's buffer that will be filled with bounding box label info for the images in the output batch. It needs to be of size returned by a call to the rocalGetBoundingBoxCount
+ * \note With rocalBoxEncoder() these are the encoded labels, anchor count per image, also returned by rocalCopyEncodedBoxesAndLables().
  */
 extern "C" void ROCAL_API_CALL rocalGetBoundingBoxLabel(RocalContext rocal_context, int *buf);
 
@@ -198,9 +202,46 @@ extern "C" void ROCAL_API_CALL rocalGetBoundingBoxLabel(RocalContext rocal_conte
  * \brief  rocalGetBoundingBoxCords
  * \ingroup group_rocal_meta_data
  * \param rocal_context
+ * \note With rocalBoxEncoder() these are the encoded boxes, anchor count per image, also returned by rocalCopyEncodedBoxesAndLables().
  */
 extern "C" void ROCAL_API_CALL rocalGetBoundingBoxCords(RocalContext rocal_context, float *buf);
 
+/*!
+ * \brief  rocalGetMaskCount
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param buf The user's buffer that will be filled with the number of polygons of each box of the output batch, in the order of rocalGetBoundingBoxCords(). Run-length encoded masks have none.
+ * \return The number of polygons of the output batch
+ */
+extern "C" unsigned ROCAL_API_CALL rocalGetMaskCount(RocalContext rocal_context, int *buf);
+
+/*!
+ * \brief  rocalGetMaskVertexCount
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param buf The user's buffer that will be filled with the number of vertices of each polygon. It needs to be of the size returned by rocalGetMaskCount()
+ * \return The number of vertices of the output batch
+ */
+extern "C" unsigned ROCAL_API_CALL rocalGetMaskVertexCount(RocalContext rocal_context, int *buf);
+
+/*!
+ * \brief  rocalGetMaskCoordinates
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param buf The user's buffer that will be filled with the x, y pairs of the vertices, normalized to the output image and clipped to it. It needs to hold twice the count returned by rocalGetMaskVertexCount()
+ */
+extern "C" void ROCAL_API_CALL rocalGetMaskCoordinates(RocalContext rocal_context, float *buf);
+
+/*!
+ * \brief  rocalGetMasks
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param buf The user's buffer that will be filled with a height x width mask per box, 1 inside the object and 0 outside, in the order of rocalGetBoundingBoxCords()
+ * \param width width of the masks, usually the one of the output images
+ * \param height height of the masks
+ */
+extern "C" void ROCAL_API_CALL rocalGetMasks(RocalContext rocal_context, unsigned char *buf, unsigned width, unsigned height);
+
 /*!
  * \brief  rocalGetImageSizes
  * \ingroup group_rocal_meta_data
@@ -268,8 +309,9 @@ extern "C" void ROCAL_API_CALL rocalBoxEncoder(RocalContext p_context, std::vect
 /*!
  * \brief  rocalCopyEncodedBoxesAndLables
  * \ingroup group_rocal_meta_data
- * \param boxes_buf  user's buffer that will be filled with encoded bounding boxes . Its needs to be at least of size batch_size.
- * \param labels_buf  user's buffer that will be filled with encoded labels . Its needs to be at least of size batch_size.
+ * \param boxes_buf  user's buffer that will be filled with encoded bounding boxes . Its needs to be at least of size batch_size x anchor count x 4.
+ * \param labels_buf  user's buffer that will be filled with encoded labels . Its needs to be at least of size batch_size x anchor count.
+ * \note rocalGetEncodedBoxesAndLables() returns the same boxes and labels without a copy.
  */
 extern "C" void ROCAL_API_CALL rocalCopyEncodedBoxesAndLables(RocalContext p_context, float *boxes_buf, int *labels_buf);
 
@@ -297,4 +339,108 @@ extern "C" void ROCAL_API_CALL rocalGetImageId(RocalContext p_context, int *buf)
  */
 extern "C" void ROCAL_API_CALL rocalGetJointsDataPtr(RocalContext p_context, RocalJointsData **joints_data);
 
+/*!
+ * \brief  rocalHeatmapTargets
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param heatmap_width width of the heatmap rendered for each joint
+ * \param heatmap_height height of the heatmap rendered for each joint
+ * \param sigma  sigma of the gaussian around each joint, 0 uses the one given to rocalCreateCOCOReaderKeyPoints()
+ * \note The joints are moved to the pose output image given to rocalCreateCOCOReaderKeyPoints() with the affine transform
+ * of their center, scale and rotation, then rendered as batch_size x 17 heatmaps and target weights on the host.
+ */
+extern "C" void ROCAL_API_CALL rocalHeatmapTargets(RocalContext p_context, unsigned heatmap_width, unsigned heatmap_height, float sigma = 0.0);
+
+/*!
+ * \brief  rocalGetHeatmapTargets
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param heatmaps_ptr set to the batch_size x 17 x heatmap_height x heatmap_width heatmaps of the output batch, without a copy
+ * \param target_weights_ptr set to the batch_size x 17 target weights of the output batch
+ */
+extern "C" void ROCAL_API_CALL rocalGetHeatmapTargets(RocalContext p_context, float **heatmaps_ptr, float **target_weights_ptr);
+
+/*!
+ * \brief  rocalCopyHeatmapTargets
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param heatmaps user's buffer of at least batch_size x 17 x heatmap_height x heatmap_width floats
+ * \param target_weights user's buffer of at least batch_size x 17 floats
+ */
+extern "C" void ROCAL_API_CALL rocalCopyHeatmapTargets(RocalContext p_context, float *heatmaps, float *target_weights);
+
+/*!
+ * \brief  rocalGetHeatmapTargetsSize
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param heatmaps_size set to the number of floats of the heatmaps of a batch
+ * \param target_weights_size set to the number of floats of the target weights of a batch
+ */
+extern "C" void ROCAL_API_CALL rocalGetHeatmapTargetsSize(RocalContext p_context, size_t *heatmaps_size, size_t *target_weights_size);
+
+/*!
+ * \brief  rocalLabelEncoder
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param num_classes number of classes of the targets, labels 1 to num_classes are classes 0 to num_classes - 1 and label 0 is the last class
+ * \param on_value target of the classes of a sample, 1 - eps + eps / num_classes for a label smoothing of eps
+ * \param off_value target of the other classes, eps / num_classes for a label smoothing of eps
+ * \param mixup_alpha alpha of the beta distribution of the mixup weights, 0 disables mixup
+ * \param cutmix_alpha alpha of the beta distribution of the cutmix weights, 0 disables cutmix. With both, each mix is one or the other
+ * \param mix_probability probability of mixing each sample
+ * \note The batch_size x num_classes float targets are computed with the meta data of each batch, one-hot for a label per image and
+ * multi-hot for the labels of the boxes. With mixup or cutmix each sample is mixed with another sample of the batch, the targets
+ * in the meta data stage and the output images, which must be on the host, before the batch is given to the user.
+ */
+extern "C" void ROCAL_API_CALL rocalLabelEncoder(RocalContext p_context, unsigned num_classes, float on_value = 1.0, float off_value = 0.0,
+                                                 float mixup_alpha = 0.0, float cutmix_alpha = 0.0, float mix_probability = 1.0);
+
+/*!
+ * \brief  rocalGetEncodedLabels
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param targets_ptr set to the batch_size x num_classes targets of the output batch, without a copy
+ * \param mix_params_ptr set to the batch_size x 6 mix parameters of the output batch: the index of the sample mixed in, the weight
+ * of the sample itself and the normalized x0, y0, x1, y1 of the cutmix box which is empty for mixup. Can be nullptr
+ */
+extern "C" void ROCAL_API_CALL rocalGetEncodedLabels(RocalContext p_context, float **targets_ptr, float **mix_params_ptr);
+
+/*!
+ * \brief  rocalCopyEncodedLabels
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param targets user's buffer of at least batch_size x num_classes floats
+ * \param mix_params user's host buffer of at least batch_size x 6 floats, can be nullptr
+ * \param dest 0 if targets is on the host, 1 if it is on the device
+ */
+extern "C" void ROCAL_API_CALL rocalCopyEncodedLabels(RocalContext p_context, void *targets, float *mix_params, int dest);
+
+/*!
+ * \brief  rocalGetMetaDataFieldCount
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \return number of extra meta data fields of the output batch, such as the TF record features asked for, the numbers
+ * after the label of a text file or the image ids of COCO
+ */
+extern "C" unsigned ROCAL_API_CALL rocalGetMetaDataFieldCount(RocalContext rocal_context);
+
+/*!
+ * \brief  rocalGetMetaDataFieldInfo
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param field index of the field, less than rocalGetMetaDataFieldCount()
+ * \param info set to the name, type, width and number of values of the field in the output batch
+ */
+extern "C" void ROCAL_API_CALL rocalGetMetaDataFieldInfo(RocalContext rocal_context, unsigned field, RocalMetaDataFieldInfo *info);
+
+/*!
+ * \brief  rocalGetMetaDataField
+ * \ingroup group_rocal_meta_data
+ * \param rocal_context
+ * \param field index of the field, less than rocalGetMetaDataFieldCount()
+ * \param values user's buffer of at least value_count values of the field type, the samples one after the other
+ * \param counts user's buffer of batch_size ints set to the number of values of each sample, can be nullptr
+ */
+extern "C" void ROCAL_API_CALL rocalGetMetaDataField(RocalContext rocal_context, unsigned field, void *values, int *counts);
+
 #endif // MIVISIONX_ROCAL_API_META_DATA_H
@@ -88,6 +88,59 @@ struct TimingInfo
     long long unsigned decode_time;
     long long unsigned process_time;
     long long unsigned transfer_time;
+    long long unsigned decode_failure_count; //!< Number of samples which failed decoding and were quarantined
+    long long unsigned substitution_count; //!< Number of samples replaced by a substitute because of a decode failure
+    long long unsigned pipeline_time; //!< Time spent by the pipelined output routine on the batches, the stages below run concurrently within it
+    long long unsigned prepare_stage_time; //!< Loading, meta data lookup and node parameter update, stage occupancy is each stage time divided by pipeline_time
+    long long unsigned meta_data_stage_time; //!< Meta data augmentation and parameter renewal
+    long long unsigned graph_stage_time; //!< OpenVX graph execution
+    long long unsigned commit_stage_time; //!< Box encoding and pushing to the output queue
+};
+
+/*! \brief Latency statistics of a pipeline stage, all durations are in microseconds
+ * \ingroup group_rocal_types
+ */
+struct RocalLatencyStats
+{
+    long long unsigned count; //!< Number of times the stage ran
+    long long unsigned total;
+    long long unsigned p50;
+    long long unsigned p95;
+    long long unsigned p99;
+    long long unsigned max;
+};
+
+/*! \brief Pipeline statistics struct, accumulated since the statistics were enabled and not reset when read
+ * \ingroup group_rocal_types
+ */
+struct RocalPipelineStats
+{
+    RocalLatencyStats read; //!< Reading the compressed samples of a batch, recorded by every internal shard
+    RocalLatencyStats decode; //!< Decoding a batch, recorded by every internal shard
+    RocalLatencyStats output_wait; //!< Time rocalRun() waited for a processed batch (ring buffer empty)
+    RocalLatencyStats consumer_wait; //!< Time the pipeline waited for the user to consume a batch (ring buffer full)
+    RocalLatencyStats process; //!< Processing a batch, from loading it to the output queue
+    RocalLatencyStats graph; //!< OpenVX graph execution
+    RocalLatencyStats meta_data; //!< Meta data augmentation
+    RocalLatencyStats box_encode;
+    RocalLatencyStats copy_out; //!< Copying the output to the user buffers
+    long long unsigned bytes_read; //!< Compressed bytes read by all the shards
+    long long unsigned ring_buffer_level; //!< Processed batches waiting to be consumed
+    long long unsigned ring_buffer_depth;
+    double ring_buffer_mean_level; //!< Level of the ring buffer averaged over the rocalRun() calls
+    long long unsigned circular_buffer_level; //!< Loaded batches waiting to be processed, summed over the internal shards
+    long long unsigned circular_buffer_depth;
+    double circular_buffer_mean_level; //!< Level of the circular buffers averaged over the loaded batches
+};
+
+/*! \brief Configuration chosen by the prefetch tuner
+ * \ingroup group_rocal_types
+ */
+struct RocalAutoTuneConfig
+{
+    size_t prefetch_queue_depth; //!< Batches prefetched ahead of the user, can be passed to rocalCreate() in later runs
+    size_t cpu_thread_count; //!< Threads decoding a batch of each internal shard, can be passed to rocalCreate() in later runs
+    bool done; //!< False while the pipeline is still being tuned
 };
 
 /*! \brief rocAL Joints Data struct - HRNet training expects meta data (joints_data) in below format, so added here as a type for exposing to user
@@ -237,6 +290,19 @@ enum RocalTensorOutputType
     ROCAL_U8 = 2,
 };
 
+/*! \brief rocAL CPU Placement enum
+ * \ingroup group_rocal_types
+ */
+enum RocalCpuPlacement
+{
+    /*! \brief The loader, decode and processing threads and the loader buffers are placed by the OS
+     */
+    ROCAL_CPU_PLACEMENT_NONE = 0,
+    /*! \brief Every internal shard's loader and decode threads and buffers are placed on a NUMA node, shards are spread round robin over the nodes and the processing threads run on the nodes of the shards
+     */
+    ROCAL_CPU_PLACEMENT_NUMA = 1,
+};
+
 /*! \brief rocAL Decoder Type enum
  * \ingroup group_rocal_types
  */
@@ -332,4 +398,34 @@ enum RocalResizeInterpolationType
     ROCAL_TRIANGULAR_INTERPOLATION = 5
 };
 
+/*! \brief rocAL Meta Data Field Type enum
+ * \ingroup group_rocal_types
+ */
+enum RocalMetaDataFieldType
+{
+    /*! \brief AMD ROCAL_FIELD_INT32
+     */
+    ROCAL_FIELD_INT32 = 0,
+    /*! \brief AMD ROCAL_FIELD_INT64
+     */
+    ROCAL_FIELD_INT64 = 1,
+    /*! \brief AMD ROCAL_FIELD_FLOAT32
+     */
+    ROCAL_FIELD_FLOAT32 = 2,
+    /*! \brief AMD ROCAL_FIELD_UINT8
+     */
+    ROCAL_FIELD_UINT8 = 3
+};
+
+/*! \brief rocAL Meta Data Field Info struct
+ * \ingroup group_rocal_types
+ */
+struct RocalMetaDataFieldInfo
+{
+    const char *name;             //!< name of the field, valid until the next rocalRun()
+    RocalMetaDataFieldType type;  //!< type of its values
+    unsigned width;               //!< number of values of every sample, 0 when the samples have a variable number of values
+    size_t value_count;           //!< number of values of the whole batch
+};
+
 #endif // MIVISIONX_ROCAL_API_TYPES_H
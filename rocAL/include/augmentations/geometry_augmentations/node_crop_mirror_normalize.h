@@ -32,10 +32,10 @@ public:
                             const std::vector<Image *> &outputs);
     CropMirrorNormalizeNode() = delete;
     void init(int crop_h, int crop_w, float start_x, float start_y, float mean, float std_dev, IntParam *mirror);
-    vx_array return_mirror(){ return _mirror.default_array();  }
+    const std::vector<int>& return_mirror(){ return _mirror.host_array();  }
     std::shared_ptr<RocalCropParam> return_crop_param() { return _crop_param; }
-    vx_array get_src_width() { return _src_roi_width; }
-    vx_array get_src_height() { return _src_roi_height; }
+    const std::vector<uint32_t>& get_src_width() { return _src_roi_width_val; }
+    const std::vector<uint32_t>& get_src_height() { return _src_roi_height_val; }
 protected:
     void create_node() override ;
     void update_node() override;
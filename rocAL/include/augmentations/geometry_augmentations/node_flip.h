@@ -34,9 +34,9 @@ public:
     void init(IntParam *flip_axis);
     unsigned int get_dst_width() { return _outputs[0]->info().width(); }
     unsigned int get_dst_height() { return _outputs[0]->info().height_single(); }
-    vx_array get_src_width() { return _src_roi_width; }
-    vx_array get_src_height() { return _src_roi_height; }
-    vx_array get_flip_axis() { return _flip_axis.default_array(); }
+    const std::vector<uint32_t>& get_src_width() { return _src_roi_width_val; }
+    const std::vector<uint32_t>& get_src_height() { return _src_roi_height_val; }
+    const std::vector<int>& get_flip_axis() { return _flip_axis.host_array(); }
 protected:
     void create_node() override;
     void update_node() override;
@@ -38,7 +38,7 @@ public:
     unsigned int get_dst_width() { return _outputs[0]->info().width(); }
     unsigned int get_dst_height() { return _outputs[0]->info().height_single(); }
     std::shared_ptr<RocalCropParam> get_crop_param() { return _crop_param; }
-    vx_array get_mirror() { return _mirror.default_array(); }
+    const std::vector<int>& get_mirror() { return _mirror.host_array(); }
 protected:
     void create_node() override;
     void update_node() override;
@@ -35,9 +35,9 @@ public:
     void init(FloatParam *angle);
     unsigned int get_dst_width() { return _outputs[0]->info().width(); }
     unsigned int get_dst_height() { return _outputs[0]->info().height_single(); }
-    vx_array get_src_width() { return _src_roi_width; }
-    vx_array get_src_height() { return _src_roi_height; }
-    vx_array get_angle() { return _angle.default_array(); }
+    const std::vector<uint32_t>& get_src_width() { return _src_roi_width_val; }
+    const std::vector<uint32_t>& get_src_height() { return _src_roi_height_val; }
+    const std::vector<float>& get_angle() { return _angle.host_array(); }
 
 protected:
     void create_node() override;
@@ -23,42 +23,9 @@ THE SOFTWARE.
 #include "node.h"
 #include "parameter_factory.h"
 #include "parameter_crop_factory.h"
+#include "ssd_crop_sampler.h"
 
 
-// todo:: move this to common header
-template<typename T = std::mt19937, std::size_t state_size = T::state_size>
-class SeededRNG {
-  /*
-  * @param batch_size How many RNGs to store
-  * @param state_size How many seed are used to initialize one RNG. Used to lower probablity of
-  * collisions between seeds used to initialize RNGs in different operators.
-  */
-public:
-  SeededRNG (int batch_size = 128) {
-      std::random_device source;
-      _batch_size = batch_size;
-      std::size_t _random_data_size = state_size * batch_size ;
-      std::vector<std::random_device::result_type> random_data(_random_data_size);
-      std::generate(random_data.begin(), random_data.end(), std::ref(source));
-      _rngs.reserve(batch_size);
-      for (int i=0; i < (int)(_batch_size*state_size); i += state_size) {
-        std::seed_seq seeds(std::begin(random_data) + i, std::begin(random_data)+ i +state_size);
-        _rngs.emplace_back(T(seeds));
-      }
-  }
-
-  /**
-   * Returns engine corresponding to given sample ID
-   */
-   T &operator[](int sample) noexcept {
-    return _rngs[sample % _batch_size];
-  }
-
-private:
-    std::vector<T> _rngs;
-    int _batch_size;
-};
-
 class SSDRandomCropNode : public Node
 {
 public:
@@ -69,8 +36,18 @@ public:
     unsigned int get_dst_height() { return _outputs[0]->info().height_single(); }
     std::shared_ptr<RocalRandomCropParam> get_crop_param() { return _crop_param; }
     float get_threshold(){return _threshold;}
-    std::vector<std::pair<float,float>> get_iou_range(){return _iou_range;}
+    const std::vector<std::pair<float,float>>& get_iou_range(){return _iou_range;}
+    // Crop of the current batch in pixels
+    const std::vector<uint>& get_x1_val() { return _x1_val; }
+    const std::vector<uint>& get_y1_val() { return _y1_val; }
+    const std::vector<uint>& get_crop_width_val() { return _crop_width_val; }
+    const std::vector<uint>& get_crop_height_val() { return _crop_height_val; }
     bool is_entire_iou(){return _entire_iou;}
+    // Normalized crop windows of the current batch with the IoU range each was drawn for
+    const std::vector<BoxCropWindow>& get_windows() { return _windows; }
+    // Boxes of the current batch cropped to the windows, valid while the meta data batch still holds the boxes in_boxes points to
+    BoundingBoxBatchData& cropped_boxes() { return _cropped_bb; }
+    bool crops_boxes_of(const BoundingBoxBatchData &in_boxes) { return _sampled_boxes == in_boxes.cords.data() && _cropped_bb.sample_count() == in_boxes.sample_count(); }
     void set_meta_data_batch() {}
 
 protected:
@@ -90,6 +67,11 @@ private:
     int _num_of_attempts = 20;
     bool _entire_iou = false;
     std::shared_ptr<RocalRandomCropParam> _crop_param;
-    SeededRNG<std::mt19937, 4> _rngs;     // setting the state_size to 4 for 4 random parameters.
+    SSDCropSampler _sampler;
+    std::vector<SampleRandStream> _streams;
+    std::vector<BoxCropWindow> _windows;
+    BoundingBoxBatchData _cropped_bb;
+    const BoundingBoxCord *_sampled_boxes = nullptr;
+    uint32_t _batch_count = 0;
 
 };
\ No newline at end of file
@@ -30,10 +30,13 @@ class FFmpegVideoDecoder : public VideoDecoder
 public:
     //! Default constructor
     FFmpegVideoDecoder();
+    //! \param decoder_threads Number of frame/slice threads FFmpeg uses internally to decode the video
+    explicit FFmpegVideoDecoder(unsigned decoder_threads);
     VideoDecoder::Status Initialize(const char *src_filename) override;
     VideoDecoder::Status Decode(unsigned char *output_buffer, unsigned seek_frame_number, size_t sequence_length, size_t stride, int out_width, int out_height, int out_stride, AVPixelFormat out_format) override;
     int seek_frame(AVRational avg_frame_rate, AVRational time_base, unsigned frame_number) override;
     void release() override;
+    std::vector<unsigned> get_keyframes() override { return _keyframes; }
     ~FFmpegVideoDecoder() override;
 private:
     const char *_src_filename = NULL;
@@ -44,5 +47,16 @@ private:
     int _video_stream_idx = -1;
     AVPixelFormat _dec_pix_fmt;
     int _codec_width, _codec_height;
+    std::vector<unsigned> _keyframes;
+    unsigned _decoder_threads = 1;
+    SwsContext *_sws_ctx = NULL; //!< Kept across Decode() calls, only recreated if the output size or format changes
+    AVFrame *_dec_frame = NULL;
+    AVPacket *_pkt = NULL;
+    unsigned _next_frame_number = 0; //!< Frame number the decoder returns next if decoding continues without seeking
+    bool _position_valid = false;
+    //! Scans the packets of the video stream for keyframes, used when the container does not index them
+    std::vector<unsigned> scan_keyframes();
+    //! Returns true if seek_frame_number can be reached by decoding forward from the current position rather than seeking
+    bool can_continue_to(unsigned seek_frame_number);
 };
 #endif
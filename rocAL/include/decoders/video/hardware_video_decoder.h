@@ -34,6 +34,7 @@ public:
     VideoDecoder::Status Decode(unsigned char *output_buffer, unsigned seek_frame_number, size_t sequence_length, size_t stride, int out_width, int out_height, int out_stride, AVPixelFormat out_format) override;
     int seek_frame(AVRational avg_frame_rate, AVRational time_base, unsigned frame_number) override;
     void release() override;
+    std::vector<unsigned> get_keyframes() override { return _keyframes; }
     ~HardWareVideoDecoder() override;
 private:
     const char *_src_filename = NULL;
@@ -44,6 +45,7 @@ private:
     int _video_stream_idx = -1;
     AVPixelFormat _dec_pix_fmt;
     int _codec_width, _codec_height;
+    std::vector<unsigned> _keyframes;
     AVHWDeviceType *hwDeviceType;
     AVBufferRef *hw_device_ctx = NULL;
     int hw_decoder_init(AVCodecContext *ctx, const enum AVHWDeviceType type, AVBufferRef *hw_device_ctx);
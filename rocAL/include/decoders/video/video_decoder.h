@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include <cstddef>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #ifdef ROCAL_VIDEO
 extern "C"
 {
@@ -57,6 +58,10 @@ public:
     explicit VideoDecoderConfig(VideoDecoderType type) : _type(type) {}
     virtual VideoDecoderType type() { return _type; };
     VideoDecoderType _type = VideoDecoderType::FFMPEG_SOFTWARE_DECODE;
+    void set_decoder_threads(unsigned decoder_threads) { _decoder_threads = decoder_threads; }
+    unsigned get_decoder_threads() { return _decoder_threads; }
+private:
+    unsigned _decoder_threads = 1; //!< Number of frame/slice threads used internally by each FFmpeg decoder instance
 };
 
 #ifdef ROCAL_VIDEO
@@ -82,6 +87,34 @@ public:
     virtual VideoDecoder::Status Decode(unsigned char *output_buffer, unsigned seek_frame_number, size_t sequence_length, size_t stride, int out_width, int out_height, int out_stride, AVPixelFormat out_format) = 0;
     virtual int seek_frame(AVRational avg_frame_rate, AVRational time_base, unsigned frame_number) = 0;
     virtual void release() = 0;
+    //! Returns the frame numbers of the keyframes of the opened video in increasing order, empty if the container does not index them
+    virtual std::vector<unsigned> get_keyframes() = 0;
     virtual ~VideoDecoder() = default;
+protected:
+    //! Builds the keyframe list from the demuxer's index of the stream, the frame numbers use the same convention as seek_frame()
+    static std::vector<unsigned> find_keyframes(AVStream *video_stream)
+    {
+        std::vector<unsigned> keyframes;
+        if (!video_stream || !video_stream->avg_frame_rate.num)
+            return keyframes;
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)
+        int index_entries_count = avformat_index_get_entries_count(video_stream);
+#else
+        int index_entries_count = video_stream->nb_index_entries;
+#endif
+        for (int i = 0; i < index_entries_count; i++)
+        {
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)
+            const AVIndexEntry *entry = avformat_index_get_entry(video_stream, i);
+#else
+            const AVIndexEntry *entry = &video_stream->index_entries[i];
+#endif
+            if (!entry || !(entry->flags & AVINDEX_KEYFRAME) || entry->timestamp < 0)
+                continue;
+            keyframes.push_back(av_rescale_q(entry->timestamp, video_stream->time_base, av_inv_q(video_stream->avg_frame_rate)));
+        }
+        std::sort(keyframes.begin(), keyframes.end());
+        return keyframes;
+    }
 };
 #endif
@@ -0,0 +1,56 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <functional>
+#include "commons.h"
+
+/*! \class VideoKeyframeIndex Process wide cache of the keyframe numbers of the videos
+ *
+ * The index of a video is set from the key frames found when its properties are probed, otherwise it is built once by the first
+ * decoder opening it. It is shared by all the other decoder instances opening the same video. If a cache directory is set with rocalSetSampleInfoCacheDir(), the indices are also persisted there and reused by later runs
+ * as long as the video file is not modified.
+ */
+class VideoKeyframeIndex
+{
+public:
+    static VideoKeyframeIndex* instance();
+    //! Returns the keyframe numbers of the video in increasing order, build_index is only called if the index is not found in memory or on the disk
+    std::vector<unsigned> get(const std::string &video_path, const std::function<std::vector<unsigned>()> &build_index);
+    //! Sets the keyframe numbers of a video already known, such as the ones read from the container index when its properties are probed
+    void set(const std::string &video_path, const std::vector<unsigned> &keyframes);
+    //! Returns false if the index of the video is not in memory yet, it is never built or read from the disk
+    bool find(const std::string &video_path, std::vector<unsigned> &keyframes);
+private:
+    VideoKeyframeIndex() = default;
+    std::string cache_file_path(const std::string &video_path);
+    //! Returns the line identifying the exact version of the video the index is built for
+    std::string video_signature(const std::string &video_path);
+    bool load(const std::string &video_path, std::vector<unsigned> &keyframes);
+    void save(const std::string &video_path, const std::vector<unsigned> &keyframes);
+    std::map<std::string, std::vector<unsigned>> _indices;
+    std::mutex _lock;
+};
@@ -33,6 +33,7 @@ THE SOFTWARE.
 struct decoded_image_info
 {
     std::vector<std::string> _image_names;
+    std::vector<std::string> _sample_keys; //!< Keys telling the samples apart across the dataset, the random parameters of each sample are drawn from a stream keyed on them
     std::vector<uint32_t> _roi_width;
     std::vector<uint32_t> _roi_height;
     std::vector<uint32_t> _original_width;
@@ -65,6 +66,8 @@ public:
     unsigned char* get_read_buffer_host();// blocks the caller if the buffer is empty
     unsigned char*  get_write_buffer(); // blocks the caller if the buffer is full
     size_t level();// Returns the number of elements stored
+    void set_active_depth(size_t buffer_depth);// Changes the number of batches loaded ahead, up to the depth allocated by init()
+    size_t active_depth() { return _active_depth; }
     void reset();// sets the buffer level to 0
     void block_if_empty();// blocks the caller if the buffer is empty
     void block_if_full();// blocks the caller if the buffer is full
@@ -75,6 +78,7 @@ private:
     bool full();
     bool empty();
     size_t _buff_depth;
+    size_t _active_depth = 0;
     decoded_image_info _last_image_info;
     std::queue<decoded_image_info> _circ_image_info;//!< Stores the loaded images names, decoded_width and decoded_height(data is stored in the _circ_buff)
     crop_image_info _last_crop_image_info; // for Random BBox crop coordinates
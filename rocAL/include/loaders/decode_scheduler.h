@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <vector>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+#include "commons.h"
+
+/*! \class DecodeClient The share of the decode threads given to a pipeline
+ *
+ * All the loaders and internal shards of a pipeline submit their decode work through the same client. When pipelines
+ * compete for the threads, each gets a share of the decoded samples proportional to its weight.
+ */
+class DecodeClient
+{
+public:
+    explicit DecodeClient(unsigned weight) : _weight(std::max(weight, 1u)) {}
+    void set_weight(unsigned weight) { _weight = std::max(weight, 1u); }
+    unsigned weight() const { return _weight; }
+private:
+    friend class DecodeScheduler;
+    std::atomic<unsigned> _weight;
+    double _virtual_time = 0; //!< Samples dispatched so far divided by the weight, the client with the lowest one is served first
+};
+
+/*! \class DecodeScheduler Process wide pool of decode threads shared by all the loaders of all the pipelines
+ *
+ * The number of threads is a global budget instead of a per loader count, so adding pipelines or internal shards does
+ * not multiply the threads. The threads are started on the first submitted work and joined when the last client is released.
+ */
+class DecodeScheduler
+{
+public:
+    static DecodeScheduler* instance();
+    std::shared_ptr<DecodeClient> create_client(unsigned weight = 1);
+    //! Sets the number of decode threads of the process, defaults to the number of physical cores
+    void set_thread_budget(size_t thread_count);
+    size_t thread_budget();
+    //! Runs task(i) for every i in [0, count) on the decode threads, at most max_parallelism at once, and returns when all are done
+    /// \param node NUMA node the tasks should run on, -1 to run them on any CPU
+    void parallel_for(const std::shared_ptr<DecodeClient> &client, size_t count, size_t max_parallelism,
+                      const std::function<void(size_t)> &task, int node = -1);
+private:
+    struct Job
+    {
+        DecodeClient *client;
+        const std::function<void(size_t)> *task;
+        size_t count;
+        size_t max_parallelism;
+        int node;
+        size_t next = 0;
+        size_t running = 0;
+        size_t done = 0;
+        std::exception_ptr error = nullptr;
+    };
+    DecodeScheduler();
+    void worker_routine(size_t worker_idx, size_t generation);
+    //! Joins the decode threads once the last client is released
+    void release_client();
+    //! Returns the job of the client with the lowest virtual time that can take one more task, nullptr if there is none
+    Job *pick_job();
+    std::vector<std::thread> _workers;
+    std::list<Job *> _jobs;
+    std::mutex _lock;
+    std::condition_variable _work_cv, _done_cv;
+    size_t _thread_budget;
+    size_t _client_count = 0;
+    size_t _generation = 0; //!< Bumped when the threads are joined, the threads of an older generation exit
+    double _virtual_clock = 0; //!< Virtual time of the last dispatched task, clients coming back from idle start from it
+};
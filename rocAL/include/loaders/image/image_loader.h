@@ -52,6 +52,15 @@ public:
     crop_image_info get_crop_image_info() override;
     void set_prefetch_queue_depth(size_t prefetch_queue_depth)  override;
     void shut_down() override;
+    void set_cpu_placement(CpuPlacement placement) override { _cpu_placement = placement; }
+    std::vector<unsigned> get_shard_ids() override { return {_shard_id}; }
+    void set_decode_client(std::shared_ptr<DecodeClient> decode_client) override { _decode_client = decode_client; }
+    void enable_stats(bool enable) override;
+    LoaderStats stats() override;
+    void set_prefetch_memory_budget(size_t bytes) override { _prefetch_memory_budget = bytes; }
+    void set_active_prefetch_depth(size_t depth) override { _circ_buff.set_active_depth(depth); }
+    void set_decode_parallelism(size_t thread_count) override;
+    size_t decode_parallelism() override;
 private:
     bool is_out_of_data();
     void de_init();
@@ -84,5 +93,11 @@ private:
     size_t _remaining_image_count;//!< How many images are there yet to be loaded
     bool _decoder_keep_original = false;
     int _device_id;
+    CpuPlacement _cpu_placement = CpuPlacement::NONE;
+    unsigned _shard_id = 0;
+    std::shared_ptr<DecodeClient> _decode_client = nullptr;
+    std::atomic<bool> _stats_enabled{false};
+    size_t _prefetch_memory_budget = 0;
+    std::atomic<long long unsigned> _buffer_level_sum{0}, _buffer_level_samples{0}; //!< Level of the circular buffer sampled on every load_next() while the stats are enabled
 };
 
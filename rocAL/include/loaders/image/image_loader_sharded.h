@@ -45,6 +45,15 @@ public:
     Timing timing() override;
     void set_prefetch_queue_depth(size_t prefetch_queue_depth) override;
     void shut_down() override;
+    void set_cpu_placement(CpuPlacement placement) override { _cpu_placement = placement; }
+    std::vector<unsigned> get_shard_ids() override;
+    void set_decode_client(std::shared_ptr<DecodeClient> decode_client) override { _decode_client = decode_client; }
+    void enable_stats(bool enable) override;
+    LoaderStats stats() override;
+    void set_prefetch_memory_budget(size_t bytes) override { _prefetch_memory_budget = bytes; }
+    void set_active_prefetch_depth(size_t depth) override;
+    void set_decode_parallelism(size_t thread_count) override;
+    size_t decode_parallelism() override;
 private:
     void increment_loader_idx();
     void *_dev_resources;
@@ -54,6 +63,10 @@ private:
     size_t _shard_count = 1;
     void fast_forward_through_empty_loaders();
     size_t _prefetch_queue_depth;
+    CpuPlacement _cpu_placement = CpuPlacement::NONE;
+    std::shared_ptr<DecodeClient> _decode_client = nullptr;
+    bool _stats_enabled = false;
+    size_t _prefetch_memory_budget = 0;
 
     Image *_output_image;
     std::shared_ptr<RandomBBoxCrop_MetaDataReader> _randombboxcrop_meta_data_reader = nullptr;
@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "timing_debug.h"
 #include "loader_module.h"
 #include "parameter_random_crop_decoder.h"
+#include "sample_info_cache.h"
+#include "decode_scheduler.h"
 
 /**
  * Compute the scaled value of <tt>dimension</tt> using the given scaling
@@ -52,6 +54,13 @@ public:
     void set_random_bbox_data_reader(std::shared_ptr<RandomBBoxCrop_MetaDataReader> randombboxcrop_meta_data_reader);
     std::vector<std::vector <float>> get_batch_random_bbox_crop_coords();
     void set_batch_random_bbox_crop_coords(std::vector<std::vector <float>> batch_crop_coords);
+    //! Returns the keys of the samples of the last batch loaded, unique across the dataset unlike their names
+    const std::vector<std::string>& sample_keys() { return _sample_keys; }
+    //! Sets the share of the process wide decode threads the samples are decoded with, and the NUMA node they run on (-1 for any)
+    void set_decode_client(std::shared_ptr<DecodeClient> decode_client, int node = -1);
+    //! Changes the number of threads decoding a batch, from the next batch on
+    void set_decode_parallelism(size_t thread_count) { _decode_parallelism = std::max<size_t>(thread_count, 1); }
+    size_t decode_parallelism() { return _decode_parallelism; }
 
     //! Loads a decompressed batch of images into the buffer indicated by buff
     /// \param buff User's buffer provided to be filled with decoded image samples
@@ -75,22 +84,50 @@ public:
 
     //! returns timing info or other status information
     Timing timing();
+    void enable_stats(bool enable);
+    //! Returns the read and decode latencies and the bytes read, without resetting them
+    LoaderStats stats();
 
 private:
+    //! Reads the next sample which is not quarantined from the reader into the idx slot of the batch, returns false if the reader is out of samples
+    bool read_sample(size_t idx);
+    //! Replaces the sample in the idx slot with the next sample of the reader whose header can be decoded, returns false if the reader is out of samples
+    bool substitute_from_reader(size_t idx);
+    //! Copies the compressed sample in the src slot of the batch to the dst slot, used when the reader can't provide a substitute
+    void copy_sample(size_t dst, size_t src);
+    //! Returns the slot of a sample in the batch that did not fail decoding, starting the search after idx
+    size_t find_valid_sample(size_t idx);
+    //! Records the sample in the idx slot in the quarantine (the decode failed flag of the sample info table), so it is skipped for the rest of the run
+    void quarantine(size_t idx);
+    void record_sample_info(size_t idx, int width, int height, int subsampling);
+    bool decode_sample(size_t idx, size_t max_decoded_width, size_t max_decoded_height, Decoder::ColorFormat decoder_color_format, bool keep_original);
     std::vector<std::shared_ptr<Decoder>> _decoder;
     std::shared_ptr<Reader> _reader;
     std::vector<std::vector<unsigned char>> _compressed_buff;
     std::vector<size_t> _actual_read_size;
     std::vector<std::string> _image_names;
+    std::vector<std::string> _sample_keys;
     std::vector<size_t> _compressed_image_size;
     std::vector<unsigned char*> _decompressed_buff_ptrs;
     std::vector<size_t> _actual_decoded_width;
     std::vector<size_t> _actual_decoded_height;
     std::vector<size_t> _original_width;
     std::vector<size_t> _original_height;
+    std::vector<int> _subsampling;
+    std::vector<unsigned char> _sample_info_found; //!< Set for the samples of the batch whose info is found in the _sample_info_table before decoding
+    std::vector<CropWindow> _crop_windows; //!< Crop windows generated ahead of decoding for samples with known dimensions
+    std::vector<unsigned char> _crop_window_ready;
+    std::vector<unsigned char> _sample_failed; //!< Set for the samples of the batch that failed header or content decode
+    size_t _decode_failure_count = 0; //!< Number of samples quarantined so far
+    size_t _substitution_count = 0; //!< Number of batch slots filled with a substitute sample so far
+    std::atomic<long long unsigned> _bytes_read{0};
+    std::shared_ptr<SampleInfoTable> _sample_info_table = nullptr;
     static const size_t MAX_COMPRESSED_SIZE = 1*1024*1024; // 1 Meg
     TimingDBG _file_load_time, _decode_time;
     size_t _batch_size, _shard_count, _num_threads;
+    std::shared_ptr<DecodeClient> _decode_client = nullptr;
+    int _decode_node = -1;
+    std::atomic<size_t> _decode_parallelism{1}; //!< Starts at the cpu_num_threads of the reader config
     DecoderConfig _decoder_config;
     bool decoder_keep_original;
     std::vector<std::vector <float>> _bbox_coords, _crop_coords_batch;
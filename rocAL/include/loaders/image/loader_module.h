@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "circular_buffer.h"
 #include "meta_data_reader.h"
 #include "meta_data_graph.h"
+#include "decode_scheduler.h"
+#include "timing_debug.h"
 
 enum class LoaderModuleStatus
 {
@@ -60,6 +62,15 @@ public:
     // introduce meta data reader
     virtual void set_random_bbox_data_reader(std::shared_ptr<RandomBBoxCrop_MetaDataReader> randombboxcrop_meta_data_reader) = 0;
     virtual void shut_down() = 0;
+    virtual void set_cpu_placement(CpuPlacement placement) {} // Placement of the loader threads and buffers, ignored by loaders not supporting it
+    virtual std::vector<unsigned> get_shard_ids() { return {}; } // Shards loaded by this module, used to place the processing threads next to them
+    virtual void set_decode_client(std::shared_ptr<DecodeClient> decode_client) {} // Share of the process wide decode threads used by this module, ignored by loaders not decoding on them
+    virtual void enable_stats(bool enable) {} // Starts recording the latency histograms returned by stats()
+    virtual LoaderStats stats() { return {}; } // Returns the statistics recorded so far without resetting them, loaders not supporting it return empty statistics
+    virtual void set_prefetch_memory_budget(size_t bytes) {} // The circular buffers are allocated with as many batches as fit in the budget, so the prefetch depth can be raised later
+    virtual void set_active_prefetch_depth(size_t depth) {} // Number of batches loaded ahead, up to the depth allocated
+    virtual void set_decode_parallelism(size_t thread_count) {} // Number of threads decoding a batch of each shard
+    virtual size_t decode_parallelism() { return 0; } // 0 if the loader does not support changing it
 };
 
 using pLoaderModule = std::shared_ptr<LoaderModule>;
\ No newline at end of file
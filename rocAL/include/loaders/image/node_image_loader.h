@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include "node.h"
 #include "image_loader_sharded.h"
 #include "graph.h"
+#include "parameter_factory.h"
 
 class ImageLoaderNode : public Node
 {
@@ -44,9 +45,12 @@ public:
               size_t load_batch_count, RocalMemType mem_type, std::shared_ptr<MetaDataReader> meta_data_reader, bool decoder_keep_orig = false, const char *prefix = "", unsigned sequence_length = 0, unsigned step = 0, unsigned stride = 0);
 
     std::shared_ptr<LoaderModule> get_loader_module();
+    /// Crop windows are known before decode when RandomBBoxCrop is used, init() then switches the TurboJPEG decoder to crop-window partial decode
+    void set_random_bbox_data_reader(std::shared_ptr<RandomBBoxCrop_MetaDataReader> randombboxcrop_meta_data_reader) { _randombboxcrop_meta_data_reader = randombboxcrop_meta_data_reader; }
 protected:
     void create_node() override{};
     void update_node() override{};
 private:
     std::shared_ptr<ImageLoaderSharded> _loader_module = nullptr;
+    std::shared_ptr<RandomBBoxCrop_MetaDataReader> _randombboxcrop_meta_data_reader = nullptr;
 };
\ No newline at end of file
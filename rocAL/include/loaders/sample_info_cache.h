@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#pragma once
+#include <string>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include "commons.h"
+
+//! Information about a compressed sample that can be found without decoding its pixels
+struct SampleInfo
+{
+    int width = 0;
+    int height = 0;
+    int subsampling = 0;
+    bool decode_failed = false; //!< Set if the header or content of the sample could not be decoded, only kept for the current run
+};
+
+/*! \class SampleInfoTable Keeps the SampleInfo of every sample of a single dataset
+ *
+ * The table is filled lazily the first time a sample is touched, after that later epochs can skip parsing the header
+ * and known corrupted samples can be skipped before their bytes are read. Lookups and inserts are thread safe. Only the dimensions
+ * are persisted, a failure may be transient (a file being written, a network mount hiccup) and is retried by the next run.
+ */
+class SampleInfoTable
+{
+public:
+    explicit SampleInfoTable(const std::string &cache_file);
+    bool find(const std::string &sample_id, SampleInfo &info);
+    void insert(const std::string &sample_id, const SampleInfo &info);
+    void mark_decode_failed(const std::string &sample_id);
+    bool is_decode_failed(const std::string &sample_id);
+    size_t size();
+    //! Loads the previously persisted table, if a cache file is set and exists
+    void load();
+    //! Persists the table into the cache file if any new sample info is added since last save, no op if no cache file is set
+    void save();
+private:
+    std::unordered_map<std::string, SampleInfo> _table;
+    std::shared_mutex _lock;
+    std::mutex _file_lock;
+    std::string _cache_file;
+    bool _dirty = false;
+};
+
+/*! \class SampleInfoCache Process wide registry of the SampleInfoTable(s), one table per dataset
+ *
+ * All the internal shards and pipelines reading the same dataset share the same table.
+ */
+class SampleInfoCache
+{
+public:
+    static SampleInfoCache* instance();
+    //! Returns the table of the dataset located at the dataset_path, creates it if it does not exist
+    std::shared_ptr<SampleInfoTable> get_table(const std::string &dataset_path);
+    //! Sets the directory used to persist the tables, tables created after this call are loaded from and saved to this directory
+    void set_cache_dir(const std::string &cache_dir);
+    std::string get_cache_dir();
+    void save_all();
+private:
+    SampleInfoCache() = default;
+    std::string cache_file_path(const std::string &dataset_path);
+    std::unordered_map<std::string, std::shared_ptr<SampleInfoTable>> _tables;
+    std::string _cache_dir;
+    static std::mutex _mutex;
+};
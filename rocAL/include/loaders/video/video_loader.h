@@ -54,6 +54,10 @@ public:
     std::vector<size_t> get_sequence_start_frame_number() override;
     std::vector<std::vector<float>> get_sequence_frame_timestamps() override;
     void shut_down() override;
+    void set_cpu_placement(CpuPlacement placement) override { _cpu_placement = placement; }
+    std::vector<unsigned> get_shard_ids() override { return {_shard_id}; }
+    void enable_stats(bool enable) override;
+    LoaderStats stats() override;
 
 private:
     bool is_out_of_data();
@@ -84,5 +88,9 @@ private:
     bool _decoder_keep_original = false;
     std::vector<std::vector<size_t>> _sequence_start_framenum_vec;
     std::vector<std::vector<std::vector<float>>> _sequence_frame_timestamps_vec;
+    CpuPlacement _cpu_placement = CpuPlacement::NONE;
+    unsigned _shard_id = 0;
+    std::atomic<bool> _stats_enabled{false};
+    std::atomic<long long unsigned> _buffer_level_sum{0}, _buffer_level_samples{0}; //!< Level of the circular buffer sampled on every load_next() while the stats are enabled
 };
 #endif
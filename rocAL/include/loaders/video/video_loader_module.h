@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "circular_buffer.h"
 #include "meta_data_reader.h"
 #include "meta_data_graph.h"
+#include "timing_debug.h"
 
 #ifdef ROCAL_VIDEO
 enum class VideoLoaderModuleStatus
@@ -60,6 +61,10 @@ public:
     virtual std::vector<size_t> get_sequence_start_frame_number() = 0;
     virtual std::vector<std::vector<float>> get_sequence_frame_timestamps() = 0;
     virtual void shut_down() = 0;
+    virtual void set_cpu_placement(CpuPlacement placement) {} // Placement of the loader threads and buffers, ignored by loaders not supporting it
+    virtual std::vector<unsigned> get_shard_ids() { return {}; } // Shards loaded by this module, used to place the processing threads next to them
+    virtual void enable_stats(bool enable) {} // Starts recording the latency histograms returned by stats()
+    virtual LoaderStats stats() { return {}; } // Returns the statistics recorded so far without resetting them
 };
 
 using pVideoLoaderModule = std::shared_ptr<VideoLoaderModule>;
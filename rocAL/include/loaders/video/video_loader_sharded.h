@@ -46,6 +46,10 @@ public:
     std::vector<size_t> get_sequence_start_frame_number() override;
     std::vector<std::vector<float>> get_sequence_frame_timestamps() override;
     Timing timing() override;
+    void set_cpu_placement(CpuPlacement placement) override { _cpu_placement = placement; }
+    std::vector<unsigned> get_shard_ids() override;
+    void enable_stats(bool enable) override;
+    LoaderStats stats() override;
 private:
     void increment_loader_idx();
     void *_dev_resources;
@@ -55,6 +59,8 @@ private:
     size_t _shard_count = 1;
     void fast_forward_through_empty_loaders();
     size_t _prefetch_queue_depth; // Used for circular buffer's internal buffer
+    CpuPlacement _cpu_placement = CpuPlacement::NONE;
+    bool _stats_enabled = false;
     Image *_output_image;
 };
 #endif
@@ -28,6 +28,9 @@ THE SOFTWARE.
 #include <cstring>
 #include <map>
 #include <tuple>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "commons.h"
 #include "ffmpeg_video_decoder.h"
 #include "video_reader_factory.h"
@@ -50,12 +53,7 @@ public:
     size_t count();
     void reset();
     void create(VideoReaderConfig reader_config, VideoDecoderConfig decoder_config, int batch_size);
-    void set_video_process_count(size_t video_count)
-    {
-        _video_process_count = (video_count <= _max_video_count) ? video_count : _max_video_count;
-    }
     float convert_framenum_to_timestamp(size_t frame_number);
-    void decode_sequence(size_t sequence_index);
 
     //! Loads a decompressed batch of sequence of frames into the buffer indicated by buff
     /// \param buff User's buffer provided to be filled with decoded sequence samples
@@ -82,25 +80,42 @@ public:
 
     //! returns timing info or other status information
     Timing timing();
+    void enable_stats(bool enable);
+    //! Returns the read and decode latencies, without resetting them
+    LoaderStats stats();
 private:
-    struct video_map
+    //! A decoder instance of the persistent pool, it keeps its video open across batches and decodes the sequences assigned to it in order
+    struct DecodeSlot
     {
-        int _video_map_idx;
-        bool _is_decoder_instance;
+        std::shared_ptr<VideoDecoder> decoder;
+        std::string video_path; //!< Video currently opened by the decoder, empty if none
+        std::vector<size_t> sequences; //!< Sequences of the current batch assigned to this slot
+        bool failed = false; //!< Set when a sequence of the current batch could not be opened or decoded
     };
-    std::vector<std::shared_ptr<VideoDecoder>> _video_decoder;
+    //! Groups the sequences of the batch by video and keyframe interval and distributes the groups over the decode slots
+    void schedule_sequences();
+    //! Returns the keyframe interval index of the frame_number in the video, sequences sharing it are decoded by the same slot
+    size_t keyframe_interval(const std::string &video_path, size_t frame_number);
+    void decode_slot(size_t slot_idx);
+    void decode_worker(size_t slot_idx);
+    void start_decode_workers();
+    void stop_decode_workers();
+    std::vector<DecodeSlot> _decode_slots;
+    std::vector<std::thread> _decode_workers;
+    std::mutex _workers_lock;
+    std::condition_variable _workers_start_cv, _workers_done_cv;
+    size_t _batch_generation = 0; //!< Incremented for every batch handed to the decode workers
+    size_t _busy_workers = 0;
+    bool _stop_workers = false;
     std::shared_ptr<VideoReader> _video_reader;
-    size_t _max_video_count = 50;
-    size_t _video_process_count;
+    size_t _max_decode_slots = 50;
     VideoProperties _video_prop;
     std::vector<std::string> _video_names;
-    std::map<std::string, video_map> _video_file_name_map;
     std::vector<unsigned char *> _decompressed_buff_ptrs;
     std::vector<size_t> _actual_decoded_width;
     std::vector<size_t> _actual_decoded_height;
     std::vector<size_t> _sequence_start_frame_num;
     std::vector<std::string> _sequence_video_path;
-    std::vector<int> _sequence_video_idx;
     TimingDBG _file_load_time, _decode_time;
     size_t _batch_size;
     size_t _sequence_count;
@@ -0,0 +1,50 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <vector>
+#include "meta_data.h"
+
+/// Encodes the boxes of a batch against the SSD anchors on the host, the anchors are kept as separate
+/// l, t, r, b arrays so the IoUs of a box with all of them are computed 8 at a time
+class BoxEncoderCpu
+{
+public:
+    BoxEncoderCpu(size_t batch_size, const std::vector<float> &anchors, float criteria, const std::vector<float> &means, const std::vector<float> &stds, bool offset, float scale);
+    /// Writes anchor count boxes (xcycwh) and labels per sample straight into encoded_boxes and encoded_labels, the meta data is left as is
+    void Run(pMetaDataBatch full_batch_meta_data, float *encoded_boxes, int *encoded_labels);
+private:
+    /// Merges the IoUs of the box with every anchor into the best box found so far for each anchor, the anchor overlapping it most is always matched to it
+    void match_box(const BoundingBoxCord &box, int box_idx, float *best_ious, int *best_idx) const;
+    void encode_sample(const BoundingBoxCord *boxes, const int *labels, size_t box_count, float *best_ious, int *best_idx, float *encoded_boxes, int *encoded_labels) const;
+    size_t _batch_size;
+    size_t _anchor_count;
+    std::vector<float> _anchors_l, _anchors_t, _anchors_r, _anchors_b, _anchors_area;
+    std::vector<BoundingBoxCord_xcycwh> _anchors_xcycwh;
+    float _criteria;
+    float _means[4];
+    float _inv_stds[4];
+    bool _offset;
+    float _scale;
+    std::vector<float> _best_ious;//!< Best IoU of each anchor, one row of anchor count per sample allocated once
+    std::vector<int> _best_idx;//!< Box giving the best IoU of each anchor
+};
@@ -0,0 +1,62 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include "meta_data.h"
+
+/// Crop window of one sample for crop_boxes(), in the units of the boxes
+struct BoxCropWindow
+{
+    BoundingBoxCord window;
+    float min_overlap;  //!< A box is kept when its overlap with the window is in [min_overlap, max_overlap]
+    float max_overlap = std::numeric_limits<float>::infinity();
+    bool mirror = false;    //!< Mirrors the kept boxes horizontally once they are relative to the window
+};
+
+struct BoxCropOptions
+{
+    bool overlap_is_iou = false;    //!< IoU of the box and the window, otherwise the part of the box inside the window
+    bool center_in_window = false;  //!< Also requires the center of the box to be inside the window
+    bool keep_one = true;           //!< A sample left without boxes gets the whole image with label 0
+};
+
+/// Box transforms applied by the meta nodes to all the boxes of a batch at once. The boxes are processed 8 at a time with AVX2,
+/// crops and rotations spread the samples over threads when the batch has enough boxes and write into a separate batch.
+/// When the batch has masks, their ids follow the kept boxes and the mask view of each sample is moved like its boxes.
+
+/// Flips the boxes of sample i horizontally when flip_axis[i] is 0 and vertically when it is 1, in place
+void flip_boxes(BoundingBoxBatchData &bb, const int *flip_axis);
+/// Keeps the boxes overlapping the window of their sample, clipped to it and made relative to it
+void crop_boxes(const BoundingBoxBatchData &in, BoundingBoxBatchData &out, const BoxCropWindow *windows, const BoxCropOptions &options);
+/// Same with the window of sample i returned by window_of(i) on the thread cropping it, the samples are always spread over threads
+void crop_boxes(const BoundingBoxBatchData &in, BoundingBoxBatchData &out, const std::function<BoxCropWindow(int)> &window_of, const BoxCropOptions &options);
+/// True when the overlap of every box with crop.window is in [crop.min_overlap, crop.max_overlap]
+bool all_boxes_overlap(const BoundingBoxCord *boxes, size_t count, const BoxCropWindow &crop, bool overlap_is_iou);
+/// True when the center of at least one box is inside the window, on its border only counts when strict is false
+bool any_box_center_in(const BoundingBoxCord *boxes, size_t count, const BoundingBoxCord &window, bool strict);
+/// Rotates the <x, y, w, h> boxes of sample i by angles[i] degrees around the image center, the enclosing <l, t, r, b> boxes
+/// covering the destination image by at least min_overlap are kept, clipped to it
+void rotate_boxes(const BoundingBoxBatchData &in, BoundingBoxBatchData &out, const float *angles, const uint32_t *src_width, const uint32_t *src_height,
+                  uint32_t dst_width, uint32_t dst_height, float min_overlap);
@@ -45,14 +45,17 @@ private:
     BoundingBoxBatch* _output;
     std::string _path;
     int meta_data_reader_type;
-    void add(std::string image_name, BoundingBoxCords bbox, BoundingBoxLabels b_labels, ImgSize image_size);
+    void add(std::string image_name, BoundingBoxCords bbox, BoundingBoxLabels b_labels, ImgSize image_size, int mask_id = -1);
     bool exists(const std::string &image_name) override;
     std::map<std::string, std::shared_ptr<MetaData>> _map_content;
     std::map<std::string, std::shared_ptr<MetaData>>::iterator _itr;
     std::map<std::string, ImgSize> _map_img_sizes;
+    std::map<std::string, int> _map_img_ids;
+    MetaDataFields _fields;  //!< "image_id" of the images, one row per image
     std::map<std::string, ImgSize> ::iterator itr;
     std::map<int, int> _label_info;
     std::map<int, int> ::iterator _it_label;
     TimingDBG _coco_metadata_read_time;
+    std::shared_ptr<MaskStore> _masks;  //!< Segmentations of the annotations, only read when masks are requested
 };
 
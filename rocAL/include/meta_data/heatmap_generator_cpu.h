@@ -0,0 +1,50 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <vector>
+#include "meta_data.h"
+
+/// Renders the Gaussian heatmap targets and target weights of the joints of a batch on the host, as top-down pose models
+/// such as HRNet are trained with. The joints are first moved to the pose output image by the affine transform of their
+/// person box (center, scale, rotation), then the Gaussian patch, computed once, is copied around each joint.
+class HeatmapGeneratorCpu
+{
+public:
+    HeatmapGeneratorCpu(size_t batch_size, unsigned image_width, unsigned image_height, unsigned heatmap_width, unsigned heatmap_height, float sigma);
+    /// Writes NUMBER_OF_JOINTS heatmaps of heatmap_height x heatmap_width and NUMBER_OF_JOINTS target weights per sample
+    void Run(pMetaDataBatch full_batch_meta_data, float *heatmaps, float *target_weights);
+    size_t heatmaps_size() const { return _batch_size * NUMBER_OF_JOINTS * _heatmap_height * _heatmap_width; }
+    size_t target_weights_size() const { return _batch_size * NUMBER_OF_JOINTS; }
+    unsigned heatmap_width() const { return _heatmap_width; }
+    unsigned heatmap_height() const { return _heatmap_height; }
+private:
+    /// Copies the patch around the joint at (x, y) of the pose output image, returns the target weight of the joint
+    float render_joint(float x, float y, float visibility, float *heatmap) const;
+    size_t _batch_size;
+    unsigned _image_width, _image_height;
+    unsigned _heatmap_width, _heatmap_height;
+    float _feat_stride_x, _feat_stride_y;
+    float _patch_radius;//!< 3 sigma
+    int _patch_size;
+    std::vector<float> _patch;//!< Gaussian of _patch_size x _patch_size centered on _patch_size / 2
+};
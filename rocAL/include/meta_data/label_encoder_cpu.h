@@ -0,0 +1,58 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <vector>
+#include <random>
+#include "meta_data.h"
+
+/// Encodes the labels of a batch into dense batch_size x num_classes targets on the host: one-hot for a label per image,
+/// multi-hot for the box labels of a detection batch, with label smoothing given by the on and off values. With mixup
+/// or cutmix each sample is mixed with another sample of the batch, the targets with the same weight as the images.
+class LabelEncoderCpu
+{
+public:
+    /// Per sample partner, weight of the sample, and normalized cutmix box x0, y0, x1, y1 which is empty for mixup
+    static const unsigned MIX_PARAM_COUNT = 6;
+    LabelEncoderCpu(size_t batch_size, unsigned num_classes, float on_value, float off_value, float mixup_alpha, float cutmix_alpha, float mix_probability, unsigned seed);
+    /// Writes the targets and draws the mix parameters of a batch, a partial batch gets zero targets for the missing samples
+    void Run(pMetaDataBatch full_batch_meta_data, float *targets, float *mix_params);
+    /// Mixes the images of each output buffer as given by mix_params, the samples are height x width x channels bytes,
+    /// planar or interleaved, and roi_width/roi_height give their used size when they are not empty
+    void mix_images(const float *mix_params, const std::vector<void *> &buffers, unsigned width, unsigned height, unsigned channels, bool planar,
+                    const std::vector<std::vector<uint32_t>> &roi_width, const std::vector<std::vector<uint32_t>> &roi_height);
+    bool is_mixing() const { return _mixup_alpha > 0 || _cutmix_alpha > 0; }
+    size_t targets_size() const { return _batch_size * _num_classes; }
+    size_t mix_params_size() const { return _batch_size * MIX_PARAM_COUNT; }
+    unsigned num_classes() const { return _num_classes; }
+private:
+    /// Index of the target of a label, labels 1 to num_classes go to 0 to num_classes - 1 and label 0 goes last, -1 if out of range
+    int class_of(int label) const;
+    float beta(float alpha);
+    size_t _batch_size;
+    unsigned _num_classes;
+    float _on_value, _off_value;
+    float _mixup_alpha, _cutmix_alpha, _mix_probability;
+    std::mt19937 _rng;
+    std::vector<float> _unmixed;//!< Targets of the batch before they are mixed
+    std::vector<unsigned char> _unmixed_images;//!< Copy of an output buffer the partners are read from
+};
@@ -0,0 +1,44 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "meta_data.h"
+
+/// Masks of a batch handed out by the meta data API. They are only decoded here, for the boxes of the batch, and moved to
+/// the output samples through the mask views the meta nodes updated.
+
+/// Polygons of the masks of a batch in the output samples, in the order of the boxes
+struct MaskPolygonBatch
+{
+    std::vector<int> polygon_counts;    //!< Per box
+    std::vector<int> vertex_counts;     //!< Per polygon
+    std::vector<float> points;          //!< x, y pairs normalized to the output sample
+};
+
+/// Moves the polygons of the masks of bb to the output samples, clipped to them. Run-length encoded masks have no polygons.
+void mask_polygons(const BoundingBoxBatchData &bb, MaskPolygonBatch &out);
+/// Draws the mask of every box of bb in a width x height image, 1 inside and 0 outside, the images of the boxes follow each other
+void rasterize_masks(const BoundingBoxBatchData &bb, unsigned width, unsigned height, uint8_t *out);
+/// Appends the counts of a compressed COCO run-length encoding string
+void decode_rle_string(const char *chars, size_t length, std::vector<uint32_t> &counts);
@@ -21,6 +21,10 @@ THE SOFTWARE.
 */
 
 #pragma once
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
@@ -39,7 +43,8 @@ typedef struct BoundingBoxCord_
   float l; float t; float r; float b;
   BoundingBoxCord_() {}
   BoundingBoxCord_(float l_, float t_, float r_, float b_): l(l_), t(t_), r(r_), b(b_) {}   // constructor
-  BoundingBoxCord_(const BoundingBoxCord_& cord) : l(cord.l), t(cord.t), r(cord.r), b(cord.b) {}  //copy constructor
+  BoundingBoxCord_(const BoundingBoxCord_& cord) = default;  //copy constructor
+  BoundingBoxCord_& operator=(const BoundingBoxCord_& cord) = default;
 } BoundingBoxCord;
 
 typedef  struct { float xc; float yc; float w; float h; } BoundingBoxCord_xcycwh;
@@ -81,6 +86,140 @@ typedef struct
     RotationBatch rotation_batch;
 }JointsDataBatch;
 
+enum class MetaDataFieldType : uint8_t
+{
+    INT32 = 0,
+    INT64,
+    FLOAT32,
+    UINT8
+};
+
+inline size_t meta_data_field_type_size(MetaDataFieldType type)
+{
+    switch (type)
+    {
+        case MetaDataFieldType::INT32: return sizeof(int32_t);
+        case MetaDataFieldType::INT64: return sizeof(int64_t);
+        case MetaDataFieldType::FLOAT32: return sizeof(float);
+        default: return sizeof(uint8_t);
+    }
+}
+
+/// One column of extra meta data, the values of sample i are [offsets[i], offsets[i + 1]). A fixed-size field has width
+/// values for every sample, a variable-length one has width 0.
+struct MetaDataField
+{
+    std::string name;
+    MetaDataFieldType type = MetaDataFieldType::FLOAT32;
+    size_t width = 0;
+    std::vector<uint8_t> data;
+    std::vector<size_t> offsets = {0};
+    size_t value_size() const { return meta_data_field_type_size(type); }
+    size_t sample_count() const { return offsets.size() - 1; }
+    size_t count(size_t sample) const { return offsets[sample + 1] - offsets[sample]; }
+    size_t value_count() const { return offsets.back(); }
+    const uint8_t *values_of(size_t sample) const { return data.data() + offsets[sample] * value_size(); }
+    void clear()
+    {
+        data.clear();
+        offsets.assign(1, 0);
+    }
+    /// Adds the count values of the next sample, a fixed-size field takes width values and zero fills the missing ones
+    void add(const void *values, size_t count)
+    {
+        size_t stored = width ? width : count;
+        size_t bytes = std::min(count, stored) * value_size();
+        size_t end = data.size();
+        data.resize(end + stored * value_size(), 0);
+        if (bytes)
+            memcpy(data.data() + end, values, bytes);
+        offsets.push_back(offsets.back() + stored);
+    }
+    void append(const MetaDataField &other)
+    {
+        size_t base = offsets.back();
+        data.insert(data.end(), other.data.begin(), other.data.end());
+        for (size_t i = 1; i < other.offsets.size(); i++)
+            offsets.push_back(base + other.offsets[i]);
+    }
+};
+
+/// Extra per-sample meta data of a batch in typed columns, filled by the readers from their own table of all the samples
+struct MetaDataFields
+{
+    std::vector<MetaDataField> columns;
+    bool empty() const { return columns.empty(); }
+    int find(const std::string &name) const
+    {
+        for (size_t c = 0; c < columns.size(); c++)
+            if (columns[c].name == name)
+                return c;
+        return -1;
+    }
+    /// Returns the column called name, created with the given type and width when it does not exist yet
+    MetaDataField &column(const std::string &name, MetaDataFieldType type, size_t width = 0)
+    {
+        int c = find(name);
+        if (c >= 0)
+            return columns[c];
+        columns.emplace_back();
+        columns.back().name = name;
+        columns.back().type = type;
+        columns.back().width = width;
+        return columns.back();
+    }
+    void clear()
+    {
+        for (auto &column : columns)
+            column.clear();
+    }
+    /// Makes it an empty batch with the columns of schema, the buffers are kept when the columns do not change
+    void reset(const MetaDataFields &schema)
+    {
+        columns.resize(schema.columns.size());
+        for (size_t c = 0; c < columns.size(); c++)
+        {
+            columns[c].name = schema.columns[c].name;
+            columns[c].type = schema.columns[c].type;
+            columns[c].width = schema.columns[c].width;
+            columns[c].clear();
+        }
+    }
+    /// Adds the row of table as the next sample, a sample without a row gets no values, or zeros in the fixed-size columns
+    void add_row(const MetaDataFields &table, int row)
+    {
+        for (size_t c = 0; c < columns.size(); c++)
+        {
+            const auto &source = table.columns[c];
+            if (row < 0)
+                columns[c].add(nullptr, 0);
+            else
+                columns[c].add(source.values_of(row), source.count(row));
+        }
+    }
+    /// Columns whose samples all have the same number of values become fixed-size, once a table is filled
+    void fix_widths()
+    {
+        for (auto &column : columns)
+        {
+            if (column.width || !column.sample_count() || !column.count(0))
+                continue;
+            bool same = true;
+            for (size_t i = 1; i < column.sample_count() && same; i++)
+                same = column.count(i) == column.count(0);
+            if (same)
+                column.width = column.count(0);
+        }
+    }
+    void append(const MetaDataFields &other)
+    {
+        if (columns.empty())
+            reset(other);
+        for (size_t c = 0; c < columns.size() && c < other.columns.size(); c++)
+            columns[c].append(other.columns[c]);
+    }
+};
+
 struct MetaData
 {
     int& get_label() { return _label_id; }
@@ -90,6 +229,9 @@ struct MetaData
     void set_bb_labels(BoundingBoxLabels bb_label_ids) {_bb_label_ids = std::move(bb_label_ids); }
     ImgSize& get_img_size() { return _img_size; }
     const JointsData& get_joints_data(){ return _joints_data; }
+    std::vector<int>& get_mask_ids() { return _mask_ids; }
+    int get_field_row() const { return _field_row; }
+    void set_field_row(int row) { _field_row = row; }
 protected:
     BoundingBoxCords _bb_cords = {}; // For bb use
     BoundingBoxCords_xcycwh _bb_cords_xcycwh = {}; // For bb use
@@ -97,6 +239,8 @@ protected:
     ImgSize _img_size = {};
     JointsData _joints_data = {};
     int _label_id = -1; // For label use only
+    std::vector<int> _mask_ids = {}; // For mask use, per box index in the reader's MaskStore
+    int _field_row = -1; // Row of the sample in the extra fields table of the reader
 };
 
 struct Label : public MetaData
@@ -147,8 +291,149 @@ struct KeyPoint : public MetaData
     void set_joints_data(JointsData *joints_data) { _joints_data = std::move(*joints_data); }
 };
 
+/// COCO segmentations of all the annotations of a dataset in flat arrays, read once and only decoded for the samples of a batch
+struct MaskStore
+{
+    enum class Kind : uint8_t
+    {
+        Polygons,   //!< Polygons with points normalized like the boxes
+        RleCounts,  //!< Uncompressed run-length encoding, column major runs alternating between 0 and 1
+        RleString   //!< Compressed run-length encoding string of the COCO API
+    };
+    struct Entry
+    {
+        Kind kind;
+        uint32_t first;     //!< First polygon, count or char of the mask in polygon_offsets, rle_counts or rle_chars
+        uint32_t count;     //!< Number of polygons, counts or chars
+        uint32_t width;     //!< Size of the image the run-length encoding is for
+        uint32_t height;
+    };
+    std::vector<Entry> entries;
+    std::vector<uint32_t> polygon_offsets = {0};    //!< The vertices of polygon p are the pairs [polygon_offsets[p], polygon_offsets[p + 1]) of points
+    std::vector<float> points;                      //!< x, y pairs
+    std::vector<uint32_t> rle_counts;
+    std::string rle_chars;
+};
+
+/// Affine map from the normalized coordinates of an output sample to the normalized coordinates of its source image,
+/// x = m[0] * u + m[1] * v + m[2] and y = m[3] * u + m[4] * v + m[5]. The meta nodes move it instead of the masks.
+struct MaskView
+{
+    float m[6] = {1, 0, 0, 0, 1, 0};
+    /// The output becomes the part of the current output inside window, mirrored horizontally inside it when mirror is set
+    void crop(const BoundingBoxCord &window, bool mirror)
+    {
+        float w = window.r - window.l, h = window.b - window.t;
+        then({mirror ? -w : w, 0, mirror ? window.r : window.l, 0, h, window.t});
+    }
+    void flip(bool horizontal)
+    {
+        if (horizontal)
+            then({-1, 0, 1, 0, 1, 0});
+        else
+            then({1, 0, 0, 0, -1, 1});
+    }
+    /// Composes with t mapping the new output to the current output
+    void then(const std::array<float, 6> &t)
+    {
+        float r[6] = {m[0] * t[0] + m[1] * t[3], m[0] * t[1] + m[1] * t[4], m[0] * t[2] + m[1] * t[5] + m[2],
+                      m[3] * t[0] + m[4] * t[3], m[3] * t[1] + m[4] * t[4], m[3] * t[2] + m[4] * t[5] + m[5]};
+        std::copy(r, r + 6, m);
+    }
+};
+
+/// Boxes and labels of all the samples of a batch in two flat arrays, the boxes of sample i are [offsets[i], offsets[i + 1])
+struct BoundingBoxBatchData
+{
+    BoundingBoxCords cords;
+    BoundingBoxLabels labels;
+    std::vector<size_t> offsets = {0};
+    // Only filled when the reader loads masks, the masks stay in the reader's store until they are emitted
+    std::shared_ptr<const MaskStore> masks;
+    std::vector<int> mask_ids = {};             //!< Per box index of its entry in masks, -1 for a box without a mask
+    std::vector<MaskView> mask_views = {};      //!< Per sample
+    bool has_masks() const { return masks != nullptr; }
+    size_t sample_count() const { return offsets.size() - 1; }
+    size_t count(size_t sample) const { return offsets[sample + 1] - offsets[sample]; }
+    BoundingBoxCord *cords_of(size_t sample) { return cords.data() + offsets[sample]; }
+    int *labels_of(size_t sample) { return labels.data() + offsets[sample]; }
+    const BoundingBoxCord *cords_of(size_t sample) const { return cords.data() + offsets[sample]; }
+    const int *labels_of(size_t sample) const { return labels.data() + offsets[sample]; }
+    /// Keeps the capacity so a batch refilled every iteration does not allocate again
+    void clear()
+    {
+        cords.clear();
+        labels.clear();
+        offsets.assign(1, 0);
+        mask_ids.clear();
+        mask_views.clear();
+    }
+    /// Makes it a batch of sample_count samples without boxes
+    void resize(size_t sample_count)
+    {
+        clear();
+        offsets.resize(sample_count + 1, 0);
+        if (has_masks())
+            mask_views.resize(sample_count);
+    }
+    /// Adds a box to the sample being built, end_sample() closes it
+    void add(const BoundingBoxCord &cord, int label, int mask_id = -1)
+    {
+        cords.push_back(cord);
+        labels.push_back(label);
+        if (has_masks())
+            mask_ids.push_back(mask_id);
+    }
+    /// Number of boxes added to the sample being built
+    size_t pending_count() const { return cords.size() - offsets.back(); }
+    void end_sample(const MaskView &view = MaskView())
+    {
+        offsets.push_back(cords.size());
+        if (has_masks())
+            mask_views.push_back(view);
+    }
+    void append_sample(const BoundingBoxCords &sample_cords, const BoundingBoxLabels &sample_labels, const int *sample_mask_ids = nullptr)
+    {
+        cords.insert(cords.end(), sample_cords.begin(), sample_cords.end());
+        labels.insert(labels.end(), sample_labels.begin(), sample_labels.end());
+        if (has_masks())
+        {
+            if (sample_mask_ids)
+                mask_ids.insert(mask_ids.end(), sample_mask_ids, sample_mask_ids + sample_cords.size());
+            else
+                mask_ids.resize(cords.size(), -1);
+        }
+        end_sample();
+    }
+    void append(const BoundingBoxBatchData &other)
+    {
+        size_t base = cords.size();
+        if (other.has_masks())
+        {
+            // Boxes of this batch added without masks get none
+            mask_ids.resize(base, -1);
+            mask_views.resize(sample_count());
+            masks = other.masks;
+            mask_ids.insert(mask_ids.end(), other.mask_ids.begin(), other.mask_ids.end());
+            mask_views.insert(mask_views.end(), other.mask_views.begin(), other.mask_views.end());
+        }
+        else if (has_masks())
+        {
+            mask_ids.resize(base + other.cords.size(), -1);
+            mask_views.resize(sample_count() + other.sample_count());
+        }
+        cords.insert(cords.end(), other.cords.begin(), other.cords.end());
+        labels.insert(labels.end(), other.labels.begin(), other.labels.end());
+        for (size_t i = 1; i < other.offsets.size(); i++)
+            offsets.push_back(base + other.offsets[i]);
+    }
+};
+
 struct MetaDataBatch
 {
+    MetaDataBatch() = default;
+    MetaDataBatch(const MetaDataBatch &) = default;
+    MetaDataBatch(MetaDataBatch &&) = default;
     virtual ~MetaDataBatch() = default;
     virtual void clear() = 0;
     virtual void resize(int batch_size) = 0;
@@ -160,19 +445,56 @@ struct MetaDataBatch
         return this;
     }
     virtual std::shared_ptr<MetaDataBatch> clone()  = 0;
+    /// Moves the content to a batch handed over to the ring buffer, this batch is left empty to be filled again. The batches
+    /// taken earlier and released since by the ring buffer and the user are reused, so the storage of both sides is kept.
+    virtual std::shared_ptr<MetaDataBatch> take() = 0;
     std::vector<int>& get_label_batch() { return _label_id; }
-    std::vector<BoundingBoxCords>& get_bb_cords_batch() { return _bb_cords; }
-    std::vector<BoundingBoxCords_xcycwh>& get_bb_cords_batch_xcycxwh() { return _bb_cords_xcycwh; }
-    std::vector<BoundingBoxLabels>& get_bb_labels_batch() { return _bb_label_ids; }
+    BoundingBoxBatchData& get_bb_batch() { return _bb; }
+    const BoundingBoxBatchData& get_bb_batch() const { return _bb; }
     ImgSizes & get_img_sizes_batch() { return _img_sizes; }
     JointsDataBatch & get_joints_data_batch() { return _joints_data; }
+    MetaDataFields & get_fields() { return _fields; }
 protected:
+    /// Batches handed over by take(), they are not shared with the copies of the batch
+    struct TakenBatches
+    {
+        std::vector<std::shared_ptr<MetaDataBatch>> batches;
+        TakenBatches() = default;
+        TakenBatches(const TakenBatches &) {}
+        TakenBatches &operator=(const TakenBatches &) { return *this; }
+    };
+    template <typename Batch>
+    std::shared_ptr<MetaDataBatch> take_as()
+    {
+        std::shared_ptr<MetaDataBatch> batch;
+        // Only the list still holds a batch once the ring buffer and the user are done with it
+        for (auto &taken : _taken.batches)
+        {
+            if (taken.use_count() == 1)
+            {
+                batch = taken;
+                break;
+            }
+        }
+        if (!batch)
+        {
+            batch = std::make_shared<Batch>();
+            _taken.batches.push_back(batch);
+        }
+        batch->clear();
+        std::swap(_label_id, batch->_label_id);
+        std::swap(_bb, batch->_bb);
+        std::swap(_img_sizes, batch->_img_sizes);
+        std::swap(_joints_data, batch->_joints_data);
+        std::swap(_fields, batch->_fields);
+        return batch;
+    }
+    TakenBatches _taken;
     std::vector<int> _label_id = {}; // For label use only
-    std::vector<BoundingBoxCords> _bb_cords = {};
-    std::vector<BoundingBoxCords_xcycwh> _bb_cords_xcycwh = {};
-    std::vector<BoundingBoxLabels> _bb_label_ids = {};
+    BoundingBoxBatchData _bb = {};
     std::vector<ImgSize> _img_sizes = {};
     JointsDataBatch _joints_data = {};
+    MetaDataFields _fields = {}; // Extra fields of the readers that have them
 };
 
 struct LabelBatch : public MetaDataBatch
@@ -180,10 +502,12 @@ struct LabelBatch : public MetaDataBatch
     void clear() override
     {
         _label_id.clear();
+        _fields.clear();
     }
     MetaDataBatch&  operator += (MetaDataBatch& other) override
     {
         _label_id.insert(_label_id.end(), other.get_label_batch().begin(), other.get_label_batch().end());
+        _fields.append(other.get_fields());
         return *this;
     }
     void resize(int batch_size) override
@@ -198,6 +522,10 @@ struct LabelBatch : public MetaDataBatch
     {
         return std::make_shared<LabelBatch>(*this);
     }
+    std::shared_ptr<MetaDataBatch> take() override
+    {
+        return take_as<LabelBatch>();
+    }
     explicit LabelBatch(std::vector<int>& labels)
     {
         _label_id = std::move(labels);
@@ -209,31 +537,34 @@ struct BoundingBoxBatch: public MetaDataBatch
 {
     void clear() override
     {
-        _bb_cords.clear();
-        _bb_label_ids.clear();
+        _bb.clear();
         _img_sizes.clear();
+        _fields.clear();
     }
     MetaDataBatch&  operator += (MetaDataBatch& other) override
     {
-        _bb_cords.insert(_bb_cords.end(), other.get_bb_cords_batch().begin(), other.get_bb_cords_batch().end());
-        _bb_label_ids.insert(_bb_label_ids.end(), other.get_bb_labels_batch().begin(), other.get_bb_labels_batch().end());
+        _bb.append(other.get_bb_batch());
         _img_sizes.insert(_img_sizes.end(), other.get_img_sizes_batch().begin(), other.get_img_sizes_batch().end());
+        _fields.append(other.get_fields());
         return *this;
     }
     void resize(int batch_size) override
     {
-        _bb_cords.resize(batch_size);
-        _bb_label_ids.resize(batch_size);
+        _bb.resize(batch_size);
         _img_sizes.resize(batch_size);
     }
     int size() override
     {
-        return _bb_cords.size();
+        return _bb.sample_count();
     }
     std::shared_ptr<MetaDataBatch> clone() override
     {
         return std::make_shared<BoundingBoxBatch>(*this);
     }
+    std::shared_ptr<MetaDataBatch> take() override
+    {
+        return take_as<BoundingBoxBatch>();
+    }
 };
 
 struct KeyPointBatch : public MetaDataBatch
@@ -242,8 +573,8 @@ struct KeyPointBatch : public MetaDataBatch
     {
         _img_sizes.clear();
         _joints_data = {};
-        _bb_cords.clear();
-        _bb_label_ids.clear();
+        _bb.clear();
+        _fields.clear();
     }
     MetaDataBatch&  operator += (MetaDataBatch& other) override
     {
@@ -256,6 +587,7 @@ struct KeyPointBatch : public MetaDataBatch
         _joints_data.joints_visibility_batch.insert(_joints_data.joints_visibility_batch.end(), other.get_joints_data_batch().joints_visibility_batch.begin(), other.get_joints_data_batch().joints_visibility_batch.end());
         _joints_data.score_batch.insert(_joints_data.score_batch.end(), other.get_joints_data_batch().score_batch.begin(), other.get_joints_data_batch().score_batch.end());
         _joints_data.rotation_batch.insert(_joints_data.rotation_batch.end(), other.get_joints_data_batch().rotation_batch.begin(), other.get_joints_data_batch().rotation_batch.end());
+        _fields.append(other.get_fields());
         return *this;
     }
     void resize(int batch_size) override
@@ -268,8 +600,7 @@ struct KeyPointBatch : public MetaDataBatch
         _joints_data.joints_visibility_batch.resize(batch_size);
         _joints_data.score_batch.resize(batch_size);
         _joints_data.rotation_batch.resize(batch_size);
-        _bb_cords.resize(batch_size);
-        _bb_label_ids.resize(batch_size);
+        _bb.resize(batch_size);
     }
     int size() override
     {
@@ -279,6 +610,10 @@ struct KeyPointBatch : public MetaDataBatch
     {
         return std::make_shared<KeyPointBatch>(*this);
     }
+    std::shared_ptr<MetaDataBatch> take() override
+    {
+        return take_as<KeyPointBatch>();
+    }
 };
 
 using ImageNameBatch = std::vector<std::string>;
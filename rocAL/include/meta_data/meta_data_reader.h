@@ -47,7 +47,8 @@ enum class MetaDataType
 {
     Label,
     BoundingBox,
-    KeyPoints
+    KeyPoints,
+    PolygonMask     //!< Bounding boxes with the segmentation mask of each box
 };
 
 struct MetaDataConfig
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include <memory>
 #include "meta_data_graph.h"
 #include "meta_data.h"
+#include "box_transform_cpu.h"
 #include "node.h"
 #include "parameter_factory.h"
 
@@ -34,28 +35,8 @@ public:
     MetaNode() {}
     virtual ~MetaNode() {};
     virtual void update_parameters(MetaDataBatch* input_meta_data) = 0;
-    double BBoxIntersectionOverUnion(const BoundingBoxCord &box1, const BoundingBoxCord &box2, bool is_iou) const;
     int _batch_size;
     float _iou_threshold = 0.25;
+protected:
+    BoundingBoxBatchData _output_bb; // boxes kept by the nodes that filter, swapped into the batch
 };
-
-inline double MetaNode::BBoxIntersectionOverUnion(const BoundingBoxCord &box1, const BoundingBoxCord &box2, bool is_iou = false) const
-{
-    double iou;
-    float xA = std::max(box1.l, box2.l);
-    float yA = std::max(box1.t, box2.t);
-    float xB = std::min(box1.r, box2.r);
-    float yB = std::min(box1.b, box2.b);
-
-    float intersection_area = std::max((float)0.0, xB - xA) * std::max((float)0.0, yB - yA);
-    float box1_area = (box1.b - box1.t) * (box1.r - box1.l);
-    float box2_area = (box2.b - box2.t) * (box2.r - box2.l);
-
-    if (is_iou)
-        iou = intersection_area / float(box1_area + box2_area - intersection_area);
-    else
-        iou = intersection_area / float(box1_area);
-
-    return iou;
-}
-
@@ -29,8 +29,6 @@ THE SOFTWARE.
 #include "node.h"
 #include "node_rotate.h"
 #include "parameter_vx.h"
-#define PI 3.14159265
-#define RAD(deg) (deg * PI / 180)
 
 class RotateMetaNode:public MetaNode
 {
@@ -39,10 +37,5 @@ class RotateMetaNode:public MetaNode
         void update_parameters(MetaDataBatch* input_meta_data)override;
         std::shared_ptr<RotateNode> _node = nullptr;
     private:
-        void initialize();
-        vx_array _src_width, _src_height;
-        std::vector<uint> _src_width_val, _src_height_val;
         unsigned int _dst_width, _dst_height;
-        vx_array _angle;
-        std::vector<float> _angle_val;
 };
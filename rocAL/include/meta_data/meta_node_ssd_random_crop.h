@@ -38,16 +38,16 @@ public:
     std::vector<uint32_t> in_width, in_height;
     void set_threshold(float threshold) { _threshold = threshold; }
     void set_num_of_attempts(int num_of_attempts){_num_of_attempts = num_of_attempts;}
+    // Set when no meta node runs before this one, the boxes the node cropped are then the ones of this batch
+    void set_boxes_from_node(bool boxes_from_node) { _boxes_from_node = boxes_from_node; }
     Parameter<float> *x_drift_factor;
     Parameter<float> *y_drift_factor;
 
 private:
     std::shared_ptr<RocalRandomCropParam> _meta_crop_param;
-    vx_array _crop_width, _crop_height, _x1, _y1;
-    std::vector<uint> _crop_width_val, _crop_height_val, _x1_val, _y1_val;
     unsigned int _dst_width, _dst_height;
     float _threshold = 0.5;
     int   _num_of_attempts = 20;
     bool  _enitire_iou = true; // For entire_iou - true and For relative iou - false
-    void initialize();
+    bool  _boxes_from_node = false;
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <utility>
+#include <vector>
+#include "box_transform_cpu.h"
+#include "parameter_counter_rand.h"
+
+/// One of the IoU ranges an SSD crop window is drawn for
+struct SSDCropOption
+{
+    float min_overlap;
+    float max_overlap;
+    bool whole_image = false;  //!< The window is the whole image
+};
+
+struct SSDCropSamplerConfig
+{
+    std::vector<SSDCropOption> options;
+    float min_scale = 0.3f, max_scale = 1.f;                //!< Range of the window width and height, relative to the image
+    float min_aspect_ratio = 0.5f, max_aspect_ratio = 2.f;
+    bool overlap_is_iou = true;     //!< IoU of the box and the window, otherwise the part of the box inside the window
+    bool all_boxes_overlap = true;  //!< Every box must overlap the window within the option's range
+    bool strict_center = false;     //!< The box center must be strictly inside the window, otherwise on its border is enough
+    unsigned max_attempts = 0;      //!< The window falls back to the whole image after this many attempts, 0 keeps drawing
+};
+
+/// Random crop windows of the SSD crop, shared by SSDRandomCropNode and RandomBBoxCropReader. Every attempt draws an option,
+/// then a window of the scale and aspect ratio ranges, until the boxes overlap it within the option's range and at least one
+/// box center is inside it. A sample only draws from its own stream, so the samples of a batch are processed in parallel.
+class SSDCropSampler
+{
+public:
+    explicit SSDCropSampler(SSDCropSamplerConfig config) : _config(std::move(config)) {}
+    /// Window of one sample in normalized coordinates with the overlap range of its option,
+    /// x_align > 0 moves the left edge down to a multiple of x_align pixels of an image image_width wide
+    BoxCropWindow sample(const BoundingBoxCord *boxes, size_t count, SampleRandStream &rand, unsigned image_width = 0, unsigned x_align = 0) const;
+    /// Draws the windows of a batch from streams[i] and crops the boxes to them in the same pass
+    void sample_and_crop(const BoundingBoxBatchData &in, std::vector<SampleRandStream> &streams, std::vector<BoxCropWindow> &windows,
+                         BoundingBoxBatchData &out, const BoxCropOptions &crop_options) const;
+    const SSDCropSamplerConfig &config() const { return _config; }
+private:
+    SSDCropSamplerConfig _config;
+};
@@ -42,7 +42,8 @@ private:
     LabelBatch* _output;
     void read_files(const std::string& _path);
     bool exists(const std::string &image_name) override;
-    void add(std::string image_name, int label);
+    void add(std::string image_name, int label, int field_row = -1);
     std::map<std::string, std::shared_ptr<MetaData>> _map_content;
     std::string _path;
+    MetaDataFields _fields; //!< The numbers after the label of each line, in a "values" field
 };
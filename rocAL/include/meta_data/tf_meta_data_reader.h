@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "commons.h"
 #include "meta_data.h"
 #include "meta_data_reader.h"
+#include "feature.pb.h"
 
 class TFMetaDataReader: public MetaDataReader
 {
@@ -46,7 +47,8 @@ public :
 private:
     void read_files(const std::string& _path);
     bool exists(const std::string &image_name) override;
-    void add(std::string image_name, int label);
+    void add(std::string image_name, int label, int field_row = -1);
+    void read_fields(const google::protobuf::Map<std::string, tensorflow::Feature> &features);
     bool _last_rec;
     size_t _file_id = 0;
     //std::shared_ptr<TF_Read> _TF_read = nullptr;
@@ -62,4 +64,7 @@ private:
     std::vector<std::string> _file_names;
     std::vector<std::string> _subfolder_file_names;
     std::vector<std::string> _image_name;
+    std::vector<std::string> _field_keys;   //!< Features read as extra fields, given to the reader as "field/<key>" entries of the feature key map
+    std::vector<bool> _field_typed;         //!< The type of the field is the kind of the first feature found
+    MetaDataFields _fields;                 //!< One row per record
 };
\ No newline at end of file
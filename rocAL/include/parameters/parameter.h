@@ -21,6 +21,7 @@ THE SOFTWARE.
 */
 
 #pragma once
+#include "parameter_counter_rand.h"
 
 template <typename T>
 class Parameter
@@ -34,6 +35,16 @@ public:
     /// used to internally renew state of the parameter if needed (for random parameters)
     virtual void renew() {};
 
+    /// renews one value per sample of the batch, random parameters draw them from the given stream of keys
+    virtual void renew_batch(T *values, size_t count, const BatchRandKeys &keys, uint32_t stream)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            renew();
+            values[i] = get();
+        }
+    }
+
     virtual ~Parameter() {}
     ///
     /// \return returns if this parameter takes a single value (vs a range of values or many values)
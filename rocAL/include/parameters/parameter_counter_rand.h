@@ -0,0 +1,79 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Keys of the counter based random streams the augmentation parameters of a batch are drawn from.
+/// A value only depends on (seed, epoch, sample, node, parameter), not on the position of the sample in the batch,
+/// the shard it was loaded by or the order the parameters are renewed in.
+struct BatchRandKeys
+{
+    uint32_t seed = 0;
+    uint32_t epoch = 0;
+    std::vector<uint64_t> sample_ids;//!< Hash of the name of each sample of the batch
+    uint32_t node_id = 0;//!< Position of the node in the pipeline
+    uint32_t param_idx = 0;//!< Incremented for every parameter array of the node renewed
+
+    /// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+    static std::array<uint32_t, 4> philox(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key);
+    static uint64_t sample_id(const std::string &name);
+    /// Fills values with one uniform value in [0, 1) per sample of the batch from the given stream of the current node
+    void uniform(double *values, size_t count, uint32_t stream) const;
+    /// Keys used by the parameters renewed on the calling thread, nullptr renews them from their own sequential generators
+    static void set_current(BatchRandKeys *keys) { _current = keys; }
+    static BatchRandKeys *current() { return _current; }
+private:
+    static thread_local BatchRandKeys *_current;
+};
+
+/// Sequential draws from the counter based stream of one sample, for samplers drawing a varying number of values per sample.
+/// The key {seed, ~epoch} keeps these streams apart from the ones of BatchRandKeys::uniform()
+class SampleRandStream
+{
+public:
+    SampleRandStream(uint32_t seed, uint32_t epoch, uint64_t sample_id, uint32_t stream):
+        _key({seed, ~epoch}),
+        _counter({static_cast<uint32_t>(sample_id), static_cast<uint32_t>(sample_id >> 32), stream, 0}) {}
+    /// Uniform value in [lo, hi)
+    float uniform(float lo, float hi) { return lo + (hi - lo) * (static_cast<float>(next() >> 8) * (1.f / 16777216.f)); }
+    /// Uniform value in [0, count)
+    unsigned uniform_int(unsigned count) { return static_cast<unsigned>((static_cast<uint64_t>(next()) * count) >> 32); }
+private:
+    uint32_t next()
+    {
+        if (_used == _block.size())
+        {
+            _block = BatchRandKeys::philox(_counter, _key);
+            _counter[3]++;
+            _used = 0;
+        }
+        return _block[_used++];
+    }
+    std::array<uint32_t, 2> _key;
+    std::array<uint32_t, 4> _counter;
+    std::array<uint32_t, 4> _block = {};
+    unsigned _used = 4;
+};
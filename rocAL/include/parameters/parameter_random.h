@@ -71,6 +71,24 @@ public:
                     ((double)val / (double) _generator.max()) * ((double) _end - (double) _start) + (double) _start);
         }
     }
+    void renew_batch(T *values, size_t count, const BatchRandKeys &keys, uint32_t stream) override
+    {
+        double start, end;
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            start = _start;
+            end = _end;
+        }
+        if(start == end)
+        {
+            std::fill(values, values + count, static_cast<T>(start));
+            return;
+        }
+        std::vector<double> uniform(count);
+        keys.uniform(uniform.data(), count, stream);
+        for(size_t i = 0; i < count; i++)
+            values[i] = static_cast<T>(uniform[i] * (end - start) + start);
+    }
     int update(T start, T end) {
         std::unique_lock<std::mutex> lock(_lock);
         if(end < start)
@@ -185,6 +203,17 @@ struct CustomRand: public Parameter<T>
     {
         return _updated_val;
     };
+    void renew_batch(T *values, size_t count, const BatchRandKeys &keys, uint32_t stream) override
+    {
+        std::vector<double> uniform(count);
+        keys.uniform(uniform.data(), count, stream);
+        std::unique_lock<std::mutex> lock(_lock);
+        for(size_t i = 0; i < count; i++)
+        {
+            auto it = std::upper_bound(_comltv_dist.begin(), _comltv_dist.end(), uniform[i]);
+            values[i] = _values[std::min<size_t>(std::distance(_comltv_dist.begin(), it), _values.size() - 1)];
+        }
+    }
 
     bool single_value() const override
     {
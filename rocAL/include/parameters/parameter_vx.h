@@ -85,6 +85,11 @@ public:
     {
         return _array;
     }
+    /// Values of the current batch as written to the vx array
+    const std::vector<T>& host_array()
+    {
+        return _arrVal;
+    }
     vx_scalar default_scalar(std::shared_ptr<Graph> _graph, vx_enum data_type)
     {
         _scalar = vxCreateScalar(vxGetContext((vx_reference)_graph->get()), data_type, &_val);
@@ -110,10 +115,18 @@ public:
     void update_array( )
     {
         vx_status status;
-        for (uint i=0; i < _batch_size ; i++ )
+        auto keys = BatchRandKeys::current();
+        if(keys && keys->sample_ids.size() >= _batch_size)
+        {
+            _param->renew_batch(_arrVal.data(), _batch_size, *keys, keys->param_idx++);
+        }
+        else
         {
-            _arrVal[i] = renew();
-            //INFO("update_array: " + TOSTR(i) + "," + TOSTR(_arrVal[i]));
+            for (uint i=0; i < _batch_size ; i++ )
+            {
+                _arrVal[i] = renew();
+                //INFO("update_array: " + TOSTR(i) + "," + TOSTR(_arrVal[i]));
+            }
         }
         status = vxCopyArrayRange((vx_array)_array, 0, _batch_size, sizeof(T), _arrVal.data(), VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
         if(status != 0)
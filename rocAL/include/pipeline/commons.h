@@ -52,6 +52,16 @@ enum class RocalAffinity
     CPU
 };
 
+/*! \brief Placement of the loader, decode and processing threads and of the loader buffers on the CPUs
+ *
+ *  NUMA pins every internal shard and its buffers to a NUMA node, shards are spread round robin over the nodes
+ */
+enum class CpuPlacement
+{
+    NONE = 0,
+    NUMA
+};
+
 /*! \brief Color formats currently supported by Rocal SDK as input/output
  *
  */
@@ -101,4 +111,13 @@ struct Timing
     long long unsigned video_read_time= 0;
     long long unsigned video_decode_time= 0;
     long long unsigned video_process_time= 0;
+    // Number of samples that failed decoding and were quarantined, and the number of batch slots filled with a substitute
+    long long unsigned image_decode_failure_count = 0;
+    long long unsigned image_substitution_count = 0;
+    // Busy time of the stages of the pipelined image output routine, the occupancy of a stage is its ratio to pipeline_time
+    long long unsigned pipeline_time = 0;
+    long long unsigned prepare_stage_time = 0;
+    long long unsigned meta_data_stage_time = 0;
+    long long unsigned graph_stage_time = 0;
+    long long unsigned commit_stage_time = 0;
 };
@@ -0,0 +1,66 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <vector>
+#include <sched.h>
+#include "commons.h"
+
+/*! \class CpuTopology The NUMA nodes of the machine and the CPUs of each node the process is allowed to run on
+ *
+ * Read once from /sys/devices/system/node, machines or containers exposing no node information are seen as a single node.
+ */
+class CpuTopology
+{
+public:
+    static CpuTopology* instance();
+    unsigned node_count() const { return _node_cpus.size(); }
+    //! Node the internal shard shard_id is placed on, shards are spread round robin over the nodes
+    unsigned shard_node(unsigned shard_id) const { return shard_id % node_count(); }
+    unsigned node_cpu_count(unsigned node) const { return _node_cpus[node % node_count()].size(); }
+    cpu_set_t node_cpu_set(unsigned node) const;
+    //! Number of physical cores among the allowed CPUs, the SMT siblings of a core are counted once
+    unsigned physical_core_count() const { return _physical_core_count; }
+    //! CPU set of the nodes the shards are placed on, all the CPUs if shard_ids is empty
+    cpu_set_t shards_cpu_set(const std::vector<unsigned> &shard_ids) const;
+    //! Pins the calling thread on the CPUs of the nodes the shards are placed on
+    void pin_current_thread_to_shards(const std::vector<unsigned> &shard_ids) const;
+private:
+    CpuTopology();
+    std::vector<std::vector<unsigned>> _node_cpus;
+    unsigned _physical_core_count = 1;
+};
+
+/*! \class ScopedNodePlacement Pins the calling thread on a NUMA node for the lifetime of the object
+ *
+ * Buffers allocated and first touched in the scope land in the node's memory, and the threads started in the scope
+ * (loader threads, OpenMP and decoder pools) inherit the node's CPU set. The previous affinity is restored at exit.
+ */
+class ScopedNodePlacement
+{
+public:
+    ScopedNodePlacement(CpuPlacement placement, unsigned shard_id);
+    ~ScopedNodePlacement();
+private:
+    cpu_set_t _previous_mask;
+    bool _pinned = false;
+};
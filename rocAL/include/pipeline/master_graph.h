@@ -25,6 +25,9 @@ THE SOFTWARE.
 #include <list>
 #include <variant>
 #include <map>
+#include <queue>
+#include <thread>
+#include <condition_variable>
 #include "graph.h"
 #include "ring_buffer.h"
 #include "timing_debug.h"
@@ -36,8 +39,15 @@ THE SOFTWARE.
 #include "node_video_loader.h"
 #include "node_video_loader_single_shard.h"
 #include "node_cifar10_loader.h"
+#include "decode_scheduler.h"
+#include "prefetch_tuner.h"
+#include "parameter_counter_rand.h"
 #include "meta_data_reader.h"
 #include "meta_data_graph.h"
+#include "box_encoder_cpu.h"
+#include "heatmap_generator_cpu.h"
+#include "label_encoder_cpu.h"
+#include "mask_transform_cpu.h"
 #if ENABLE_HIP
 #include "device_manager_hip.h"
 #include "box_encoder_hip.h"
@@ -49,13 +59,19 @@ class MasterGraph
 {
 public:
     enum class Status { OK = 0,  NOT_RUNNING = 1, NO_MORE_DATA = 2, NOT_IMPLEMENTED = 3, INVALID_ARGUMENTS };
-    MasterGraph(size_t batch_size, RocalAffinity affinity, size_t cpu_thread_count, int gpu_id, size_t prefetch_queue_depth, RocalTensorDataType output_tensor_data_type);
+    MasterGraph(size_t batch_size, RocalAffinity affinity, size_t cpu_thread_count, int gpu_id, size_t prefetch_queue_depth, RocalTensorDataType output_tensor_data_type, CpuPlacement cpu_placement = CpuPlacement::NONE);
     ~MasterGraph();
     Status reset();
     size_t remaining_count();
     MasterGraph::Status to_tensor(void *out_ptr, RocalTensorFormat format, float multiplier0, float multiplier1, float multiplier2,
                     float offset0, float offset1, float offset2, bool reverse_channels, RocalTensorDataType output_data_type, RocalOutputMemType output_mem_type);
     Status copy_output(unsigned char* out_ptr, size_t out_size_in_bytes);
+    /// Copies the output images packed back to back keeping only the valid region of each sample, shapes gets (height, width, channels) and offsets the byte offset of every sample
+    Status copy_output_ragged(unsigned char* out_ptr, size_t out_size_in_bytes, unsigned *shapes, size_t *offsets);
+    size_t ragged_output_byte_size();
+    /// Hands the host buffer of the current output batch to the user without copying, the ring buffer slot is not reused until release_output_lease() is called
+    Status lease_output(void **out_ptr, size_t *out_size, int *lease_id);
+    Status release_output_lease(int lease_id);
     Status copy_out_tensor_planar(void *out_ptr, RocalTensorFormat format, float multiplier0, float multiplier1, float multiplier2,
                     float offset0, float offset1, float offset2, bool reverse_channels, RocalTensorDataType output_data_type);
     size_t output_width();
@@ -69,6 +85,15 @@ public:
     RocalColorFormat output_color_format();
     Status build();
     Status run();
+    /// Starts recording the latency histograms of the stages, disabled by default so the timers only pay for a flag check
+    void enable_stats(bool enable);
+    /// Returns the statistics recorded since enable_stats(), unlike timing() reading them does not reset them
+    RocalPipelineStats stats();
+    /// Allocates the prefetch buffers as deep as memory_budget allows and tunes the depth used and the decode threads during the first tuning_batch_count batches, should be called before the loader is created
+    void enable_auto_tune(size_t memory_budget, unsigned tuning_batch_count);
+    RocalAutoTuneConfig auto_tune_config();
+    /// Weight of this pipeline against the other pipelines sharing the process wide decode threads
+    void set_decode_share(unsigned share) { _decode_client->set_weight(share); }
     Timing timing();
     RocalMemType mem_type();
     void release();
@@ -86,6 +111,8 @@ public:
     MetaDataBatch* create_cifar10_label_reader(const char *source_path, const char *file_prefix);
     MetaDataBatch *create_mxnet_label_reader(const char *source_path, bool is_output);
     void box_encoder(std::vector<float> &anchors, float criteria, const std::vector<float> &means, const std::vector<float> &stds, bool offset, float scale);
+    void heatmap_targets(unsigned heatmap_width, unsigned heatmap_height, float sigma);
+    void label_encoder(unsigned num_classes, float on_value, float off_value, float mixup_alpha, float cutmix_alpha, float mix_probability);
     void create_randombboxcrop_reader(RandomBBoxCrop_MetaDataReaderType reader_type, RandomBBoxCrop_MetaDataType label_type, bool all_boxes_overlap, bool no_crop, FloatParam* aspect_ratio, bool has_shape, int crop_width, int crop_height, int num_attempts, FloatParam* scaling, int total_num_attempts, int64_t seed=0);
     const std::pair<ImageNameBatch,pMetaDataBatch>& meta_data();
     void set_loop(bool val) { _loop = val; }
@@ -95,7 +122,7 @@ public:
         _output_images = output_images;
     }
     void set_output(Image* output_image);
-    size_t calculate_cpu_num_threads(size_t shard_count);
+    size_t calculate_cpu_num_threads(size_t shard_count, unsigned shard_id = 0);
     bool empty() { return (remaining_count() < (_is_sequence_reader_output ? _sequence_batch_size : _user_batch_size)); }
     size_t sequence_batch_size() { return _sequence_batch_size; }
     std::shared_ptr<MetaDataGraph> meta_data_graph() { return _meta_data_graph; }
@@ -111,12 +138,26 @@ public:
         _sequence_batch_size = _user_batch_size * sequence_length;
     }
     Status get_bbox_encoded_buffers(float **boxes_buf_ptr, int **labels_buf_ptr, size_t num_encoded_boxes);
+    //! Either buffer can be null to only copy the other one
+    Status copy_bbox_encoded_buffers(float *boxes_buf, int *labels_buf);
+    bool is_box_encoder() const { return _is_box_encoder; }
+    Status get_heatmap_targets(float **heatmaps_ptr, float **target_weights_ptr);
+    Status copy_heatmap_targets(float *heatmaps, float *target_weights);
+    Status heatmap_targets_size(size_t *heatmaps_size, size_t *target_weights_size);
+    Status get_encoded_labels(float **targets_ptr, float **mix_params_ptr);
+    Status copy_encoded_labels(void *targets, float *mix_params, bool to_device);
     size_t bounding_box_batch_count(int* buf, pMetaDataBatch meta_data_batch);
+    const MaskPolygonBatch& mask_polygons(pMetaDataBatch meta_data_batch);//!< Polygons of the masks of the batch, computed once per batch
+    void rasterize_masks(pMetaDataBatch meta_data_batch, unsigned width, unsigned height, unsigned char *buf);
 #if ENABLE_OPENCL
     cl_command_queue get_ocl_cmd_q() { return _device.resources()->cmd_queue; }
 #endif
 private:
-    Status update_node_parameters();
+    void record_stats(bool enable);//!< Records the latency histograms, while the user asked for them or the prefetch tuner needs them
+    void tune_prefetch();//!< Counts a batch handed to the user and applies the adjustments of the prefetch tuner
+    void place_processing_thread();//!< Pins the calling thread on the NUMA nodes of the loader shards when NUMA placement is requested
+    Status update_node_parameters(const std::vector<std::string> &names);
+    void apply_node_parameters(const std::vector<std::string> &sample_keys);//!< Updates the VX parameters of the nodes, the random ones drawn for each sample from the stream keyed on its sample key
     Status allocate_output_tensor();
     Status deallocate_output_tensor();
     void create_single_graph();
@@ -124,6 +165,27 @@ private:
     void stop_processing();
     void output_routine();
     void output_routine_video();
+    /// Per batch state of the pipelined output_routine(), a batch keeps its own ring buffer slot and meta data while it moves through the stages
+    struct PipelineSlot
+    {
+        size_t ring_slot = 0;
+        int64_t batch_index = 0;//!< Index of the batch in the trace events of the stages
+        ImageNameBatch names;
+        pMetaDataBatch meta_data = nullptr;
+        decoded_image_info decode_info;
+        crop_image_info crop_info;
+        OutputRoiBatch output_roi;
+    };
+    /// Computes the (height, width, channels) and packed byte offset of every sample of the batch at the front of the ring buffer, returns the packed size
+    size_t ragged_output_layout(std::vector<unsigned> &shapes, std::vector<size_t> &offsets);
+    /// The meta data stage augments the meta data of a batch while the graph processes its images and renews the parameters of the next batch
+    void meta_data_stage_routine();
+    /// The commit stage box encodes the meta data of a batch and pushes it to the ring buffer while the next batch is being processed
+    void commit_stage_routine();
+    void start_pipeline_stages();
+    void stop_pipeline_stages();
+    /// Blocks until the stages are done with all the batches given to them, returns false if a stage failed
+    bool wait_for_pipeline_stages(bool commit_stage);
     void decrease_image_count();
     bool processing_on_device_ocl() { return _output_image_info.mem_type() == RocalMemType::OCL; };
     bool processing_on_device_hip() { return _output_image_info.mem_type() == RocalMemType::HIP; };
@@ -150,13 +212,17 @@ private:
 #endif
     std::shared_ptr<Graph> _graph = nullptr;
     RocalAffinity _affinity;
+    const size_t _user_cpu_num_threads;//!< Number of CPU threads passed by the user, 0 to size them from the cores of each shard
     size_t _cpu_num_threads;//!< Defines the number of CPU threads used for processing
+    const CpuPlacement _cpu_placement;//!< Placement of the loader and processing threads on the NUMA nodes
+    std::shared_ptr<DecodeClient> _decode_client;//!< Share of the process wide decode threads given to this pipeline
     const int _gpu_id;//!< Defines the device id used for processing
     pLoaderModule _loader_module; //!< Keeps the loader module used to feed the input the images of the graph
 #ifdef ROCAL_VIDEO
     pVideoLoaderModule _video_loader_module; //!< Keeps the video loader module used to feed the input sequences of the graph
 #endif
     TimingDBG _convert_time, _process_time, _bencode_time;
+    TimingDBG _mask_load_time, _mask_process_time;//!< Lookup of the batches referencing masks, emission of their polygons or rasters
     const size_t _user_batch_size;//!< Batch size provided by the user
     vx_context _context;
     const RocalMemType _mem_type;//!< Is set according to the _affinity, if GPU, is set to CL, otherwise host
@@ -180,16 +246,38 @@ private:
     bool _is_sequence_reader_output = false; //!< Set to true if Sequence Reader is invoked.
     // box encoder variables
     bool _is_box_encoder = false; //bool variable to set the box encoder
-    std::vector<float> _anchors; // Anchors to be used for encoding, as the array of floats is in the ltrb format of size 8732x4
     size_t _num_anchors;       // number of bbox anchors
-    float _criteria = 0.5; // Threshold IoU for matching bounding boxes with anchors. The value needs to be between 0 and 1.
-    float _scale; // Rescales the box and anchor values before the offset is calculated (for example, to return to the absolute values).
-    bool _offset; // Returns normalized offsets ((encoded_bboxes*scale - anchors*scale) - mean) / stds in EncodedBBoxes that use std and the mean and scale arguments if offset="True"
-    std::vector<float> _means, _stds; //_means:  [x y w h] mean values for normalization _stds: [x y w h] standard deviations for offset normalization.
+    std::unique_ptr<BoxEncoderCpu> _box_encoder_cpu;//!< Encodes the boxes into the ring buffer when the outputs are not on a HIP device
+    std::unique_ptr<HeatmapGeneratorCpu> _heatmap_generator;//!< Renders the joints heatmap targets into the ring buffer
+    std::unique_ptr<LabelEncoderCpu> _label_encoder;//!< Encodes the label targets into the ring buffer and mixes the images of the batch
+    float _pose_sigma = 0;//!< Given to the keypoints reader
+    bool _is_mask_output = false;//!< The COCO reader loads the segmentation masks of the boxes
+    MaskPolygonBatch _mask_polygons;//!< Polygons of the batch _mask_polygons_batch given to the user
+    std::weak_ptr<MetaDataBatch> _mask_polygons_batch;
+    unsigned _pose_output_width = 0, _pose_output_height = 0;
 #if ENABLE_HIP
     BoxEncoderGpu *_box_encoder_gpu = nullptr;
 #endif
     TimingDBG _rb_block_if_empty_time, _rb_block_if_full_time;
+    std::atomic<bool> _stats_enabled{false};
+    BatchRandKeys _rand_keys;
+    unsigned _epoch = 0;//!< Incremented on every reset(), keys the random streams so each epoch gets new augmentations
+    bool _stats_requested = false;//!< Set by enable_stats(), the stats are recorded during tuning either way
+    size_t _prefetch_memory_budget = 0;//!< Memory the ring buffer and the circular buffers can be allocated with when auto tuning
+    unsigned _tuning_batch_count = 0;//!< Batches left to be observed by the prefetch tuner, 0 when not tuning
+    std::unique_ptr<PrefetchTuner> _prefetch_tuner;
+    int64_t _run_count = 0;//!< Batches handed to the user by run(), the batch index of the user thread's trace events
+    std::atomic<long long unsigned> _ring_buffer_level_sum{0}, _ring_buffer_level_samples{0}; //!< Level of the ring buffer sampled on every run() while the stats are enabled
+    std::thread _meta_data_stage_thread, _commit_stage_thread;
+    std::mutex _pipeline_lock;
+    std::condition_variable _pipeline_cv;
+    bool _pipeline_running = false;
+    bool _pipeline_stage_failed = false;
+    bool _meta_data_stage_busy = false;//!< Set while _meta_data_stage_slot is being processed by the meta data stage
+    PipelineSlot _meta_data_stage_slot;
+    std::queue<PipelineSlot> _commit_queue;//!< Batches processed by the graph waiting for the commit stage
+    bool _commit_stage_busy = false;
+    TimingDBG _pipeline_time, _prepare_stage_time, _meta_data_stage_time, _graph_stage_time, _commit_stage_time;//!< Busy time of each stage, the stage occupancy is its ratio to _pipeline_time
 };
 
 template <typename T>
@@ -239,6 +327,13 @@ template<> inline std::shared_ptr<ImageLoaderNode> MasterGraph::add_node(const s
 #endif
     _loader_module = node->get_loader_module();
     _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_cpu_placement(_cpu_placement);
+    _loader_module->set_decode_client(_decode_client);
+    _loader_module->enable_stats(_stats_enabled);
+    _loader_module->set_prefetch_memory_budget(_prefetch_memory_budget / 2);
+    // Loader followed by RandomBBoxCrop: crop windows are known before decode, the loader decodes only the crop region
+    if(_randombboxcrop_meta_data_reader)
+        node->set_random_bbox_data_reader(_randombboxcrop_meta_data_reader);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
         _image_map.insert(std::make_pair(output, node));
@@ -256,6 +351,13 @@ template<> inline std::shared_ptr<ImageLoaderSingleShardNode> MasterGraph::add_n
 #endif    
     _loader_module = node->get_loader_module();
     _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_cpu_placement(_cpu_placement);
+    _loader_module->set_decode_client(_decode_client);
+    _loader_module->enable_stats(_stats_enabled);
+    _loader_module->set_prefetch_memory_budget(_prefetch_memory_budget / 2);
+    // Loader followed by RandomBBoxCrop: crop windows are known before decode, the loader decodes only the crop region
+    if(_randombboxcrop_meta_data_reader)
+        node->set_random_bbox_data_reader(_randombboxcrop_meta_data_reader);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
         _image_map.insert(std::make_pair(output, node));
@@ -273,6 +375,10 @@ template<> inline std::shared_ptr<FusedJpegCropNode> MasterGraph::add_node(const
 #endif
     _loader_module = node->get_loader_module();
     _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_cpu_placement(_cpu_placement);
+    _loader_module->set_decode_client(_decode_client);
+    _loader_module->enable_stats(_stats_enabled);
+    _loader_module->set_prefetch_memory_budget(_prefetch_memory_budget / 2);
     _loader_module->set_random_bbox_data_reader(_randombboxcrop_meta_data_reader);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
@@ -292,6 +398,10 @@ template<> inline std::shared_ptr<FusedJpegCropSingleShardNode> MasterGraph::add
 #endif    
     _loader_module = node->get_loader_module();
     _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_cpu_placement(_cpu_placement);
+    _loader_module->set_decode_client(_decode_client);
+    _loader_module->enable_stats(_stats_enabled);
+    _loader_module->set_prefetch_memory_budget(_prefetch_memory_budget / 2);
     _loader_module->set_random_bbox_data_reader(_randombboxcrop_meta_data_reader);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
@@ -314,6 +424,10 @@ template<> inline std::shared_ptr<Cifar10LoaderNode> MasterGraph::add_node(const
 #endif
     _loader_module = node->get_loader_module();
     _loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _loader_module->set_cpu_placement(_cpu_placement);
+    _loader_module->set_decode_client(_decode_client);
+    _loader_module->enable_stats(_stats_enabled);
+    _loader_module->set_prefetch_memory_budget(_prefetch_memory_budget / 2);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
         _image_map.insert(std::make_pair(output, node));
@@ -336,6 +450,8 @@ template<> inline std::shared_ptr<VideoLoaderNode> MasterGraph::add_node(const s
 #endif    
     _video_loader_module = node->get_loader_module();
     _video_loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _video_loader_module->set_cpu_placement(_cpu_placement);
+    _video_loader_module->enable_stats(_stats_enabled);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
         _image_map.insert(std::make_pair(output, node));
@@ -353,6 +469,8 @@ template<> inline std::shared_ptr<VideoLoaderSingleShardNode> MasterGraph::add_n
 #endif    
     _video_loader_module = node->get_loader_module();
     _video_loader_module->set_prefetch_queue_depth(_prefetch_queue_depth);
+    _video_loader_module->set_cpu_placement(_cpu_placement);
+    _video_loader_module->enable_stats(_stats_enabled);
     _root_nodes.push_back(node);
     for(auto& output: outputs)
         _image_map.insert(std::make_pair(output, node));
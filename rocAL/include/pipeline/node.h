@@ -52,6 +52,7 @@ protected:
     std::shared_ptr<Graph> _graph = nullptr;
     vx_array _src_roi_width = nullptr;
     vx_array _src_roi_height = nullptr;
+    std::vector<uint32_t> _src_roi_width_val, _src_roi_height_val; // host copy of the input ROI of the current batch, read by the meta nodes
     vx_node _node = nullptr;
     size_t _batch_size;
     MetaDataBatch* _meta_data_info;
@@ -0,0 +1,65 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include "commons.h"
+#include "rocal_api_types.h"
+
+/*! \class PrefetchTuner Tunes the prefetch depth and the decode threads of a pipeline during its first batches
+ *
+ * Every window of batches, the time the user waited for the pipeline is compared with the time the pipeline waited for
+ * the user. A starving user gets more decode threads if loading is slower than the graph, a deeper prefetch queue
+ * otherwise. When the pipeline is well ahead of the user, decode threads are given back as long as loading stays ahead.
+ */
+class PrefetchTuner
+{
+public:
+    //! Largest depth the buffers are allocated with when a memory budget is given
+    static constexpr size_t MAX_DEPTH = 16;
+    //! Number of batches of batch_size_in_bytes fitting in memory_budget, at least min_depth and at most MAX_DEPTH
+    static size_t depth_within_budget(size_t memory_budget, size_t batch_size_in_bytes, size_t min_depth);
+    PrefetchTuner(size_t depth, size_t max_depth, size_t decode_threads, size_t max_decode_threads, size_t shard_count,
+                  unsigned tuning_batch_count);
+    //! Counts a batch handed to the user, returns true at the end of an observation window
+    bool count_batch();
+    //! Adjusts the depth and the decode threads from the statistics at the end of a window, returns true if one changed
+    bool update(const RocalPipelineStats &stats);
+    bool done() const { return _batch_count >= _tuning_batch_count; }
+    size_t depth() const { return _depth; }
+    size_t decode_threads() const { return _decode_threads; }
+private:
+    enum class Action { NONE, MORE_THREADS, FEWER_THREADS, DEEPER };
+    static constexpr unsigned WINDOW_SIZE = 16; //!< Batches observed before every adjustment
+    static constexpr double STARVING_RATIO = 0.05; //!< The user is starving when it waits more than this fraction of a batch interval
+    static constexpr double IDLE_RATIO = 0.5; //!< The pipeline is idle when it waits for the user more than this fraction of a batch interval
+    size_t _depth, _max_depth;
+    size_t _decode_threads, _max_decode_threads; //!< _decode_threads is 0 when the loader does not support changing it
+    size_t _shard_count;
+    unsigned _tuning_batch_count;
+    unsigned _batch_count = 0;
+    bool _first_window = true;
+    Action _last_action = Action::NONE;
+    RocalPipelineStats _window_start_stats = {};
+    std::chrono::steady_clock::time_point _window_start;
+};
@@ -34,12 +34,24 @@ THE SOFTWARE.
 #include "device_manager_hip.h"
 
 using MetaDataNamePair = std::pair<ImageNameBatch,pMetaDataBatch>;
+/// Width and height of every sample of each output image of a batch, the buffers keep each sample padded to the max image size
+struct OutputRoiBatch
+{
+    std::vector<std::vector<uint32_t>> width;
+    std::vector<std::vector<uint32_t>> height;
+};
 class RingBuffer
 {
 public:
     explicit RingBuffer(unsigned buffer_depth);
     ~RingBuffer();
     size_t level();
+    //! Sets the number of slots allocated by init(), should be called before init(). The depth used stays the one given to the constructor
+    void set_capacity(unsigned buffer_depth);
+    unsigned capacity() { return BUFF_DEPTH; }
+    //! Changes the number of batches processed ahead of the user, up to the capacity, without reallocating the buffers
+    void set_active_depth(unsigned buffer_depth);
+    unsigned active_depth() { return _active_depth; }
     bool empty();
     ///\param mem_type
     ///\param dev
@@ -47,12 +59,31 @@ public:
     ///\param sub_buffer_count
     void init(RocalMemType mem_type, void *dev, unsigned sub_buffer_size, unsigned sub_buffer_count);
     void initBoxEncoderMetaData(RocalMemType mem_type, size_t encoded_bbox_size, size_t encoded_labels_size);
+    void initHeatmapMetaData(size_t heatmaps_size, size_t target_weights_size);
+    void initLabelEncoderMetaData(size_t targets_size, size_t mix_params_size);
     void release_gpu_res();
     std::vector<void*> get_read_buffers() ;
     void* get_host_master_read_buffer();
     std::vector<void*> get_write_buffers();
     std::pair<void*, void*> get_box_encode_write_buffers();
     std::pair<void*, void*> get_box_encode_read_buffers();
+    //! Reserves the next slot after the ones already reserved so several batches can be processed at once, blocks if the buffer is full
+    size_t reserve_write_slot();
+    std::vector<void*> get_write_buffers(size_t slot);
+    std::pair<void*, void*> get_box_encode_write_buffers(size_t slot);
+    std::pair<void*, void*> get_heatmap_write_buffers(size_t slot);
+    std::pair<void*, void*> get_heatmap_read_buffers();
+    std::pair<void*, void*> get_label_encoder_write_buffers();
+    std::pair<void*, void*> get_label_encoder_write_buffers(size_t slot);
+    std::pair<void*, void*> get_label_encoder_read_buffers();
+    //! Pushes the oldest reserved slot with its meta data, reserved slots are pushed in the order they are reserved
+    void push_reserved(ImageNameBatch names, pMetaDataBatch meta_data, OutputRoiBatch output_roi = OutputRoiBatch());
+    //! Returns the sample sizes of the batch at the read pointer, empty if they were not given when it was pushed
+    const OutputRoiBatch& get_output_roi();
+    //! Leases the slot at the read pointer to the user, the slot is not written again until release_lease() is called even after it is popped
+    size_t lease_read_slot();
+    void release_lease(size_t slot);
+    void* get_host_master_buffer(size_t slot);
     MetaDataNamePair& get_meta_data();
     void set_meta_data(ImageNameBatch names, pMetaDataBatch meta_data);
     void reset();
@@ -67,11 +98,13 @@ public:
     void release_if_empty();
 private:
     std::queue<MetaDataNamePair> _meta_ring_buffer;
+    std::queue<OutputRoiBatch> _roi_ring_buffer;//!< Kept at the same level as _meta_ring_buffer
     MetaDataNamePair _last_image_meta_data;
     void increment_read_ptr();
     void increment_write_ptr();
     bool full();
-    const unsigned BUFF_DEPTH;
+    unsigned BUFF_DEPTH;
+    unsigned _active_depth;
     unsigned _sub_buffer_size;
     unsigned _sub_buffer_count;
     std::mutex _lock;
@@ -82,12 +115,22 @@ private:
     std::vector<std::vector<void*>> _host_sub_buffers;
     std::vector<void *> _dev_bbox_buffer;
     std::vector<void *> _dev_labels_buffer;
+    std::vector<void *> _host_bbox_buffer;//!< Encoded boxes and labels of each slot when the outputs are not on a HIP device
+    std::vector<void *> _host_labels_buffer;
+    std::vector<void *> _host_heatmap_buffer;//!< Heatmap targets and target weights of each slot, always on the host
+    std::vector<void *> _host_target_weight_buffer;
+    std::vector<void *> _host_label_targets_buffer;//!< Encoded label targets and mix parameters of each slot, always on the host
+    std::vector<void *> _host_mix_params_buffer;
     bool _dont_block = false;
     RocalMemType _mem_type;
     void *_dev;
     size_t _write_ptr;
     size_t _read_ptr;
     size_t _level;
+    size_t _reserved;//!< Number of slots reserved by reserve_write_slot() but not pushed yet
+    std::vector<unsigned> _leases;//!< Number of leases held by the user on each slot, kept across reset() since the user may still hold them
+    bool _writer_released = false;//!< Set by unblock_writer() so a writer waiting for a leased slot stops waiting
+    void wait_if_leased(std::unique_lock<std::mutex> &lock, size_t slot);
     std::mutex  _names_buff_lock;
     const size_t MEM_ALIGNMENT = 256;
 };
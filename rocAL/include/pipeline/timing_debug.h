@@ -25,10 +25,117 @@ THE SOFTWARE.
 #include <iostream>
 #include <chrono>
 #include <utility>
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include "commons.h"
+#include "trace_recorder.h"
 
 
 #define DEFAULT_DBG_TIMING 1
+
+/*! \brief Log-linear histogram of durations in microseconds
+*
+* Durations below 16 us get a bucket per microsecond, above that every power of two is split into 8 buckets so the
+* percentiles are within 12.5% of the exact value. Recording is lock free, the histogram can be read while it is recorded.
+*/
+class LatencyHistogram {
+public:
+    LatencyHistogram() { reset(); }
+    LatencyHistogram(const LatencyHistogram& other) { reset(); merge(other); }
+    LatencyHistogram& operator=(const LatencyHistogram& other)
+    {
+        if(this != &other) {
+            reset();
+            merge(other);
+        }
+        return *this;
+    }
+
+    inline
+    void record(unsigned long long us)
+    {
+        _buckets[bucket(us)].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _total.fetch_add(us, std::memory_order_relaxed);
+        auto max = _max.load(std::memory_order_relaxed);
+        while(us > max && !_max.compare_exchange_weak(max, us, std::memory_order_relaxed));
+    }
+
+    //! Adds the durations recorded by other, used to combine the histograms of the internal shards
+    void merge(const LatencyHistogram& other)
+    {
+        for(unsigned i = 0; i < BUCKET_COUNT; i++)
+            _buckets[i].fetch_add(other._buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _count.fetch_add(other.count(), std::memory_order_relaxed);
+        _total.fetch_add(other.total(), std::memory_order_relaxed);
+        if(other.max() > max())
+            _max.store(other.max(), std::memory_order_relaxed);
+    }
+
+    void reset()
+    {
+        for(auto& b: _buckets)
+            b.store(0, std::memory_order_relaxed);
+        _count.store(0, std::memory_order_relaxed);
+        _total.store(0, std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+    unsigned long long count() const { return _count.load(std::memory_order_relaxed); }
+    unsigned long long total() const { return _total.load(std::memory_order_relaxed); }
+    unsigned long long max() const { return _max.load(std::memory_order_relaxed); }
+
+    //! Returns the upper bound of the bucket holding the p-th (0 to 1) fraction of the durations
+    unsigned long long percentile(double p) const
+    {
+        unsigned long long total_count = 0;
+        for(auto& b: _buckets)
+            total_count += b.load(std::memory_order_relaxed);
+        if(total_count == 0)
+            return 0;
+        auto rank = static_cast<unsigned long long>(p * total_count + 0.5);
+        rank = std::min(std::max(rank, 1ULL), total_count);
+        unsigned long long seen = 0;
+        for(unsigned i = 0; i < BUCKET_COUNT; i++) {
+            seen += _buckets[i].load(std::memory_order_relaxed);
+            if(seen >= rank)
+                return std::min(bucket_upper_bound(i), max());
+        }
+        return max();
+    }
+
+private:
+    static constexpr unsigned LINEAR_BUCKETS = 16;
+    static constexpr unsigned SUB_BUCKETS = 8;
+    static constexpr unsigned OCTAVES = 40;
+    static constexpr unsigned BUCKET_COUNT = LINEAR_BUCKETS + (OCTAVES - 4) * SUB_BUCKETS;
+
+    static unsigned bucket(unsigned long long us)
+    {
+        if(us < LINEAR_BUCKETS)
+            return us;
+        unsigned octave = 63 - __builtin_clzll(us);
+        if(octave >= OCTAVES)
+            return BUCKET_COUNT - 1;
+        unsigned sub = (us >> (octave - 3)) & (SUB_BUCKETS - 1);
+        return LINEAR_BUCKETS + (octave - 4) * SUB_BUCKETS + sub;
+    }
+
+    static unsigned long long bucket_upper_bound(unsigned idx)
+    {
+        if(idx < LINEAR_BUCKETS)
+            return idx;
+        unsigned octave = 4 + (idx - LINEAR_BUCKETS) / SUB_BUCKETS;
+        unsigned long long sub = (idx - LINEAR_BUCKETS) % SUB_BUCKETS;
+        return ((SUB_BUCKETS + sub + 1) << (octave - 3)) - 1;
+    }
+
+    std::array<std::atomic<unsigned long long>, BUCKET_COUNT> _buckets;
+    std::atomic<unsigned long long> _count, _total, _max;
+};
+
 /*! \brief Debugging RocalDbgTiming class
 *
 * Can be used anywhere in the code for adding RocalDbgTiming for debugging and profiling
@@ -44,14 +151,17 @@ public:
             _accumulated_time(_t_start - _t_start),
             _count(0),
             _enable(enable),
-            _name(std::move(name))
+            _name(std::move(name)),
+            _tracer(TraceRecorder::instance()),
+            _trace_name(_tracer->intern(_name))
     {}
 
     //! Starts the timer
     inline
     void start()
     {
-        if(!_enable)
+        _tracer->begin(_trace_name);
+        if(!_enable && !_stats_enabled.load(std::memory_order_relaxed))
             return;
 
         _t_start = std::chrono::high_resolution_clock::now();
@@ -61,7 +171,9 @@ public:
     inline
     void end()
     {
-        if(!_enable)
+        _tracer->end(_trace_name);
+        bool stats_enabled = _stats_enabled.load(std::memory_order_acquire);
+        if(!_enable && !stats_enabled)
             return;
 
         std::chrono::high_resolution_clock::time_point t_end =
@@ -72,9 +184,25 @@ public:
             _instantaneous_time = t_end - _t_start;
             _accumulated_time = _accumulated_time + _instantaneous_time;
             _count++;
+            if(stats_enabled)
+                _histogram->record(static_cast<unsigned long long>(_instantaneous_time.count()));
         }
     }
 
+    //! Records every measured duration in a histogram, which unlike get_timing() is not reset when it is read
+    void enable_stats(bool enable)
+    {
+        if(enable && !_histogram)
+            _histogram = std::make_shared<LatencyHistogram>();
+        _stats_enabled.store(enable, std::memory_order_release);
+    }
+
+    //! Returns a copy of the durations recorded since enable_stats() was called
+    LatencyHistogram stats() const
+    {
+        return _histogram ? *_histogram : LatencyHistogram();
+    }
+
     //! Prints total elapsed time
     unsigned long long get_timing()
     {
@@ -110,6 +238,33 @@ private:
     unsigned _count;
     const bool _enable;
     std::string _name;
+    std::atomic<bool> _stats_enabled{false};
+    std::shared_ptr<LatencyHistogram> _histogram = nullptr;
+    TraceRecorder *_tracer;
+    const char *_trace_name; //!< Name of the begin and end events recorded at start() and end() when tracing is enabled
+};
 
+/*! \brief Starts a TimingDBG at construction and stops it at destruction
+*
+* Keeps the begin and end trace events of the timer balanced when the timed scope is left early or by an exception
+*/
+class TimingScope {
+public:
+    explicit TimingScope(TimingDBG &timer): _timer(timer) { _timer.start(); }
+    ~TimingScope() { _timer.end(); }
+    TimingScope(const TimingScope&) = delete;
+    TimingScope& operator=(const TimingScope&) = delete;
+private:
+    TimingDBG &_timer;
+};
 
+/*! \brief Statistics of a loader module, the durations keep accumulating until the pipeline is released
+*/
+struct LoaderStats
+{
+    LatencyHistogram read_time, decode_time;
+    long long unsigned bytes_read = 0;
+    size_t buffer_level = 0; //!< Batches currently waiting in the circular buffers of the shards
+    size_t buffer_depth = 0;
+    double mean_buffer_level = 0; //!< Level of the circular buffers averaged over the batches handed to the pipeline
 };
\ No newline at end of file
@@ -0,0 +1,119 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#pragma once
+#include <atomic>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*! \class TraceRecorder Records begin and end events of the pipeline threads and writes them as a Chrome trace (chrome://tracing, ui.perfetto.dev)
+ *
+ * Every thread appends to its own buffer without locking, the buffers are only read when the trace is written. Tracing is
+ * off by default, it is turned on by rocalEnableTracing() or by setting the ROCAL_TRACE_FILE environment variable, in which
+ * case the trace is written to that file at every rocalRelease(). When off, recording an event costs a single flag check.
+ */
+class TraceRecorder
+{
+public:
+    static TraceRecorder* instance();
+    bool enabled() const { return _enabled.load(std::memory_order_relaxed); }
+    //! Starts recording, the trace is written to trace_file by dump(), an empty trace_file stops recording
+    void enable(const std::string &trace_file);
+    //! Writes the events recorded so far to trace_file, or to the file passed to enable() if trace_file is empty
+    /// The buffers of the threads which ended are freed once written, so their events are not in the later traces
+    void dump(const std::string &trace_file = "");
+    //! Returns a pointer to a copy of name that stays valid for the lifetime of the process, the events only keep the pointer
+    const char* intern(const std::string &name);
+    void begin(const char *name, int64_t batch = -1, int64_t sample = -1) { if (enabled()) record(name, 'B', batch, sample); }
+    void end(const char *name, int64_t batch = -1, int64_t sample = -1) { if (enabled()) record(name, 'E', batch, sample); }
+    void instant(const char *name, int64_t batch = -1) { if (enabled()) record(name, 'i', batch, -1); }
+    //! Names the calling thread in the trace
+    void set_thread_name(const std::string &name);
+    //! Sets the batch the events of the calling thread belong to when the event does not give one
+    static void set_thread_batch(int64_t batch);
+    static int64_t thread_batch() { return _thread_batch; }
+private:
+    struct Event
+    {
+        const char *name;
+        int64_t ts_ns;
+        int64_t batch;
+        int64_t sample;
+        char phase;
+    };
+    //! Events of one thread, stored in chunks allocated on demand so the chunks already written never move
+    struct ThreadBuffer
+    {
+        static constexpr size_t CHUNK_SIZE = 4096;
+        static constexpr size_t MAX_CHUNKS = 256;
+        long tid;
+        std::string thread_name;
+        std::array<std::atomic<Event*>, MAX_CHUNKS> chunks{};
+        std::atomic<size_t> count{0}; //!< Events published to the readers
+        std::atomic<size_t> dropped{0};
+        std::atomic<bool> exited{false}; //!< Set when the owner thread ends, the buffer is freed once its events are written
+        ~ThreadBuffer();
+    };
+    //! Holds the buffer of a thread, marks it as exited when the thread ends
+    struct ThreadBufferOwner
+    {
+        ThreadBuffer *buffer = nullptr;
+        ~ThreadBufferOwner();
+    };
+    TraceRecorder();
+    void record(const char *name, char phase, int64_t batch, int64_t sample);
+    ThreadBuffer* thread_buffer();
+    std::atomic<bool> _enabled{false};
+    std::string _trace_file;
+    int64_t _start_ns; //!< Timestamps are relative to the creation of the recorder
+    std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+    std::set<std::string> _names;
+    std::mutex _lock;
+    static thread_local ThreadBufferOwner _thread_buffer;
+    static thread_local int64_t _thread_batch;
+};
+
+/*! \class TraceScope Records a begin event at construction and the matching end event at destruction */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name, int64_t batch = -1, int64_t sample = -1) : _name(name), _batch(batch), _sample(sample)
+    {
+        _recording = TraceRecorder::instance()->enabled();
+        if (_recording)
+            TraceRecorder::instance()->begin(_name, _batch, _sample);
+    }
+    ~TraceScope()
+    {
+        if (_recording)
+            TraceRecorder::instance()->end(_name, _batch, _sample);
+    }
+private:
+    const char *_name;
+    int64_t _batch, _sample;
+    bool _recording;
+};
@@ -150,6 +150,8 @@ public:
 
     //! Returns the name/identifier of the last item opened in this resource
     virtual std::string id() = 0;
+    //! Returns the key telling the last item opened apart from all the other items of the dataset, the readers whose ids can repeat override it
+    virtual std::string path() { return id(); }
     //! Returns the number of items remained in this resource
     virtual unsigned count_items() = 0;
     
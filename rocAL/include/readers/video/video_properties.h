@@ -50,10 +50,18 @@ typedef struct VideoProperties
 typedef struct Properties
 {
     unsigned width, height, frames_count, avg_frame_rate_num, avg_frame_rate_den;
+    std::vector<unsigned> keyframes; //!< Frame numbers of the key frames in the index of the container
 } Properties;
 
 void substring_extraction(std::string const &str, const char delim, std::vector<std::string> &out);
 void open_video_context(const char *video_file_path, Properties &props);
+/// Manifest of the video properties of source_path, beside it. ROCAL_VIDEO_MANIFEST overrides it and disables it when empty
+std::string video_manifest_path(const char *source_path);
+/// Probes the videos not probed yet in parallel. The properties are kept for the process and in the manifest of source_path,
+/// a video listed there with the same size and modification time is not opened again
+void prefetch_video_properties(const std::vector<std::string> &video_file_paths, const char *source_path);
+/// Properties of a video, from the ones already probed when its size and modification time did not change
+void get_video_properties(const std::string &video_file_path, Properties &props);
 void get_video_properties_from_txt_file(VideoProperties &video_props, const char *file_path, bool file_list_frame_num);
 void find_video_properties(VideoProperties &video_props, const char *source_path, bool file_list_frame_num);
 #endif
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "commons.h"
 #include "context.h"
 #include "rocal_api.h"
+#include "trace_recorder.h"
 
 RocalStatus ROCAL_API_CALL
 rocalRelease(RocalContext p_context)
@@ -32,6 +33,19 @@ rocalRelease(RocalContext p_context)
     // Deleting context is required to call the destructor of all the member objects
     auto context = static_cast<Context*>(p_context);
     delete context;
+    // The pipeline threads are joined at this point, the trace holds all their events
+    if (TraceRecorder::instance()->enabled())
+    {
+        try
+        {
+            TraceRecorder::instance()->dump();
+        }
+        catch(const std::exception& e)
+        {
+            ERR(e.what())
+            return ROCAL_RUNTIME_ERROR;
+        }
+    }
     return ROCAL_OK;
 }
 
@@ -42,7 +56,8 @@ rocalCreate(
         int gpu_id,
         size_t cpu_thread_count,
         size_t prefetch_queue_depth,
-        RocalTensorOutputType output_tensor_data_type)
+        RocalTensorOutputType output_tensor_data_type,
+        RocalCpuPlacement cpu_placement)
 {
     RocalContext context = nullptr;
     try
@@ -71,7 +86,19 @@ rocalCreate(
                     THROW("Unkown Rocal data type")
             }
         };
-        context = new Context(batch_size, translate_process_mode(affinity), gpu_id, cpu_thread_count, prefetch_queue_depth, translate_output_data_type(output_tensor_data_type));
+        auto translate_cpu_placement = [](RocalCpuPlacement cpu_placement)
+        {
+            switch(cpu_placement)
+            {
+                case ROCAL_CPU_PLACEMENT_NONE:
+                    return CpuPlacement::NONE;
+                case ROCAL_CPU_PLACEMENT_NUMA:
+                    return CpuPlacement::NUMA;
+                default:
+                    THROW("Unkown Rocal cpu placement")
+            }
+        };
+        context = new Context(batch_size, translate_process_mode(affinity), gpu_id, cpu_thread_count, prefetch_queue_depth, translate_output_data_type(output_tensor_data_type), translate_cpu_placement(cpu_placement));
         // Reset seed in case it's being randomized during context creation
     }
     catch(const std::exception& e)
@@ -2009,7 +2009,10 @@ rocalSSDRandomCrop(
         std::shared_ptr<SSDRandomCropNode> crop_node =  context->master_graph->add_node<SSDRandomCropNode>({input}, {output});
         crop_node->init(crop_area_factor, crop_aspect_ratio, x_drift, y_drift, num_of_attempts);
         if (context->master_graph->meta_data_graph())
-            context->master_graph->meta_add_node<SSDRandomCropMetaNode,SSDRandomCropNode>(crop_node);
+        {
+            auto meta_node = context->master_graph->meta_add_node<SSDRandomCropMetaNode,SSDRandomCropNode>(crop_node);
+            meta_node->set_boxes_from_node(context->master_graph->meta_data_graph()->_meta_nodes.size() == 1);
+        }
     }
     catch(const std::exception& e)
     {
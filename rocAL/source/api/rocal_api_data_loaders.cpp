@@ -38,6 +38,8 @@ THE SOFTWARE.
 #include "node_fused_jpeg_crop_single_shard.h"
 #include "node_resize.h"
 #include "meta_node_resize.h"
+#include "sample_info_cache.h"
+#include "decode_scheduler.h"
 
 std::tuple<unsigned, unsigned>
 evaluate_image_data_set(RocalImageSizeEvaluationPolicy decode_size_policy, StorageType storage_type,
@@ -159,7 +161,7 @@ rocalJpegFileSourceSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<ImageLoaderSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                                         source_path, "",
@@ -406,7 +408,7 @@ rocalSequenceReaderSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<ImageLoaderSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                                         source_path, "",
@@ -572,7 +574,7 @@ rocalJpegCaffe2LMDBRecordSourceSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<ImageLoaderSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                                         source_path, "",
@@ -736,7 +738,7 @@ rocalJpegCaffeLMDBRecordSourceSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<ImageLoaderSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                                         source_path, "",
@@ -818,7 +820,7 @@ rocalJpegCaffeLMDBRecordSourcePartialSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<FusedJpegCropSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                             source_path, "",
@@ -901,7 +903,7 @@ rocalJpegCaffe2LMDBRecordSourcePartialSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<FusedJpegCropSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                             source_path, "",
@@ -982,7 +984,7 @@ rocalMXNetRecordSource(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<FusedJpegCropSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                             source_path, "",
@@ -1156,7 +1158,7 @@ rocalMXNetRecordSourceSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<ImageLoaderSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                                         source_path, "",
@@ -1318,7 +1320,7 @@ rocalJpegCOCOFileSourceSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<ImageLoaderSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                                         source_path, json_path,
@@ -1552,7 +1554,7 @@ rocalJpegCOCOFileSourcePartialSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<FusedJpegCropSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                             source_path, json_path,
@@ -1719,7 +1721,7 @@ rocalJpegTFRecordSourceSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<ImageLoaderSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                                         source_path, "",
@@ -1864,7 +1866,7 @@ rocalRawTFRecordSourceSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
 
         context->master_graph->add_node<ImageLoaderSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                                         source_path, "",
@@ -1941,7 +1943,7 @@ rocalFusedJpegCropSingleShard(
                               context->master_graph->mem_type(),
                               color_format );
         output = context->master_graph->create_loader_output_image(info);
-        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count);
+        auto cpu_num_threads = context->master_graph->calculate_cpu_num_threads(shard_count, shard_id);
         context->master_graph->add_node<FusedJpegCropSingleShardNode>({}, {output})->init(shard_id, shard_count, cpu_num_threads,
                                                                           source_path, "",
                                                                           StorageType::FILE_SYSTEM,
@@ -2571,3 +2573,50 @@ rocalResetLoaders(RocalContext p_context)
     }
     return ROCAL_OK;
 }
+
+RocalStatus ROCAL_API_CALL
+rocalSetSampleInfoCacheDir(const char *cache_dir)
+{
+    try
+    {
+        SampleInfoCache::instance()->set_cache_dir(cache_dir ? STR(cache_dir) : STR(""));
+    }
+    catch(const std::exception& e)
+    {
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalSetDecodeThreadBudget(size_t thread_count)
+{
+    try
+    {
+        DecodeScheduler::instance()->set_thread_budget(thread_count);
+    }
+    catch(const std::exception& e)
+    {
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalSetDecodeShare(RocalContext p_context, unsigned share)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        context->master_graph->set_decode_share(share);
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
@@ -114,6 +114,87 @@ rocalCopyToOutput(
     return ROCAL_OK;
 }
 
+size_t ROCAL_API_CALL
+rocalGetOutputRaggedSize(RocalContext p_context)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        return context->master_graph->ragged_output_byte_size();
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+    }
+    return 0;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalCopyToOutputRagged(
+        RocalContext p_context,
+        unsigned char * out_ptr,
+        size_t out_size,
+        unsigned * shapes,
+        size_t * offsets)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        if (context->master_graph->copy_output_ragged(out_ptr, out_size, shapes, offsets) == MasterGraph::Status::INVALID_ARGUMENTS)
+            THROW("Output buffer of " + TOSTR(out_size) + " bytes is smaller than the ragged output size")
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalLeaseOutput(
+        RocalContext p_context,
+        void ** out_ptr,
+        size_t * out_size,
+        int * lease_id)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        if (context->master_graph->lease_output(out_ptr, out_size, lease_id) != MasterGraph::Status::OK)
+            THROW("No output batch is available to lease")
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalReleaseOutputLease(
+        RocalContext p_context,
+        int lease_id)
+{
+    auto context = static_cast<Context*>(p_context);
+    try
+    {
+        if (context->master_graph->release_output_lease(lease_id) != MasterGraph::Status::OK)
+            THROW("Invalid output lease " + TOSTR(lease_id))
+    }
+    catch(const std::exception& e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what())
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
 void
 ROCAL_API_CALL rocalSetOutputs(RocalContext p_context, unsigned int num_of_outputs, std::vector<RocalImage> &output_images)
 {
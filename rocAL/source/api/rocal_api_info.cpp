@@ -23,6 +23,7 @@ THE SOFTWARE.
 #include "commons.h"
 #include "context.h"
 #include "rocal_api.h"
+#include "trace_recorder.h"
 size_t ROCAL_API_CALL rocalGetImageWidth(RocalImage p_image)
 {
     auto image = static_cast<Image *>(p_image);
@@ -122,9 +123,121 @@ TimingInfo
     auto info = context->timing();
     // INFO("bbencode time "+ TOSTR(info.bb_process_time)); //to display time taken for bbox encoder
     if (context->master_graph->is_video_loader())
-        return {info.video_read_time, info.video_decode_time, info.video_process_time, info.copy_to_output};
+        return {info.video_read_time, info.video_decode_time, info.video_process_time, info.copy_to_output, 0, 0, 0, 0, 0, 0, 0};
     else
-        return {info.image_read_time, info.image_decode_time, info.image_process_time, info.copy_to_output};
+        return {info.image_read_time, info.image_decode_time, info.image_process_time, info.copy_to_output,
+                info.image_decode_failure_count, info.image_substitution_count, info.pipeline_time, info.prepare_stage_time,
+                info.meta_data_stage_time, info.graph_stage_time, info.commit_stage_time};
+}
+
+RocalStatus ROCAL_API_CALL
+rocalEnableStats(RocalContext p_context, bool enable)
+{
+    if (!p_context)
+        return ROCAL_CONTEXT_INVALID;
+    auto context = static_cast<Context *>(p_context);
+    try
+    {
+        context->master_graph->enable_stats(enable);
+    }
+    catch (const std::exception &e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what());
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalGetPipelineStats(RocalContext p_context, RocalPipelineStats *stats)
+{
+    if (!p_context)
+        return ROCAL_CONTEXT_INVALID;
+    auto context = static_cast<Context *>(p_context);
+    try
+    {
+        if (!stats)
+            THROW("Null pointer passed as the pipeline stats")
+        *stats = context->master_graph->stats();
+    }
+    catch (const std::exception &e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what());
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalEnableAutoTune(RocalContext p_context, size_t memory_budget, unsigned tuning_batch_count)
+{
+    if (!p_context)
+        return ROCAL_CONTEXT_INVALID;
+    auto context = static_cast<Context *>(p_context);
+    try
+    {
+        context->master_graph->enable_auto_tune(memory_budget, tuning_batch_count);
+    }
+    catch (const std::exception &e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what());
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalGetAutoTuneConfig(RocalContext p_context, RocalAutoTuneConfig *config)
+{
+    if (!p_context)
+        return ROCAL_CONTEXT_INVALID;
+    auto context = static_cast<Context *>(p_context);
+    try
+    {
+        if (!config)
+            THROW("Null pointer passed as the auto tune config")
+        *config = context->master_graph->auto_tune_config();
+    }
+    catch (const std::exception &e)
+    {
+        context->capture_error(e.what());
+        ERR(e.what());
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalEnableTracing(const char *trace_file)
+{
+    try
+    {
+        TraceRecorder::instance()->enable(trace_file ? STR(trace_file) : STR(""));
+    }
+    catch (const std::exception &e)
+    {
+        ERR(e.what());
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
+}
+
+RocalStatus ROCAL_API_CALL
+rocalDumpTrace(const char *trace_file)
+{
+    try
+    {
+        TraceRecorder::instance()->dump(trace_file ? STR(trace_file) : STR(""));
+    }
+    catch (const std::exception &e)
+    {
+        ERR(e.what());
+        return ROCAL_RUNTIME_ERROR;
+    }
+    return ROCAL_OK;
 }
 
 RocalMetaData
@@ -77,12 +77,12 @@ ROCAL_API_CALL rocalCreateVideoLabelReader(RocalContext p_context, const char* s
 }
 
 RocalMetaData
-ROCAL_API_CALL rocalCreateCOCOReader(RocalContext p_context, const char* source_path, bool is_output){
+ROCAL_API_CALL rocalCreateCOCOReader(RocalContext p_context, const char* source_path, bool is_output, bool mask){
     if (!p_context)
         THROW("Invalid rocal context passed to rocalCreateCOCOReader")
     auto context = static_cast<Context*>(p_context);
 
-    return context->master_graph->create_coco_meta_data_reader(source_path, is_output, MetaDataReaderType::COCO_META_DATA_READER,  MetaDataType::BoundingBox);
+    return context->master_graph->create_coco_meta_data_reader(source_path, is_output, MetaDataReaderType::COCO_META_DATA_READER, mask ? MetaDataType::PolygonMask : MetaDataType::BoundingBox);
 }
 
 RocalMetaData
@@ -95,7 +95,8 @@ ROCAL_API_CALL rocalCreateCOCOReaderKeyPoints(RocalContext p_context, const char
 }
 
 RocalMetaData
-ROCAL_API_CALL rocalCreateTFReader(RocalContext p_context, const char* source_path, bool is_output,const char* user_key_for_label, const char* user_key_for_filename)
+ROCAL_API_CALL rocalCreateTFReader(RocalContext p_context, const char* source_path, bool is_output,const char* user_key_for_label, const char* user_key_for_filename,
+    const char* user_keys_for_fields)
 {
     if (!p_context)
         THROW("Invalid rocal context passed to rocalCreateTFReader")
@@ -108,6 +109,14 @@ ROCAL_API_CALL rocalCreateTFReader(RocalContext p_context, const char* source_pa
         {"image/class/label", user_key_for_label_str},
         {"image/filename",user_key_for_filename_str}
     };
+    if (user_keys_for_fields)
+    {
+        std::istringstream keys(user_keys_for_fields);
+        std::string key;
+        while (std::getline(keys, key, ','))
+            if (!key.empty())
+                feature_key_map.insert({"field/" + key, key});
+    }
     return context->master_graph->create_tf_record_meta_data_reader(source_path , MetaDataReaderType::TF_META_DATA_READER , MetaDataType::Label, feature_key_map);}
 
 RocalMetaData
@@ -278,7 +287,7 @@ ROCAL_API_CALL rocalGetBoundingBoxCount(RocalContext p_context, int* buf)
     auto meta_data = context->master_graph->meta_data();
     if(!meta_data.second)
         THROW("No label has been loaded for this output image")
-    size_t meta_data_batch_size = meta_data.second->get_bb_labels_batch().size();
+    size_t meta_data_batch_size = meta_data.second->get_bb_batch().sample_count();
     if(context->user_batch_size() != meta_data_batch_size)
         THROW("meta data batch size is wrong " + TOSTR(meta_data_batch_size) + " != "+ TOSTR(context->user_batch_size() ))
     return context->master_graph->bounding_box_batch_count(buf, meta_data.second);
@@ -291,7 +300,7 @@ ROCAL_API_CALL rocalGetBoundingBoxLabel(RocalContext p_context, int* buf)
         THROW("Invalid rocal context passed to rocalGetBoundingBoxLabel")
     auto context = static_cast<Context*>(p_context);
     auto meta_data = context->master_graph->meta_data();
-    size_t meta_data_batch_size = meta_data.second->get_bb_labels_batch().size();
+    size_t meta_data_batch_size = meta_data.second->get_bb_batch().sample_count();
     if(context->user_batch_size() != meta_data_batch_size)
         THROW("meta data batch size is wrong " + TOSTR(meta_data_batch_size) + " != "+ TOSTR(context->user_batch_size() ))
     if(!meta_data.second)
@@ -299,12 +308,15 @@ ROCAL_API_CALL rocalGetBoundingBoxLabel(RocalContext p_context, int* buf)
         WRN("No label has been loaded for this output image")
         return;
     }
-    for(unsigned i = 0; i < meta_data_batch_size; i++)
+    // The encoder writes its output to the ring buffer instead of the meta data, it is returned like the boxes were
+    // before the host encoder so the counts of rocalGetBoundingBoxCount() still apply
+    if (context->master_graph->is_box_encoder())
     {
-        unsigned bb_count = meta_data.second->get_bb_labels_batch()[i].size();
-        memcpy(buf, meta_data.second->get_bb_labels_batch()[i].data(),  sizeof(int) * bb_count);
-        buf += bb_count;
+        context->master_graph->copy_bbox_encoded_buffers(nullptr, buf);
+        return;
     }
+    const auto &labels = meta_data.second->get_bb_batch().labels;
+    memcpy(buf, labels.data(), sizeof(int) * labels.size());
 }
 
 void
@@ -365,7 +377,7 @@ ROCAL_API_CALL rocalGetBoundingBoxCords(RocalContext p_context, float* buf)
         THROW("Invalid rocal context passed to rocalGetBoundingBoxCords")
     auto context = static_cast<Context*>(p_context);
     auto meta_data = context->master_graph->meta_data();
-    size_t meta_data_batch_size = meta_data.second->get_bb_cords_batch().size();
+    size_t meta_data_batch_size = meta_data.second->get_bb_batch().sample_count();
     if(context->user_batch_size() != meta_data_batch_size)
         THROW("meta data batch size is wrong " + TOSTR(meta_data_batch_size) + " != "+ TOSTR(context->user_batch_size() ))
     if(!meta_data.second)
@@ -373,12 +385,66 @@ ROCAL_API_CALL rocalGetBoundingBoxCords(RocalContext p_context, float* buf)
         WRN("No label has been loaded for this output image")
         return;
     }
-    for(unsigned i = 0; i < meta_data_batch_size; i++)
+    if (context->master_graph->is_box_encoder())
     {
-        unsigned bb_count = meta_data.second->get_bb_cords_batch()[i].size();
-        memcpy(buf, meta_data.second->get_bb_cords_batch()[i].data(), bb_count * sizeof(BoundingBoxCord));
-        buf += (bb_count * 4);
+        context->master_graph->copy_bbox_encoded_buffers(buf, nullptr);
+        return;
     }
+    const auto &cords = meta_data.second->get_bb_batch().cords;
+    memcpy(buf, cords.data(), sizeof(BoundingBoxCord) * cords.size());
+}
+
+unsigned
+ROCAL_API_CALL rocalGetMaskCount(RocalContext p_context, int* buf)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetMaskCount")
+    auto context = static_cast<Context*>(p_context);
+    auto meta_data = context->master_graph->meta_data();
+    if(!meta_data.second)
+        THROW("No mask has been loaded for this output image")
+    const auto &polygons = context->master_graph->mask_polygons(meta_data.second);
+    memcpy(buf, polygons.polygon_counts.data(), sizeof(int) * polygons.polygon_counts.size());
+    return polygons.vertex_counts.size();
+}
+
+unsigned
+ROCAL_API_CALL rocalGetMaskVertexCount(RocalContext p_context, int* buf)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetMaskVertexCount")
+    auto context = static_cast<Context*>(p_context);
+    auto meta_data = context->master_graph->meta_data();
+    if(!meta_data.second)
+        THROW("No mask has been loaded for this output image")
+    const auto &polygons = context->master_graph->mask_polygons(meta_data.second);
+    memcpy(buf, polygons.vertex_counts.data(), sizeof(int) * polygons.vertex_counts.size());
+    return polygons.points.size() / 2;
+}
+
+void
+ROCAL_API_CALL rocalGetMaskCoordinates(RocalContext p_context, float* buf)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetMaskCoordinates")
+    auto context = static_cast<Context*>(p_context);
+    auto meta_data = context->master_graph->meta_data();
+    if(!meta_data.second)
+        THROW("No mask has been loaded for this output image")
+    const auto &polygons = context->master_graph->mask_polygons(meta_data.second);
+    memcpy(buf, polygons.points.data(), sizeof(float) * polygons.points.size());
+}
+
+void
+ROCAL_API_CALL rocalGetMasks(RocalContext p_context, unsigned char* buf, unsigned width, unsigned height)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetMasks")
+    auto context = static_cast<Context*>(p_context);
+    auto meta_data = context->master_graph->meta_data();
+    if(!meta_data.second)
+        THROW("No mask has been loaded for this output image")
+    context->master_graph->rasterize_masks(meta_data.second, width, height, buf);
 }
 
 void
@@ -456,32 +522,8 @@ ROCAL_API_CALL rocalCopyEncodedBoxesAndLables(RocalContext p_context, float* box
     if (!p_context)
         THROW("Invalid rocal context passed to rocalCopyEncodedBoxesAndLables")
     auto context = static_cast<Context *>(p_context);
-    auto meta_data = context->master_graph->meta_data();
-    size_t meta_data_batch_size = meta_data.second->get_bb_labels_batch().size();
-    if (context->user_batch_size() != meta_data_batch_size)
-        THROW("meta data batch size is wrong " + TOSTR(meta_data_batch_size) + " != " + TOSTR(context->user_batch_size()))
-    if (!meta_data.second)
-    {
-        WRN("No encoded labels and bounding boxes has been loaded for this output image")
-        return;
-    }
-    unsigned sum = 0;
-    unsigned bb_offset[meta_data_batch_size];
-    for (unsigned i = 0; i < meta_data_batch_size; i++)
-    {
-        bb_offset[i] = sum;
-        sum += meta_data.second->get_bb_labels_batch()[i].size();
-    }
-    // copy labels buffer & bboxes buffer parallely
-    #pragma omp parallel for
-    for (unsigned i = 0; i < meta_data_batch_size; i++)
-    {
-        unsigned bb_count = meta_data.second->get_bb_labels_batch()[i].size();
-        int *temp_labels_buf = labels_buf + bb_offset[i];
-        float *temp_bbox_buf = boxes_buf + (bb_offset[i] * 4);
-        memcpy(temp_labels_buf, meta_data.second->get_bb_labels_batch()[i].data(), sizeof(int) * bb_count);
-        memcpy(temp_bbox_buf, meta_data.second->get_bb_cords_batch()[i].data(), sizeof(BoundingBoxCord) * bb_count);
-    }
+    // The encoder writes anchor count boxes and labels per sample to the ring buffer, they are copied in one go
+    context->master_graph->copy_bbox_encoded_buffers(boxes_buf, labels_buf);
 }
 
 void
@@ -518,3 +560,115 @@ ROCAL_API_CALL rocalGetJointsDataPtr(RocalContext p_context, RocalJointsData **j
     *joints_data = (RocalJointsData *)(&(meta_data.second->get_joints_data_batch()));
 }
 
+void
+ROCAL_API_CALL rocalHeatmapTargets(RocalContext p_context, unsigned heatmap_width, unsigned heatmap_height, float sigma)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalHeatmapTargets")
+    auto context = static_cast<Context *>(p_context);
+    context->master_graph->heatmap_targets(heatmap_width, heatmap_height, sigma);
+}
+
+void
+ROCAL_API_CALL rocalGetHeatmapTargets(RocalContext p_context, float **heatmaps_ptr, float **target_weights_ptr)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetHeatmapTargets")
+    auto context = static_cast<Context *>(p_context);
+    context->master_graph->get_heatmap_targets(heatmaps_ptr, target_weights_ptr);
+}
+
+void
+ROCAL_API_CALL rocalCopyHeatmapTargets(RocalContext p_context, float *heatmaps, float *target_weights)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalCopyHeatmapTargets")
+    auto context = static_cast<Context *>(p_context);
+    context->master_graph->copy_heatmap_targets(heatmaps, target_weights);
+}
+
+void
+ROCAL_API_CALL rocalGetHeatmapTargetsSize(RocalContext p_context, size_t *heatmaps_size, size_t *target_weights_size)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetHeatmapTargetsSize")
+    auto context = static_cast<Context *>(p_context);
+    context->master_graph->heatmap_targets_size(heatmaps_size, target_weights_size);
+}
+
+void
+ROCAL_API_CALL rocalLabelEncoder(RocalContext p_context, unsigned num_classes, float on_value, float off_value, float mixup_alpha, float cutmix_alpha, float mix_probability)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalLabelEncoder")
+    auto context = static_cast<Context *>(p_context);
+    context->master_graph->label_encoder(num_classes, on_value, off_value, mixup_alpha, cutmix_alpha, mix_probability);
+}
+
+void
+ROCAL_API_CALL rocalGetEncodedLabels(RocalContext p_context, float **targets_ptr, float **mix_params_ptr)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetEncodedLabels")
+    auto context = static_cast<Context *>(p_context);
+    context->master_graph->get_encoded_labels(targets_ptr, mix_params_ptr);
+}
+
+void
+ROCAL_API_CALL rocalCopyEncodedLabels(RocalContext p_context, void *targets, float *mix_params, int dest)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalCopyEncodedLabels")
+    auto context = static_cast<Context *>(p_context);
+    context->master_graph->copy_encoded_labels(targets, mix_params, dest != 0);
+}
+
+unsigned
+ROCAL_API_CALL rocalGetMetaDataFieldCount(RocalContext p_context)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetMetaDataFieldCount")
+    auto context = static_cast<Context *>(p_context);
+    auto meta_data = context->master_graph->meta_data();
+    if (!meta_data.second)
+        return 0;
+    return meta_data.second->get_fields().columns.size();
+}
+
+static const MetaDataField &meta_data_field(Context *context, unsigned field)
+{
+    auto meta_data = context->master_graph->meta_data();
+    if (!meta_data.second)
+        THROW("No meta data has been loaded for this output image")
+    auto &columns = meta_data.second->get_fields().columns;
+    if (field >= columns.size())
+        THROW("Meta data field " + TOSTR(field) + " out of range, the batch has " + TOSTR(columns.size()))
+    return columns[field];
+}
+
+void
+ROCAL_API_CALL rocalGetMetaDataFieldInfo(RocalContext p_context, unsigned field, RocalMetaDataFieldInfo *info)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetMetaDataFieldInfo")
+    auto context = static_cast<Context *>(p_context);
+    auto &column = meta_data_field(context, field);
+    info->name = column.name.c_str();
+    info->type = static_cast<RocalMetaDataFieldType>(column.type);
+    info->width = column.width;
+    info->value_count = column.value_count();
+}
+
+void
+ROCAL_API_CALL rocalGetMetaDataField(RocalContext p_context, unsigned field, void *values, int *counts)
+{
+    if (!p_context)
+        THROW("Invalid rocal context passed to rocalGetMetaDataField")
+    auto context = static_cast<Context *>(p_context);
+    auto &column = meta_data_field(context, field);
+    if (values && !column.data.empty())
+        memcpy(values, column.data.data(), column.data.size());
+    if (counts)
+        for (size_t i = 0; i < column.sample_count(); i++)
+            counts[i] = column.count(i);
+}
@@ -23,10 +23,13 @@ THE SOFTWARE.
 #include <stdio.h>
 #include <commons.h>
 #include "ffmpeg_video_decoder.h"
+#include "video_keyframe_index.h"
 
 #ifdef ROCAL_VIDEO
 FFmpegVideoDecoder::FFmpegVideoDecoder(){};
 
+FFmpegVideoDecoder::FFmpegVideoDecoder(unsigned decoder_threads) : _decoder_threads(decoder_threads) {};
+
 int FFmpegVideoDecoder::seek_frame(AVRational avg_frame_rate, AVRational time_base, unsigned frame_number)
 {
     auto seek_time = av_rescale_q((int64_t)frame_number, av_inv_q(avg_frame_rate), AV_TIME_BASE_Q);
@@ -40,107 +43,151 @@ int FFmpegVideoDecoder::seek_frame(AVRational avg_frame_rate, AVRational time_ba
     return select_frame_pts;
 }
 
+bool FFmpegVideoDecoder::can_continue_to(unsigned seek_frame_number)
+{
+    if (!_position_valid || seek_frame_number < _next_frame_number)
+        return false;
+    if (_keyframes.empty())
+        return seek_frame_number == _next_frame_number;
+    // A seek would restart decoding at the last keyframe before seek_frame_number, decoding forward is not more expensive
+    // as long as that keyframe is not ahead of the current position
+    auto next_keyframe = std::upper_bound(_keyframes.begin(), _keyframes.end(), seek_frame_number);
+    if (next_keyframe == _keyframes.begin())
+        return true;
+    return *(next_keyframe - 1) <= _next_frame_number;
+}
+
 // Seeks to the frame_number in the video file and decodes each frame in the sequence.
+// The seek is skipped if the sequence starts in the same GOP ahead of the frames decoded by the previous call.
 VideoDecoder::Status FFmpegVideoDecoder::Decode(unsigned char *out_buffer, unsigned seek_frame_number, size_t sequence_length, size_t stride, int out_width, int out_height, int out_stride, AVPixelFormat out_pix_format)
 {
     VideoDecoder::Status status = Status::OK;
 
-    // Initialize the SwsContext
-    SwsContext *swsctx = nullptr;
-    if ((out_width != _codec_width) || (out_height != _codec_height) || (out_pix_format != _dec_pix_fmt))
+    // Get the SwsContext, it is reused as long as the output size and format stay the same
+    bool scale_frames = (out_width != _codec_width) || (out_height != _codec_height) || (out_pix_format != _dec_pix_fmt);
+    if (scale_frames)
     {
-        swsctx = sws_getCachedContext(nullptr, _codec_width, _codec_height, _dec_pix_fmt,
-                                      out_width, out_height, out_pix_format, SWS_BILINEAR, nullptr, nullptr, nullptr);
-        if (!swsctx)
+        _sws_ctx = sws_getCachedContext(_sws_ctx, _codec_width, _codec_height, _dec_pix_fmt,
+                                        out_width, out_height, out_pix_format, SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (!_sws_ctx)
         {
             ERR("Fail to get sws_getCachedContext");
             return Status::FAILED;
         }
     }
-    int select_frame_pts = seek_frame(_video_stream->avg_frame_rate, _video_stream->time_base, seek_frame_number);
-    if (select_frame_pts < 0)
+    int64_t select_frame_pts = av_rescale_q((int64_t)seek_frame_number, av_inv_q(_video_stream->avg_frame_rate), _video_stream->time_base);
+    if (!can_continue_to(seek_frame_number))
     {
-        ERR("Error in seeking frame..Unable to seek the given frame in a video");
-        return Status::FAILED;
+        avcodec_flush_buffers(_video_dec_ctx);
+        if (seek_frame(_video_stream->avg_frame_rate, _video_stream->time_base, seek_frame_number) < 0)
+        {
+            _position_valid = false;
+            ERR("Error in seeking frame..Unable to seek the given frame in a video");
+            return Status::FAILED;
+        }
     }
+    _position_valid = false;
     unsigned frame_count = 0;
+    const unsigned frames_to_decode = sequence_length * stride;
     bool end_of_stream = false;
-    bool sequence_filled = false;
     uint8_t *dst_data[4] = {0};
     int dst_linesize[4] = {0};
     int image_size = out_height * out_stride * sizeof(unsigned char);
-    AVPacket pkt;
-    AVFrame *dec_frame = av_frame_alloc();
-    if (!dec_frame)
-    {
-        ERR("Could not allocate dec_frame");
-        return Status::NO_MEMORY;
-    }
-    do
+    while (frame_count < frames_to_decode)
     {
-        int ret;
-        // read packet from input file
-        ret = av_read_frame(_fmt_ctx, &pkt);
-        if (ret < 0 && ret != AVERROR_EOF)
+        // get the next available frame from the decoder, packets are only read when the decoder needs more input
+        int ret = avcodec_receive_frame(_video_dec_ctx, _dec_frame);
+        if (ret == AVERROR(EAGAIN))
         {
-            ERR("Fail to av_read_frame: ret=" + TOSTR(ret));
-            status = Status::FAILED;
-            break;
-        }
-        if (ret == 0 && pkt.stream_index != _video_stream_idx) continue;
-        end_of_stream = (ret == AVERROR_EOF);
-        if (end_of_stream)
-        {
-            // null packet for bumping process
-            pkt.data = nullptr;
-            pkt.size = 0;
+            // read packet from input file
+            ret = av_read_frame(_fmt_ctx, _pkt);
+            if (ret < 0 && ret != AVERROR_EOF)
+            {
+                ERR("Fail to av_read_frame: ret=" + TOSTR(ret));
+                status = Status::FAILED;
+                break;
+            }
+            if (ret == 0 && _pkt->stream_index != _video_stream_idx)
+            {
+                av_packet_unref(_pkt);
+                continue;
+            }
+            end_of_stream = (ret == AVERROR_EOF);
+            // submit the packet to the decoder, a null packet starts the bumping process at the end of the stream
+            ret = avcodec_send_packet(_video_dec_ctx, end_of_stream ? nullptr : _pkt);
+            av_packet_unref(_pkt);
+            if (ret < 0)
+            {
+                ERR("Error while sending packet to the decoder\n");
+                status = Status::FAILED;
+                break;
+            }
+            continue;
         }
-
-        // submit the packet to the decoder
-        ret = avcodec_send_packet(_video_dec_ctx, &pkt);
+        if (ret == AVERROR_EOF) break;
         if (ret < 0)
         {
-            ERR("Error while sending packet to the decoder\n");
+            ERR("Error while receiving frame from the decoder");
             status = Status::FAILED;
             break;
         }
-
-        // get all the available frames from the decoder
-        while (ret >= 0)
+        if (_dec_frame->pts < select_frame_pts)
         {
-            ret = avcodec_receive_frame(_video_dec_ctx, dec_frame);
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) break;
-            if ((dec_frame->pts < select_frame_pts) || (ret < 0)) continue;
-            if (frame_count % stride == 0)
-            {
-                dst_data[0] = out_buffer;
-                dst_linesize[0] = out_stride;
-                if (swsctx)
-                    sws_scale(swsctx, dec_frame->data, dec_frame->linesize, 0, dec_frame->height, dst_data, dst_linesize);
-                else
-                {
-                    // copy from frame to out_buffer
-                    memcpy(out_buffer, dec_frame->data[0], dec_frame->linesize[0] * out_height);
-                }
-                out_buffer = out_buffer + image_size;
-            }
-            ++frame_count;
-            av_frame_unref(dec_frame);
-            if (frame_count == sequence_length * stride)
+            av_frame_unref(_dec_frame);
+            continue;
+        }
+        if (frame_count % stride == 0)
+        {
+            dst_data[0] = out_buffer;
+            dst_linesize[0] = out_stride;
+            if (scale_frames)
+                sws_scale(_sws_ctx, _dec_frame->data, _dec_frame->linesize, 0, _dec_frame->height, dst_data, dst_linesize);
+            else
             {
-                sequence_filled = true;
-                break;
+                // copy from frame to out_buffer
+                memcpy(out_buffer, _dec_frame->data[0], _dec_frame->linesize[0] * out_height);
             }
+            out_buffer = out_buffer + image_size;
         }
-        av_packet_unref(&pkt);
-        if (sequence_filled)  break;
-    } while (!end_of_stream);
-    avcodec_flush_buffers(_video_dec_ctx);
-    av_frame_free(&dec_frame);
-    sws_freeContext(swsctx);
+        ++frame_count;
+        av_frame_unref(_dec_frame);
+    }
+    // The decoder state can only be reused by the next call if the sequence is completely filled before the end of the stream
+    if (status == Status::OK && frame_count == frames_to_decode && !end_of_stream)
+    {
+        _next_frame_number = seek_frame_number + frames_to_decode;
+        _position_valid = true;
+    }
     return status;
 }
 
+std::vector<unsigned> FFmpegVideoDecoder::scan_keyframes()
+{
+    std::vector<unsigned> keyframes;
+    if (!_video_stream->avg_frame_rate.num)
+        return keyframes;
+    AVPacket *pkt = av_packet_alloc();
+    if (!pkt)
+        return keyframes;
+    while (av_read_frame(_fmt_ctx, pkt) >= 0)
+    {
+        if (pkt->stream_index == _video_stream_idx && (pkt->flags & AV_PKT_FLAG_KEY))
+        {
+            int64_t timestamp = (pkt->pts != AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
+            if (timestamp != AV_NOPTS_VALUE && timestamp >= 0)
+                keyframes.push_back(av_rescale_q(timestamp, _video_stream->time_base, av_inv_q(_video_stream->avg_frame_rate)));
+        }
+        av_packet_unref(pkt);
+    }
+    av_packet_free(&pkt);
+    // Rewind to the start of the stream for decoding
+    if (av_seek_frame(_fmt_ctx, -1, 0, AVSEEK_FLAG_BACKWARD) < 0)
+        WRN("Could not rewind " + STR(_src_filename) + " after scanning the keyframes")
+    std::sort(keyframes.begin(), keyframes.end());
+    keyframes.erase(std::unique(keyframes.begin(), keyframes.end()), keyframes.end());
+    return keyframes;
+}
+
 // Initialize will open a new decoder and initialize the context
 VideoDecoder::Status FFmpegVideoDecoder::Initialize(const char *src_filename)
 {
@@ -202,6 +249,13 @@ VideoDecoder::Status FFmpegVideoDecoder::Initialize(const char *src_filename)
         return Status::FAILED;
     }
 
+    // Let FFmpeg decode with frame and slice threading when more than one thread is given
+    if (_decoder_threads > 1)
+    {
+        _video_dec_ctx->thread_count = _decoder_threads;
+        _video_dec_ctx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+
     // Init the decoders
     if ((ret = avcodec_open2(_video_dec_ctx, _decoder, &opts)) < 0)
     {
@@ -212,6 +266,19 @@ VideoDecoder::Status FFmpegVideoDecoder::Initialize(const char *src_filename)
     _dec_pix_fmt = _video_dec_ctx->pix_fmt;
     _codec_width = _video_stream->codecpar->width;
     _codec_height = _video_stream->codecpar->height;
+    // The keyframe index is built once per video and shared with the other decoders opening it
+    _keyframes = VideoKeyframeIndex::instance()->get(STR(src_filename), [this]() {
+        auto keyframes = find_keyframes(_video_stream);
+        return keyframes.empty() ? scan_keyframes() : keyframes;
+    });
+    _dec_frame = av_frame_alloc();
+    _pkt = av_packet_alloc();
+    if (!_dec_frame || !_pkt)
+    {
+        ERR("Could not allocate the decode frame and packet");
+        return Status::NO_MEMORY;
+    }
+    _position_valid = false;
     return status;
 }
 
@@ -221,6 +288,16 @@ void FFmpegVideoDecoder::release()
         avcodec_free_context(&_video_dec_ctx);
     if (_fmt_ctx)
         avformat_close_input(&_fmt_ctx);
+    if (_dec_frame)
+        av_frame_free(&_dec_frame);
+    if (_pkt)
+        av_packet_free(&_pkt);
+    if (_sws_ctx)
+    {
+        sws_freeContext(_sws_ctx);
+        _sws_ctx = NULL;
+    }
+    _position_valid = false;
 }
 
 FFmpegVideoDecoder::~FFmpegVideoDecoder()
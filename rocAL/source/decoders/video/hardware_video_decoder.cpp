@@ -265,6 +265,7 @@ VideoDecoder::Status HardWareVideoDecoder::Initialize(const char *src_filename)
     }
     _codec_width = _video_stream->codecpar->width;
     _codec_height = _video_stream->codecpar->height;
+    _keyframes = find_keyframes(_video_stream);
     return status;
 }
 
@@ -31,7 +31,7 @@ std::shared_ptr<VideoDecoder> create_video_decoder(VideoDecoderConfig config)
     switch (config.type())
     {
         case VideoDecoderType::FFMPEG_SOFTWARE_DECODE:
-            return std::make_shared<FFmpegVideoDecoder>();
+            return std::make_shared<FFmpegVideoDecoder>(config.get_decoder_threads());
         case VideoDecoderType::FFMPEG_HARDWARE_DECODE:
             return std::make_shared<HardWareVideoDecoder>();
         default:
@@ -0,0 +1,134 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <fstream>
+#include "video_keyframe_index.h"
+#include "sample_info_cache.h"
+
+VideoKeyframeIndex* VideoKeyframeIndex::instance()
+{
+    static VideoKeyframeIndex* index = new VideoKeyframeIndex();
+    return index;
+}
+
+std::vector<unsigned> VideoKeyframeIndex::get(const std::string &video_path, const std::function<std::vector<unsigned>()> &build_index)
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto it = _indices.find(video_path);
+        if(it != _indices.end())
+            return it->second;
+    }
+    // Building the index may take a while for long videos, it is done without holding the lock
+    std::vector<unsigned> keyframes;
+    if(!load(video_path, keyframes))
+    {
+        keyframes = build_index();
+        save(video_path, keyframes);
+    }
+    std::lock_guard<std::mutex> lock(_lock);
+    _indices.insert(std::make_pair(video_path, keyframes));
+    return keyframes;
+}
+
+void VideoKeyframeIndex::set(const std::string &video_path, const std::vector<unsigned> &keyframes)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _indices[video_path] = keyframes;
+}
+
+bool VideoKeyframeIndex::find(const std::string &video_path, std::vector<unsigned> &keyframes)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    auto it = _indices.find(video_path);
+    if(it == _indices.end())
+        return false;
+    keyframes = it->second;
+    return true;
+}
+
+std::string VideoKeyframeIndex::cache_file_path(const std::string &video_path)
+{
+    auto cache_dir = SampleInfoCache::instance()->get_cache_dir();
+    if(cache_dir.empty())
+        return "";
+    auto canonical_path = filesys::weakly_canonical(filesys::path(video_path)).string();
+    return (filesys::path(cache_dir) / ("rocal_keyframes_" + std::to_string(std::hash<std::string>{}(canonical_path)) + ".txt")).string();
+}
+
+std::string VideoKeyframeIndex::video_signature(const std::string &video_path)
+{
+    std::error_code err;
+    auto file_size = filesys::file_size(video_path, err);
+    auto write_time = filesys::last_write_time(video_path, err).time_since_epoch().count();
+    return "# " + video_path + " " + std::to_string(file_size) + " " + std::to_string(write_time);
+}
+
+bool VideoKeyframeIndex::load(const std::string &video_path, std::vector<unsigned> &keyframes)
+{
+    auto cache_file = cache_file_path(video_path);
+    if(cache_file.empty() || !filesys::exists(cache_file))
+        return false;
+    std::ifstream in(cache_file);
+    std::string line;
+    // The index is rebuilt if the video is modified after the index is persisted
+    if(!std::getline(in, line) || line != video_signature(video_path))
+        return false;
+    keyframes.clear();
+    try
+    {
+        while(std::getline(in, line))
+            if(!line.empty())
+                keyframes.push_back(std::stoul(line));
+    }
+    catch(const std::exception &e)
+    {
+        // A corrupted index file is handled as a stale one, the index is rebuilt and the file rewritten
+        WRN("Ignoring the corrupted keyframe index file " + cache_file + " : " + e.what())
+        keyframes.clear();
+        return false;
+    }
+    return true;
+}
+
+void VideoKeyframeIndex::save(const std::string &video_path, const std::vector<unsigned> &keyframes)
+{
+    auto cache_file = cache_file_path(video_path);
+    if(cache_file.empty())
+        return;
+    auto tmp_file = cache_file + ".tmp";
+    {
+        std::ofstream out(tmp_file, std::ios::trunc);
+        if(!out)
+        {
+            WRN("Could not write the keyframe index file " + tmp_file)
+            return;
+        }
+        out << video_signature(video_path) << "\n";
+        for(auto keyframe: keyframes)
+            out << keyframe << "\n";
+    }
+    std::error_code err;
+    filesys::rename(tmp_file, cache_file, err);
+    if(err)
+        WRN("Could not write the keyframe index file " + cache_file + " : " + err.message())
+}
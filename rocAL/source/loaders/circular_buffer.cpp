@@ -22,6 +22,7 @@ THE SOFTWARE.
 
 #include "circular_buffer.h"
 #include "log.h"
+#include "trace_recorder.h"
 
 CircularBuffer::CircularBuffer(void* devres):
           _write_ptr(0),
@@ -56,6 +57,7 @@ void CircularBuffer::unblock_reader()
     if(!_initialized)
         return;
     // Wake up the reader thread in case it's waiting for a load
+    TraceRecorder::instance()->instant("Circular buffer unblock reader");
     _wait_for_load.notify_one();
 }
 
@@ -64,6 +66,7 @@ void CircularBuffer::unblock_writer()
     if(!_initialized)
         return;
     // Wake up the writer thread in case it's waiting for an unload
+    TraceRecorder::instance()->instant("Circular buffer unblock writer");
     _wait_for_unload.notify_one();
 }
 
@@ -169,6 +172,7 @@ void CircularBuffer::pop()
 void CircularBuffer::init(RocalMemType output_mem_type, size_t output_mem_size, size_t buffer_depth)
 {
     _buff_depth = buffer_depth;
+    _active_depth = buffer_depth;
     _dev_buffer.reserve(_buff_depth);
     _host_buffer_ptrs.reserve(_buff_depth);
     for(size_t bufIdx = 0; bufIdx < _buff_depth; bufIdx++)
@@ -326,7 +330,16 @@ bool CircularBuffer::empty()
 
 bool CircularBuffer::full()
 {
-    return (_level >= _buff_depth - 1);
+    return (_level >= _active_depth - 1);
+}
+
+void CircularBuffer::set_active_depth(size_t buffer_depth)
+{
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _active_depth = std::min(std::max<size_t>(buffer_depth, 2), _buff_depth);
+    }
+    _wait_for_unload.notify_all();
 }
 
 size_t CircularBuffer::level()
@@ -360,6 +373,7 @@ void CircularBuffer::block_if_empty()
     std::unique_lock<std::mutex> lock(_lock);
     if(empty())
     { // if the current read buffer is being written wait on it
+        TraceScope trace("Circular buffer empty");
         _wait_for_load.wait(lock);
     }
 }
@@ -370,6 +384,7 @@ void CircularBuffer:: block_if_full()
     // Write the whole buffer except for the last spot which is being read by the reader thread
     if(full())
     {
+        TraceScope trace("Circular buffer full");
         _wait_for_unload.wait(lock);
     }
 }
@@ -0,0 +1,164 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <pthread.h>
+#include "decode_scheduler.h"
+#include "cpu_topology.h"
+#include "trace_recorder.h"
+
+DecodeScheduler* DecodeScheduler::instance()
+{
+    // Never destroyed, the loader threads of pipelines not released at exit may still submit work
+    static DecodeScheduler* scheduler = new DecodeScheduler();
+    return scheduler;
+}
+
+DecodeScheduler::DecodeScheduler()
+{
+    _thread_budget = CpuTopology::instance()->physical_core_count();
+}
+
+std::shared_ptr<DecodeClient> DecodeScheduler::create_client(unsigned weight)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _client_count++;
+    return std::shared_ptr<DecodeClient>(new DecodeClient(weight), [this](DecodeClient *client)
+    {
+        delete client;
+        release_client();
+    });
+}
+
+void DecodeScheduler::release_client()
+{
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if(--_client_count > 0)
+            return;
+        // No client is left to submit work, the threads are started again on the next submitted work
+        _generation++;
+        workers.swap(_workers);
+        _work_cv.notify_all();
+    }
+    for(auto &worker : workers)
+        worker.join();
+}
+
+void DecodeScheduler::set_thread_budget(size_t thread_count)
+{
+    if(thread_count == 0)
+        THROW("Decode thread budget should be at least one")
+    std::lock_guard<std::mutex> lock(_lock);
+    _thread_budget = thread_count;
+    // Workers above the budget stay idle, missing ones are started on the next submitted work
+    _work_cv.notify_all();
+}
+
+size_t DecodeScheduler::thread_budget()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _thread_budget;
+}
+
+void DecodeScheduler::parallel_for(const std::shared_ptr<DecodeClient> &client, size_t count, size_t max_parallelism,
+                                   const std::function<void(size_t)> &task, int node)
+{
+    if(count == 0)
+        return;
+    Job job;
+    job.client = client.get();
+    job.task = &task;
+    job.count = count;
+    job.max_parallelism = std::max<size_t>(max_parallelism, 1);
+    job.node = node;
+    std::unique_lock<std::mutex> lock(_lock);
+    while(_workers.size() < _thread_budget)
+        _workers.emplace_back(&DecodeScheduler::worker_routine, this, _workers.size(), _generation);
+    // A client which was idle does not get to catch up on the time it was not using its share
+    job.client->_virtual_time = std::max(job.client->_virtual_time, _virtual_clock);
+    _jobs.push_back(&job);
+    _work_cv.notify_all();
+    _done_cv.wait(lock, [&job] { return job.done == job.count; });
+    _jobs.remove(&job);
+    if(job.error)
+        std::rethrow_exception(job.error);
+}
+
+DecodeScheduler::Job *DecodeScheduler::pick_job()
+{
+    Job *picked = nullptr;
+    for(auto job : _jobs)
+    {
+        if(job->next == job->count || job->running == job->max_parallelism)
+            continue;
+        if(!picked || job->client->_virtual_time < picked->client->_virtual_time)
+            picked = job;
+    }
+    return picked;
+}
+
+void DecodeScheduler::worker_routine(size_t worker_idx, size_t generation)
+{
+    int pinned_node = -1;
+    cpu_set_t default_mask;
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &default_mask);
+    TraceRecorder::instance()->set_thread_name("Decode worker " + TOSTR(worker_idx));
+    std::unique_lock<std::mutex> lock(_lock);
+    while(true)
+    {
+        Job *job = nullptr;
+        _work_cv.wait(lock, [&] { return generation != _generation || (worker_idx < _thread_budget && (job = pick_job()) != nullptr); });
+        if(generation != _generation)
+            return;
+        size_t idx = job->next++;
+        job->running++;
+        job->client->_virtual_time += 1.0 / job->client->_weight;
+        _virtual_clock = job->client->_virtual_time;
+        lock.unlock();
+        // Tasks of a shard placed on a NUMA node run on that node, next to the buffers they write to
+        if(job->node != pinned_node)
+        {
+            cpu_set_t mask = (job->node < 0) ? default_mask : CpuTopology::instance()->node_cpu_set(job->node);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
+            pinned_node = job->node;
+        }
+        std::exception_ptr error = nullptr;
+        try
+        {
+            (*job->task)(idx);
+        }
+        catch(...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+        if(error && !job->error)
+            job->error = error;
+        job->running--;
+        if(++job->done == job->count)
+            _done_cv.notify_all();
+        else if(job->next < job->count)
+            _work_cv.notify_one();
+    }
+}
@@ -24,6 +24,8 @@ THE SOFTWARE.
 #include <chrono>
 #include "image_loader.h"
 #include "image_read_and_decode.h"
+#include "cpu_topology.h"
+#include "prefetch_tuner.h"
 #include "vx_ext_amd.h"
 
 ImageLoader::ImageLoader(void *dev_resources):
@@ -139,11 +141,16 @@ void ImageLoader::initialize(ReaderConfig reader_cfg, DecoderConfig decoder_cfg,
     if (_output_mem_size == 0)
         THROW("output image size is 0, set_output_image() should be called before initialize for loader modules")
 
+    _shard_id = reader_cfg.get_shard_id();
+    // The decoder buffers and the circular buffer are allocated and first touched on the shard's node
+    ScopedNodePlacement node_placement(_cpu_placement, _shard_id);
     _mem_type = mem_type;
     _batch_size = batch_size;
     _loop = reader_cfg.loop();
     _decoder_keep_original = decoder_keep_original;
     _image_loader = std::make_shared<ImageReadAndDecode>();
+    _image_loader->set_decode_client(_decode_client, (_cpu_placement == CpuPlacement::NUMA) ? (int)CpuTopology::instance()->shard_node(_shard_id) : -1);
+    _image_loader->enable_stats(_stats_enabled);
     size_t shard_count = reader_cfg.get_shard_count();
     int device_id = reader_cfg.get_shard_id();
     try
@@ -165,7 +172,12 @@ void ImageLoader::initialize(ReaderConfig reader_cfg, DecoderConfig decoder_cfg,
     _decoded_img_info._original_height.resize(_batch_size);
     _decoded_img_info._original_width.resize(_batch_size);
     _crop_image_info._crop_image_coords.resize(_batch_size);
-    _circ_buff.init(_mem_type, _output_mem_size,_prefetch_queue_depth );
+    // With a memory budget the circular buffer is allocated deeper than the prefetch depth, so the depth can be raised without reallocating it
+    size_t buffer_depth = _prefetch_queue_depth;
+    if (_prefetch_memory_budget > 0)
+        buffer_depth = PrefetchTuner::depth_within_budget(_prefetch_memory_budget, _output_mem_size, _prefetch_queue_depth);
+    _circ_buff.init(_mem_type, _output_mem_size, buffer_depth);
+    _circ_buff.set_active_depth(_prefetch_queue_depth);
     _is_initialized = true;
     _image_loader->set_random_bbox_data_reader(_randombboxcrop_meta_data_reader);
     LOG("Loader module initialized");
@@ -185,11 +197,15 @@ LoaderModuleStatus
 ImageLoader::load_routine()
 {
     LOG("Started the internal loader thread");
+    // The loader thread reads the shard's samples on the shard's node, its decode tasks are placed by the decode scheduler
+    ScopedNodePlacement node_placement(_cpu_placement, _shard_id);
+    TraceRecorder::instance()->set_thread_name("Image loader shard " + TOSTR(_shard_id));
     LoaderModuleStatus last_load_status = LoaderModuleStatus::OK;
     // Initially record number of all the images that are going to be loaded, this is used to know how many still there
 
     while (_internal_thread_running)
     {
+        TraceRecorder::set_thread_batch(_image_counter / _batch_size);
         auto data = _circ_buff.get_write_buffer();
         if (!_internal_thread_running)
             break;
@@ -214,6 +230,7 @@ ImageLoader::load_routine()
                     _crop_image_info._crop_image_coords = _image_loader->get_batch_random_bbox_crop_coords();
                     _circ_buff.set_crop_image_info(_crop_image_info);
                 }
+                _decoded_img_info._sample_keys = _image_loader->sample_keys();
                 _circ_buff.set_image_info(_decoded_img_info);
                 _circ_buff.push();
                 _image_counter += _output_image->info().batch_size();
@@ -282,6 +299,10 @@ ImageLoader::update_output_image()
     if (_stopped)
         return LoaderModuleStatus::OK;
 
+    if (_stats_enabled.load(std::memory_order_relaxed)) {
+        _buffer_level_sum += _circ_buff.level();
+        _buffer_level_samples++;
+    }
     _output_decoded_img_info = _circ_buff.get_image_info();
     if (_randombboxcrop_meta_data_reader) {
       _output_cropped_img_info = _circ_buff.get_cropped_image_info();
@@ -296,6 +317,34 @@ ImageLoader::update_output_image()
     return status;
 }
 
+void ImageLoader::enable_stats(bool enable)
+{
+    _stats_enabled = enable;
+    if (_image_loader)
+        _image_loader->enable_stats(enable);
+}
+
+void ImageLoader::set_decode_parallelism(size_t thread_count)
+{
+    if (_image_loader)
+        _image_loader->set_decode_parallelism(thread_count);
+}
+
+size_t ImageLoader::decode_parallelism()
+{
+    return _image_loader ? _image_loader->decode_parallelism() : 0;
+}
+
+LoaderStats ImageLoader::stats()
+{
+    LoaderStats s = _image_loader ? _image_loader->stats() : LoaderStats();
+    s.buffer_level = _circ_buff.level();
+    s.buffer_depth = _circ_buff.active_depth();
+    auto samples = _buffer_level_samples.load();
+    s.mean_buffer_level = samples ? static_cast<double>(_buffer_level_sum.load()) / samples : 0;
+    return s;
+}
+
 Timing ImageLoader::timing()
 {
     auto t = _image_loader->timing();
@@ -93,6 +93,10 @@ ImageLoaderSharded::initialize(ReaderConfig reader_cfg, DecoderConfig decoder_cf
     {
         std::shared_ptr loader = std::make_shared<ImageLoader>(_dev_resources);
         loader->set_prefetch_queue_depth(_prefetch_queue_depth);
+        loader->set_cpu_placement(_cpu_placement);
+        loader->set_decode_client(_decode_client);
+        loader->enable_stats(_stats_enabled);
+        loader->set_prefetch_memory_budget(_prefetch_memory_budget / _shard_count);
         _loaders.push_back(loader);
     }
     // Initialize loader modules
@@ -120,14 +124,7 @@ void ImageLoaderSharded::start_loading()
         params.sched_priority = sched_get_priority_max(SCHED_FIFO);
         _loaders[i]->set_cpu_sched_policy(params);
 #endif
-        // Setting cpu affinity for threads works and can be activated below for experimentation
-#if 0
-        // Set thread affinity thread 0 to core 0 , 1 toc core 1 , ...
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
-        CPU_SET(i, &cpuset);
-        _loaders[i]->set_cpu_affinity(cpuset);
-#endif
+        // CPU affinity of the loader threads is set through set_cpu_placement(), each loader pins itself on its shard's node
     }
 
 }
@@ -138,6 +135,15 @@ void ImageLoaderSharded::shut_down()
         _loaders[i]->shut_down();
 }
 
+std::vector<unsigned> ImageLoaderSharded::get_shard_ids()
+{
+    std::vector<unsigned> shard_ids;
+    for(auto &loader : _loaders)
+        for(auto shard_id : loader->get_shard_ids())
+            shard_ids.push_back(shard_id);
+    return shard_ids;
+}
+
 
 void ImageLoaderSharded::set_output_image (Image* output_image)
 {
@@ -166,6 +172,47 @@ void ImageLoaderSharded::increment_loader_idx()
     _loader_idx = (_loader_idx + 1)%_shard_count;
 }
 
+void ImageLoaderSharded::enable_stats(bool enable)
+{
+    _stats_enabled = enable;
+    for(auto& loader: _loaders)
+        loader->enable_stats(enable);
+}
+
+void ImageLoaderSharded::set_active_prefetch_depth(size_t depth)
+{
+    for(auto& loader: _loaders)
+        loader->set_active_prefetch_depth(depth);
+}
+
+void ImageLoaderSharded::set_decode_parallelism(size_t thread_count)
+{
+    for(auto& loader: _loaders)
+        loader->set_decode_parallelism(thread_count);
+}
+
+size_t ImageLoaderSharded::decode_parallelism()
+{
+    return _loaders.empty() ? 0 : _loaders[0]->decode_parallelism();
+}
+
+LoaderStats ImageLoaderSharded::stats()
+{
+    LoaderStats s;
+    // The latencies of all the shards are combined in the same histograms, the buffer levels are summed
+    for(auto& loader: _loaders)
+    {
+        auto info = loader->stats();
+        s.read_time.merge(info.read_time);
+        s.decode_time.merge(info.decode_time);
+        s.bytes_read += info.bytes_read;
+        s.buffer_level += info.buffer_level;
+        s.buffer_depth += info.buffer_depth;
+        s.mean_buffer_level += info.mean_buffer_level;
+    }
+    return s;
+}
+
 Timing ImageLoaderSharded::timing()
 {
     Timing t;
@@ -181,6 +228,8 @@ Timing ImageLoaderSharded::timing()
         max_read_time = (info.image_read_time > max_read_time) ?  info.image_read_time : max_read_time;
         max_decode_time = (info.image_decode_time > max_decode_time) ? info.image_decode_time : max_decode_time;
         swap_handle_time += info.image_process_time;
+        t.image_decode_failure_count += info.image_decode_failure_count;
+        t.image_substitution_count += info.image_substitution_count;
     }
     t.image_decode_time = max_decode_time;
     t.image_read_time = max_read_time;
@@ -51,9 +51,28 @@ ImageReadAndDecode::timing()
     Timing t;
     t.image_decode_time = _decode_time.get_timing();
     t.image_read_time = _file_load_time.get_timing();
+    t.image_decode_failure_count = _decode_failure_count;
+    t.image_substitution_count = _substitution_count;
     return t;
 }
 
+void
+ImageReadAndDecode::enable_stats(bool enable)
+{
+    _file_load_time.enable_stats(enable);
+    _decode_time.enable_stats(enable);
+}
+
+LoaderStats
+ImageReadAndDecode::stats()
+{
+    LoaderStats s;
+    s.read_time = _file_load_time.stats();
+    s.decode_time = _decode_time.stats();
+    s.bytes_read = _bytes_read.load();
+    return s;
+}
+
 ImageReadAndDecode::ImageReadAndDecode():
     _file_load_time("FileLoadTime", DBG_TIMING ),
     _decode_time("DecodeTime", DBG_TIMING)
@@ -62,6 +81,8 @@ ImageReadAndDecode::ImageReadAndDecode():
 
 ImageReadAndDecode::~ImageReadAndDecode()
 {
+    if (_sample_info_table)
+        _sample_info_table->save();
     _reader = nullptr;
     _decoder.clear();
 }
@@ -75,15 +96,22 @@ ImageReadAndDecode::create(ReaderConfig reader_config, DecoderConfig decoder_con
     _decoder.resize(batch_size);
     _actual_read_size.resize(batch_size);
     _image_names.resize(batch_size);
+    _sample_keys.resize(batch_size);
     _compressed_image_size.resize(batch_size);
     _decompressed_buff_ptrs.resize(_batch_size);
     _actual_decoded_width.resize(_batch_size);
     _actual_decoded_height.resize(_batch_size);
     _original_height.resize(_batch_size);
     _original_width.resize(_batch_size);
+    _subsampling.resize(_batch_size);
+    _sample_info_found.resize(_batch_size);
+    _crop_windows.resize(_batch_size);
+    _crop_window_ready.resize(_batch_size);
+    _sample_failed.resize(_batch_size);
     _decoder_config = decoder_config;
     _random_crop_dec_param = nullptr;
-    if (_decoder_config._type == DecoderType::FUSED_TURBO_JPEG) {
+    // Without a random area the crop windows are provided by the RandomBBoxCrop reader
+    if (_decoder_config._type == DecoderType::FUSED_TURBO_JPEG && !decoder_config.get_random_area().empty()) {
       auto random_aspect_ratio = decoder_config.get_random_aspect_ratio();
       auto random_area = decoder_config.get_random_area();
       AspectRatioRange aspect_ratio_range = std::make_pair((float)random_aspect_ratio[0], (float)random_aspect_ratio[1]);
@@ -98,7 +126,12 @@ ImageReadAndDecode::create(ReaderConfig reader_config, DecoderConfig decoder_con
         }
     }
     _num_threads = reader_config.get_cpu_num_threads();
+    _decode_parallelism = _num_threads;
+    if (!_decode_client)
+        _decode_client = DecodeScheduler::instance()->create_client();
     _reader = create_reader(reader_config);
+    // All the shards reading the same dataset share the same sample info table
+    _sample_info_table = SampleInfoCache::instance()->get_table(reader_config.path());
 }
 
 void
@@ -106,6 +139,8 @@ ImageReadAndDecode::reset()
 {
     // TODO: Reload images from the folder if needed
     _reader->reset();
+    // Persist the sample info gathered during the last epoch (no op if the cache directory is not set)
+    _sample_info_table->save();
 }
 
 size_t
@@ -114,6 +149,12 @@ ImageReadAndDecode::count()
     return _reader->count_items();
 }
 
+void ImageReadAndDecode::set_decode_client(std::shared_ptr<DecodeClient> decode_client, int node)
+{
+    _decode_client = decode_client;
+    _decode_node = node;
+}
+
 void ImageReadAndDecode::set_random_bbox_data_reader(std::shared_ptr<RandomBBoxCrop_MetaDataReader> randombboxcrop_meta_data_reader)
 {
     _randombboxcrop_meta_data_reader = randombboxcrop_meta_data_reader;
@@ -132,6 +173,144 @@ ImageReadAndDecode::set_batch_random_bbox_crop_coords(std::vector<std::vector<fl
     _crop_coords_batch = crop_coords;
 }
 
+bool
+ImageReadAndDecode::read_sample(size_t idx)
+{
+    while (_reader->count_items() > 0) {
+        size_t fsize = _reader->open();
+        if (fsize == 0) {
+            WRN("Opened file " + _reader->id() + " of size 0");
+            continue;
+        }
+        // Quarantined samples are skipped before their content is read, samples are keyed on their path since
+        // files of different class folders can share a name
+        if (_sample_info_table->is_decode_failed(_reader->path())) {
+            WRN("Skipping " + _reader->id() + " since it is quarantined");
+            _reader->close();
+            continue;
+        }
+        _compressed_buff[idx].reserve(fsize);
+        _actual_read_size[idx] = _reader->read_data(_compressed_buff[idx].data(), fsize);
+        _image_names[idx] = _reader->id();
+        _sample_keys[idx] = _reader->path();
+        _reader->close();
+        _compressed_image_size[idx] = fsize;
+        _sample_failed[idx] = false;
+        SampleInfo sample_info;
+        _sample_info_found[idx] = _sample_info_table->find(_sample_keys[idx], sample_info);
+        _crop_window_ready[idx] = false;
+        if (_sample_info_found[idx]) {
+            _original_width[idx] = sample_info.width;
+            _original_height[idx] = sample_info.height;
+            _subsampling[idx] = sample_info.subsampling;
+            // Dimensions are already known, the crop window can be generated before the sample is decoded
+            if (!_randombboxcrop_meta_data_reader && _random_crop_dec_param) {
+                Shape dec_shape = {_original_height[idx], _original_width[idx]};
+                _crop_windows[idx] = _random_crop_dec_param->generate_crop_window(dec_shape, idx);
+                _crop_window_ready[idx] = true;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+void
+ImageReadAndDecode::record_sample_info(size_t idx, int width, int height, int subsampling)
+{
+    _original_width[idx] = width;
+    _original_height[idx] = height;
+    _subsampling[idx] = subsampling;
+    SampleInfo sample_info;
+    sample_info.width = width;
+    sample_info.height = height;
+    sample_info.subsampling = subsampling;
+    _sample_info_table->insert(_sample_keys[idx], sample_info);
+}
+
+bool
+ImageReadAndDecode::substitute_from_reader(size_t idx)
+{
+    while (read_sample(idx)) {
+        if (_sample_info_found[idx])
+            return true;
+        int original_width, original_height, jpeg_sub_samp;
+        if (_decoder[idx]->decode_info(_compressed_buff[idx].data(), _actual_read_size[idx], &original_width, &original_height,
+                                       &jpeg_sub_samp) == Decoder::Status::OK) {
+            record_sample_info(idx, original_width, original_height, jpeg_sub_samp);
+            return true;
+        }
+        quarantine(idx);
+    }
+    return false;
+}
+
+void
+ImageReadAndDecode::copy_sample(size_t dst, size_t src)
+{
+    _compressed_buff[dst].reserve(_actual_read_size[src]);
+    memcpy(_compressed_buff[dst].data(), _compressed_buff[src].data(), _actual_read_size[src]);
+    _actual_read_size[dst] = _actual_read_size[src];
+    _compressed_image_size[dst] = _compressed_image_size[src];
+    _image_names[dst] = _image_names[src];
+    _sample_keys[dst] = _sample_keys[src];
+    _sample_info_found[dst] = _sample_info_found[src];
+    _sample_failed[dst] = _sample_failed[src];
+    _original_width[dst] = _original_width[src];
+    _original_height[dst] = _original_height[src];
+    _subsampling[dst] = _subsampling[src];
+    _crop_windows[dst] = _crop_windows[src];
+    _crop_window_ready[dst] = _crop_window_ready[src];
+}
+
+size_t
+ImageReadAndDecode::find_valid_sample(size_t idx)
+{
+    for (size_t j = 1; j < _batch_size; j++) {
+        size_t src = (idx + j) % _batch_size;
+        if (!_sample_failed[src])
+            return src;
+    }
+    THROW("All images in the batch failed decoding\n");
+}
+
+void
+ImageReadAndDecode::quarantine(size_t idx)
+{
+    WRN("Quarantining " + _image_names[idx] + " since it failed decoding");
+    _sample_info_table->mark_decode_failed(_sample_keys[idx]);
+    _decode_failure_count++;
+}
+
+bool
+ImageReadAndDecode::decode_sample(size_t idx, size_t max_decoded_width, size_t max_decoded_height,
+                                  Decoder::ColorFormat decoder_color_format, bool keep_original)
+{
+    // initialize the actual decoded height and width with the maximum
+    size_t scaledw = max_decoded_width, scaledh = max_decoded_height;
+    if (_decoder[idx]->is_partial_decoder()) {
+        if (_randombboxcrop_meta_data_reader) {
+            _decoder[idx]->set_bbox_coords(_bbox_coords[idx]);
+        } else if (_random_crop_dec_param) {
+            if (!_crop_window_ready[idx]) {
+                Shape dec_shape = {_original_height[idx], _original_width[idx]};
+                _crop_windows[idx] = _random_crop_dec_param->generate_crop_window(dec_shape, idx);
+                _crop_window_ready[idx] = true;
+            }
+            _decoder[idx]->set_crop_window(_crop_windows[idx]);
+        }
+    }
+    // decode the image and get the actual decoded image width and height
+    auto status = _decoder[idx]->decode(_compressed_buff[idx].data(), _compressed_image_size[idx], _decompressed_buff_ptrs[idx],
+                                        max_decoded_width, max_decoded_height,
+                                        _original_width[idx], _original_height[idx],
+                                        scaledw, scaledh,
+                                        decoder_color_format, _decoder_config, keep_original);
+    _actual_decoded_width[idx] = scaledw;
+    _actual_decoded_height[idx] = scaledh;
+    return status == Decoder::Status::OK;
+}
+
 LoaderModuleStatus
 ImageReadAndDecode::load(unsigned char* buff,
                          std::vector<std::string>& names,
@@ -176,6 +355,7 @@ ImageReadAndDecode::load(unsigned char* buff,
                 LOG("Reader read less than requested bytes of size: " + _actual_read_size[file_counter]);
 
             _image_names[file_counter] = _reader->id();
+            _sample_keys[file_counter] = _reader->path();
             _reader->close();
            // _compressed_image_size[file_counter] = fsize;
             names[file_counter] = _image_names[file_counter];
@@ -188,87 +368,95 @@ ImageReadAndDecode::load(unsigned char* buff,
         //_file_load_time.end();// Debug timing
         //return LoaderModuleStatus::OK;
     } else {
-        while ((file_counter != _batch_size) && _reader->count_items() > 0) {
-            size_t fsize = _reader->open();
-            if (fsize == 0) {
-                WRN("Opened file " + _reader->id() + " of size 0");
-                continue;
-            }
-            _compressed_buff[file_counter].reserve(fsize);
-            _actual_read_size[file_counter] = _reader->read_data(_compressed_buff[file_counter].data(), fsize);
-            _image_names[file_counter] = _reader->id();
-            _reader->close();
-            _compressed_image_size[file_counter] = fsize;
-            file_counter++;
-        }
-        if (_randombboxcrop_meta_data_reader) {
-            //Fetch the crop co-ordinates for a batch of images
-            _bbox_coords = _randombboxcrop_meta_data_reader->get_batch_crop_coords(_image_names);
-            set_batch_random_bbox_crop_coords(_bbox_coords);
-        } else if (_random_crop_dec_param) {
+        if (!_randombboxcrop_meta_data_reader && _random_crop_dec_param)
             _random_crop_dec_param->generate_random_seeds();
+        while ((file_counter != _batch_size) && read_sample(file_counter))
+            file_counter++;
+        if (file_counter == 0) {
+            _file_load_time.end();// Debug timing
+            return LoaderModuleStatus::NO_MORE_DATA_TO_READ;
         }
+        // If samples are skipped at the end of the dataset, the rest of the batch is filled with the samples already loaded
+        for (size_t i = file_counter; i < _batch_size; i++)
+            copy_sample(i, i % file_counter);
     }
 
     _file_load_time.end();// Debug timing
+    long long unsigned batch_bytes = 0;
+    for (size_t i = 0; i < file_counter; i++)
+        batch_bytes += _actual_read_size[i];
+    _bytes_read += batch_bytes;
 
     _decode_time.start();// Debug timing
     if (_decoder_config._type != DecoderType::SKIP_DECODE) {
-        for (size_t i = 0; i < _batch_size; i++)
-            _decompressed_buff_ptrs[i] = buff + image_size * i;
-
-#pragma omp parallel for num_threads(_num_threads)  // default(none) TBD: option disabled in Ubuntu 20.04
-        for (size_t i = 0; i < _batch_size; i++)
+        // The samples are decoded on the process wide decode threads, shared with the other shards and pipelines
+        const int64_t trace_batch = TraceRecorder::thread_batch();
+        const size_t decode_parallelism = _decode_parallelism;
+        DecodeScheduler::instance()->parallel_for(_decode_client, _batch_size, decode_parallelism, [&](size_t i)
         {
-            // initialize the actual decoded height and width with the maximum
-            _actual_decoded_width[i] = max_decoded_width;
-            _actual_decoded_height[i] = max_decoded_height;
+            TraceScope trace("Decode header", trace_batch, i);
+            // Header info of the samples seen in a previous epoch is already known, no need to parse the header again
+            if (_sample_info_found[i])
+                return;
             int original_width, original_height, jpeg_sub_samp;
             if (_decoder[i]->decode_info(_compressed_buff[i].data(), _actual_read_size[i], &original_width, &original_height,
                                          &jpeg_sub_samp) != Decoder::Status::OK) {
-                    // Substituting the image which failed decoding with other image from the same batch
-                    int j = ((i + 1) != _batch_size) ? _batch_size - 1 : _batch_size - 2;
-                    while ((j >= 0)) 
-                    {
-                        if (_decoder[i]->decode_info(_compressed_buff[j].data(), _actual_read_size[j], &original_width, &original_height,
-                            &jpeg_sub_samp) == Decoder::Status::OK) 
-                        {
-                                _image_names[i] =  _image_names[j];
-                                _compressed_buff[i] =  _compressed_buff[j];
-                                _actual_read_size[i] =  _actual_read_size[j];
-                                _compressed_image_size[i] =  _compressed_image_size[j];
-                                break;                                
-
-                        }
-                        else
-                            j--;
-                        if(j < 0) 
-                        {
-                            THROW("All images in the batch failed decoding\n");
-                        }                                    
-                    }
+                _sample_failed[i] = true;
+                return;
             }
-            _original_height[i] = original_height;
-            _original_width[i] = original_width;
-            // decode the image and get the actual decoded image width and height
-            size_t scaledw, scaledh;
-            if (_decoder[i]->is_partial_decoder()) {
-                if (_randombboxcrop_meta_data_reader) {
-                  _decoder[i]->set_bbox_coords(_bbox_coords[i]); 
-                } else if (_random_crop_dec_param) {
-                  Shape dec_shape = {_original_height[i], _original_width[i]};
-                  auto crop_window = _random_crop_dec_param->generate_crop_window(dec_shape, i);
-                  _decoder[i]->set_crop_window(crop_window);
+            record_sample_info(i, original_width, original_height, jpeg_sub_samp);
+        }, _decode_node);
+        // Samples which failed header decode are quarantined and replaced serially with fresh samples from the reader,
+        // so no buffer is ever shared between the decoding threads
+        for (size_t i = 0; i < _batch_size; i++) {
+            if (!_sample_failed[i])
+                continue;
+            quarantine(i);
+            if (!substitute_from_reader(i))
+                copy_sample(i, find_valid_sample(i));
+            _substitution_count++;
+        }
+        if (_randombboxcrop_meta_data_reader) {
+            //Fetch the crop co-ordinates for a batch of images
+            _bbox_coords = _randombboxcrop_meta_data_reader->get_batch_crop_coords(_image_names);
+            set_batch_random_bbox_crop_coords(_bbox_coords);
+        }
+
+        for (size_t i = 0; i < _batch_size; i++)
+            _decompressed_buff_ptrs[i] = buff + image_size * i;
+
+        DecodeScheduler::instance()->parallel_for(_decode_client, _batch_size, decode_parallelism, [&](size_t i)
+        {
+            TraceScope trace("Decode sample", trace_batch, i);
+            if (!decode_sample(i, max_decoded_width, max_decoded_height, decoder_color_format, keep_original))
+                _sample_failed[i] = true;
+        }, _decode_node);
+        // Samples which failed content decode are replaced after the parallel decode is done
+        for (size_t i = 0; i < _batch_size; i++) {
+            if (!_sample_failed[i])
+                continue;
+            quarantine(i);
+            bool substituted = false;
+            // The crop windows of RandomBBoxCrop are generated for the whole batch, a fresh sample would not have one
+            if (!_randombboxcrop_meta_data_reader) {
+                while (!substituted && substitute_from_reader(i)) {
+                    substituted = decode_sample(i, max_decoded_width, max_decoded_height, decoder_color_format, keep_original);
+                    if (!substituted)
+                        quarantine(i);
                 }
             }
-            if (_decoder[i]->decode(_compressed_buff[i].data(), _compressed_image_size[i], _decompressed_buff_ptrs[i],
-                                    max_decoded_width, max_decoded_height,
-                                    original_width, original_height,
-                                    scaledw, scaledh,
-                                    decoder_color_format, _decoder_config, keep_original) != Decoder::Status::OK) {
+            if (!substituted) {
+                size_t j = find_valid_sample(i);
+                copy_sample(i, j);
+                memcpy(_decompressed_buff_ptrs[i], _decompressed_buff_ptrs[j], image_size);
+                _actual_decoded_width[i] = _actual_decoded_width[j];
+                _actual_decoded_height[i] = _actual_decoded_height[j];
+                if (_randombboxcrop_meta_data_reader) {
+                    _bbox_coords[i] = _bbox_coords[j];
+                    _crop_coords_batch[i] = _crop_coords_batch[j];
+                }
             }
-            _actual_decoded_width[i] = scaledw;
-            _actual_decoded_height[i] = scaledh;
+            _substitution_count++;
         }
         for (size_t i = 0; i < _batch_size; i++) {
             names[i] = _image_names[i];
@@ -52,7 +52,20 @@ ImageLoaderSingleShardNode::init(unsigned shard_id, unsigned shard_count, unsign
     reader_cfg.set_sequence_length(sequence_length);
     reader_cfg.set_frame_step(step);
     reader_cfg.set_frame_stride(stride);
-    _loader_module->initialize(reader_cfg, DecoderConfig(decoder_type),
+    auto decoder_cfg = DecoderConfig(decoder_type);
+    if (_randombboxcrop_meta_data_reader) {
+        // The crop window of each sample is generated by the RandomBBoxCrop reader ahead of decoding,
+        // so only the region inside the window has to be decoded
+        if (decoder_type == DecoderType::TURBO_JPEG) {
+            INFO("RandomBBoxCrop is used with the image loader, switching to partial decode")
+            decoder_cfg = DecoderConfig(DecoderType::FUSED_TURBO_JPEG);
+            decoder_cfg.set_seed(ParameterFactory::instance()->get_seed());
+            _loader_module->set_random_bbox_data_reader(_randombboxcrop_meta_data_reader);
+        } else {
+            WRN("RandomBBoxCrop partial decode is only supported with the TurboJPEG decoder, images are fully decoded")
+        }
+    }
+    _loader_module->initialize(reader_cfg, decoder_cfg,
                                mem_type,
                                _batch_size, decoder_keep_original);
     _loader_module->start_loading();
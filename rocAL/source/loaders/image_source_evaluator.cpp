@@ -49,6 +49,7 @@ ImageSourceEvaluator::create(ReaderConfig reader_cfg, DecoderConfig decoder_cfg)
 
     // _header_buff.resize(COMPRESSED_SIZE);
     _decoder = create_decoder(std::move(decoder_cfg));
+    _sample_info_table = SampleInfoCache::instance()->get_table(reader_cfg.path());
     _reader = create_reader(std::move(reader_cfg));
     find_max_dimension();
     return status;
@@ -64,6 +65,18 @@ ImageSourceEvaluator::find_max_dimension()
         size_t fsize = _reader->open();
         if( (fsize) == 0 )
             continue;
+        // Use the sample info gathered previously (by another loader or a persisted cache) instead of reading the sample
+        SampleInfo sample_info;
+        if(_sample_info_table->find(_reader->id(), sample_info))
+        {
+            _reader->close();
+            if(!sample_info.decode_failed && sample_info.width > 0 && sample_info.height > 0)
+            {
+                _width_max.process_sample(sample_info.width);
+                _height_max.process_sample(sample_info.height);
+            }
+            continue;
+        }
         _header_buff.resize(fsize);
         auto actual_read_size = _reader->read_data(_header_buff.data(), fsize);
         _reader->close();
@@ -72,8 +85,13 @@ ImageSourceEvaluator::find_max_dimension()
         if(_decoder->decode_info(_header_buff.data(), actual_read_size, &width, &height, &jpeg_sub_samp ) != Decoder::Status::OK)
         {
             WRN("Could not decode the header of the: "+ _reader->id())
+            _sample_info_table->mark_decode_failed(_reader->id());
             continue;
         }
+        sample_info.width = width;
+        sample_info.height = height;
+        sample_info.subsampling = jpeg_sub_samp;
+        _sample_info_table->insert(_reader->id(), sample_info);
         
         if(width <= 0 || height <=0)
             continue;
@@ -84,6 +102,7 @@ ImageSourceEvaluator::find_max_dimension()
     }
     // return the reader read pointer to the begining of the resource
     _reader->reset();
+    _sample_info_table->save();
 }
 
 void 
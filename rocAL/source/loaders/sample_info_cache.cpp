@@ -0,0 +1,201 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+#include <fstream>
+#include <sstream>
+#include <functional>
+#include "sample_info_cache.h"
+
+std::mutex SampleInfoCache::_mutex;
+
+static const char *CACHE_FILE_HEADER = "# rocAL sample info cache v2: sample_path width height subsampling";
+
+SampleInfoTable::SampleInfoTable(const std::string &cache_file):
+        _cache_file(cache_file)
+{
+}
+
+bool SampleInfoTable::find(const std::string &sample_id, SampleInfo &info)
+{
+    std::shared_lock<std::shared_mutex> lock(_lock);
+    auto it = _table.find(sample_id);
+    if(it == _table.end())
+        return false;
+    info = it->second;
+    return true;
+}
+
+void SampleInfoTable::insert(const std::string &sample_id, const SampleInfo &info)
+{
+    std::unique_lock<std::shared_mutex> lock(_lock);
+    _table[sample_id] = info;
+    _dirty = true;
+}
+
+void SampleInfoTable::mark_decode_failed(const std::string &sample_id)
+{
+    std::unique_lock<std::shared_mutex> lock(_lock);
+    // Not persisted, the table is not dirtied
+    _table[sample_id].decode_failed = true;
+}
+
+bool SampleInfoTable::is_decode_failed(const std::string &sample_id)
+{
+    std::shared_lock<std::shared_mutex> lock(_lock);
+    auto it = _table.find(sample_id);
+    return (it != _table.end()) && it->second.decode_failed;
+}
+
+size_t SampleInfoTable::size()
+{
+    std::shared_lock<std::shared_mutex> lock(_lock);
+    return _table.size();
+}
+
+void SampleInfoTable::load()
+{
+    if(_cache_file.empty())
+        return;
+    std::lock_guard<std::mutex> file_lock(_file_lock);
+    std::ifstream cache_file(_cache_file);
+    if(!cache_file.is_open())
+        return;
+    std::unique_lock<std::shared_mutex> lock(_lock);
+    std::string line;
+    // Files of the earlier format are keyed on the file names, they are ignored and rewritten
+    if(!std::getline(cache_file, line) || line != CACHE_FILE_HEADER)
+    {
+        LOG("Ignoring the sample info cache file " + _cache_file + " of an older format")
+        return;
+    }
+    while(std::getline(cache_file, line))
+    {
+        if(line.empty() || line[0] == '#')
+            continue;
+        // Each line is stored as "sample_path\twidth\theight\tsubsampling", the path itself can contain spaces
+        auto id_end = line.rfind('\t', line.size());
+        for(int field = 0; field < 2 && id_end != std::string::npos && id_end > 0; field++)
+            id_end = line.rfind('\t', id_end - 1);
+        if(id_end == std::string::npos)
+            continue;
+        SampleInfo info;
+        std::istringstream fields(line.substr(id_end + 1));
+        if(!(fields >> info.width >> info.height >> info.subsampling))
+            continue;
+        _table[line.substr(0, id_end)] = info;
+    }
+    LOG("Loaded " + TOSTR(_table.size()) + " sample info entries from " + _cache_file)
+}
+
+void SampleInfoTable::save()
+{
+    if(_cache_file.empty())
+        return;
+    std::lock_guard<std::mutex> file_lock(_file_lock);
+    std::ostringstream content;
+    {
+        std::shared_lock<std::shared_mutex> lock(_lock);
+        if(!_dirty)
+            return;
+        content << CACHE_FILE_HEADER << '\n';
+        for(auto &entry: _table)
+        {
+            // Samples quarantined before their header was ever parsed have nothing to persist
+            if(entry.second.width <= 0)
+                continue;
+            content << entry.first << '\t' << entry.second.width << '\t' << entry.second.height << '\t'
+                    << entry.second.subsampling << '\n';
+        }
+    }
+    // Write to a temporary file first, so a concurrent reader in another process never sees a partially written cache
+    std::string tmp_file = _cache_file + ".tmp";
+    std::ofstream cache_file(tmp_file, std::ios::trunc);
+    if(!cache_file.is_open())
+    {
+        WRN("Could not open the sample info cache file " + tmp_file + " for writing")
+        return;
+    }
+    cache_file << content.str();
+    cache_file.close();
+    std::error_code err;
+    filesys::rename(tmp_file, _cache_file, err);
+    if(err)
+    {
+        WRN("Could not write the sample info cache file " + _cache_file + " : " + err.message())
+        return;
+    }
+    std::unique_lock<std::shared_mutex> lock(_lock);
+    _dirty = false;
+}
+
+SampleInfoCache* SampleInfoCache::instance()
+{
+    // Never destroyed, the tables are saved explicitly by save_all()
+    static SampleInfoCache* cache = new SampleInfoCache();
+    return cache;
+}
+
+std::string SampleInfoCache::cache_file_path(const std::string &dataset_path)
+{
+    if(_cache_dir.empty())
+        return "";
+    auto canonical_path = filesys::weakly_canonical(filesys::path(dataset_path)).string();
+    return (filesys::path(_cache_dir) / ("rocal_sample_info_" + std::to_string(std::hash<std::string>{}(canonical_path)) + ".txt")).string();
+}
+
+std::shared_ptr<SampleInfoTable> SampleInfoCache::get_table(const std::string &dataset_path)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _tables.find(dataset_path);
+    if(it != _tables.end())
+        return it->second;
+    auto table = std::make_shared<SampleInfoTable>(cache_file_path(dataset_path));
+    table->load();
+    _tables.insert(std::make_pair(dataset_path, table));
+    return table;
+}
+
+void SampleInfoCache::set_cache_dir(const std::string &cache_dir)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(!cache_dir.empty() && !filesys::exists(cache_dir))
+    {
+        std::error_code err;
+        if(!filesys::create_directories(cache_dir, err))
+            THROW("Could not create the sample info cache directory " + cache_dir + " : " + err.message())
+    }
+    _cache_dir = cache_dir;
+}
+
+std::string SampleInfoCache::get_cache_dir()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _cache_dir;
+}
+
+void SampleInfoCache::save_all()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(auto &table: _tables)
+        table.second->save();
+}
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include <chrono>
 #include "video_loader.h"
 #include "video_read_and_decode.h"
+#include "cpu_topology.h"
 #include "vx_ext_amd.h"
 
 #ifdef ROCAL_VIDEO
@@ -125,6 +126,9 @@ void VideoLoader::initialize(VideoReaderConfig reader_cfg, VideoDecoderConfig de
         WRN("initialize() function is already called and loader module is initialized")
     if (_output_mem_size == 0)
         THROW("output image size is 0, set_output_image() should be called before initialize for loader modules")
+    _shard_id = reader_cfg.get_shard_id();
+    // The decoder pool and the circular buffer are created and first touched on the shard's node
+    ScopedNodePlacement node_placement(_cpu_placement, _shard_id);
     _mem_type = mem_type;
     _batch_size = batch_size;
     _loop = reader_cfg.loop();
@@ -132,6 +136,7 @@ void VideoLoader::initialize(VideoReaderConfig reader_cfg, VideoDecoderConfig de
     _sequence_count = _batch_size / _sequence_length;
     _decoder_keep_original = decoder_keep_original;
     _video_loader = std::make_shared<VideoReadAndDecode>();
+    _video_loader->enable_stats(_stats_enabled);
     try
     {
         _video_loader->create(reader_cfg, decoder_cfg, _batch_size);
@@ -164,11 +169,14 @@ VideoLoaderModuleStatus
 VideoLoader::load_routine()
 {
     LOG("Started the internal loader thread");
+    ScopedNodePlacement node_placement(_cpu_placement, _shard_id);
+    TraceRecorder::instance()->set_thread_name("Video loader shard " + TOSTR(_shard_id));
     VideoLoaderModuleStatus last_load_status = VideoLoaderModuleStatus::OK;
 
     // Initially record number of all the frames that are going to be loaded, this is used to know how many still there
     while (_internal_thread_running)
     {
+        TraceRecorder::set_thread_batch(_image_counter / _batch_size);
         auto data = _circ_buff.get_write_buffer();
         if (!_internal_thread_running)
             break;
@@ -257,6 +265,10 @@ VideoLoader::update_output_image()
     }
     if (_stopped)
         return VideoLoaderModuleStatus::OK;
+    if (_stats_enabled.load(std::memory_order_relaxed)) {
+        _buffer_level_sum += _circ_buff.level();
+        _buffer_level_samples++;
+    }
     _output_decoded_img_info = _circ_buff.get_image_info();
     _output_names = _output_decoded_img_info._image_names;
     _output_image->update_image_roi(_output_decoded_img_info._roi_width, _output_decoded_img_info._roi_height);
@@ -266,6 +278,23 @@ VideoLoader::update_output_image()
     return status;
 }
 
+void VideoLoader::enable_stats(bool enable)
+{
+    _stats_enabled = enable;
+    if (_video_loader)
+        _video_loader->enable_stats(enable);
+}
+
+LoaderStats VideoLoader::stats()
+{
+    LoaderStats s = _video_loader ? _video_loader->stats() : LoaderStats();
+    s.buffer_level = _circ_buff.level();
+    s.buffer_depth = _circ_buff.active_depth();
+    auto samples = _buffer_level_samples.load();
+    s.mean_buffer_level = samples ? static_cast<double>(_buffer_level_sum.load()) / samples : 0;
+    return s;
+}
+
 Timing VideoLoader::timing()
 {
     auto t = _video_loader->timing();
@@ -87,6 +87,8 @@ void VideoLoaderSharded::initialize(VideoReaderConfig reader_cfg, VideoDecoderCo
     {
         auto loader = std::make_shared<VideoLoader>(_dev_resources);
         loader->set_prefetch_queue_depth(_prefetch_queue_depth);
+        loader->set_cpu_placement(_cpu_placement);
+        loader->enable_stats(_stats_enabled);
         _loaders.push_back(loader);
     }
 
@@ -113,13 +115,8 @@ void VideoLoaderSharded::start_loading()
         struct sched_param params;
         params.sched_priority = sched_get_priority_max(SCHED_FIFO);
         _loaders[i]->set_cpu_sched_policy(params);
-        // Setting cpu affinity for threads works and can be activated below for experimentation
-        // Set thread affinity thread 0 to core 0 , 1 toc core 1 , ...
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
-        CPU_SET(i, &cpuset);
-        _loaders[i]->set_cpu_affinity(cpuset);
 #endif
+        // CPU affinity of the loader threads is set through set_cpu_placement(), each loader pins itself on its shard's node
     }
 }
 
@@ -130,6 +127,15 @@ void VideoLoaderSharded::shut_down()
 
 }
 
+std::vector<unsigned> VideoLoaderSharded::get_shard_ids()
+{
+    std::vector<unsigned> shard_ids;
+    for (auto &loader : _loaders)
+        for (auto shard_id : loader->get_shard_ids())
+            shard_ids.push_back(shard_id);
+    return shard_ids;
+}
+
 void VideoLoaderSharded::set_output_image(Image *output_image)
 {
     _output_image = output_image;
@@ -168,6 +174,28 @@ std::vector<std::vector<float>> VideoLoaderSharded::get_sequence_frame_timestamp
     return _loaders[_loader_idx]->get_sequence_frame_timestamps();
 }
 
+void VideoLoaderSharded::enable_stats(bool enable)
+{
+    _stats_enabled = enable;
+    for(auto& loader: _loaders)
+        loader->enable_stats(enable);
+}
+
+LoaderStats VideoLoaderSharded::stats()
+{
+    LoaderStats s;
+    for(auto& loader: _loaders)
+    {
+        auto info = loader->stats();
+        s.read_time.merge(info.read_time);
+        s.decode_time.merge(info.decode_time);
+        s.buffer_level += info.buffer_level;
+        s.buffer_depth += info.buffer_depth;
+        s.mean_buffer_level += info.mean_buffer_level;
+    }
+    return s;
+}
+
 Timing VideoLoaderSharded::timing()
 {
     Timing t;
@@ -22,6 +22,8 @@ THE SOFTWARE.
 
 #include "video_decoder_factory.h"
 #include "video_read_and_decode.h"
+#include "decode_scheduler.h"
+#include "video_keyframe_index.h"
 
 #ifdef ROCAL_VIDEO
 std::tuple<VideoDecoder::ColorFormat, unsigned, AVPixelFormat>
@@ -52,6 +54,22 @@ VideoReadAndDecode::timing()
     return t;
 }
 
+void
+VideoReadAndDecode::enable_stats(bool enable)
+{
+    _file_load_time.enable_stats(enable);
+    _decode_time.enable_stats(enable);
+}
+
+LoaderStats
+VideoReadAndDecode::stats()
+{
+    LoaderStats s;
+    s.read_time = _file_load_time.stats();
+    s.decode_time = _decode_time.stats();
+    return s;
+}
+
 VideoReadAndDecode::VideoReadAndDecode() : _file_load_time("FileLoadTime", DBG_TIMING),
                                            _decode_time("DecodeTime", DBG_TIMING)
 {
@@ -59,8 +77,9 @@ VideoReadAndDecode::VideoReadAndDecode() : _file_load_time("FileLoadTime", DBG_T
 
 VideoReadAndDecode::~VideoReadAndDecode()
 {
+    stop_decode_workers();
     _video_reader = nullptr;
-    _video_decoder.clear();
+    _decode_slots.clear();
 }
 
 void VideoReadAndDecode::create(VideoReaderConfig reader_config, VideoDecoderConfig decoder_config, int batch_size)
@@ -71,45 +90,154 @@ void VideoReadAndDecode::create(VideoReaderConfig reader_config, VideoDecoderCon
     _video_count = _video_prop.videos_count;
     _frame_rate = _video_prop.frame_rate;
     _batch_size = batch_size;
-    set_video_process_count(_video_count);
-    _video_decoder.resize(_video_process_count);
     _video_names = _video_prop.video_file_names;
     _sequence_count = _batch_size / _sequence_length;
     _decompressed_buff_ptrs.resize(_sequence_count);
     _actual_decoded_width.resize(_sequence_count);
     _actual_decoded_height.resize(_sequence_count);
+
+    // A decoder instance is created per sequence of the batch (several of them can open the same video), the share of the
+    // process wide decode budget left to each decoder of each shard is given to FFmpeg's frame and slice threading
+    size_t slot_count = std::max((size_t)1, std::min(_sequence_count, _max_decode_slots));
+    size_t shard_count = std::max((size_t)1, reader_config.get_shard_count());
+    size_t decode_budget = DecodeScheduler::instance()->thread_budget();
+    decoder_config.set_decoder_threads(static_cast<unsigned>(std::max((size_t)1, decode_budget / (slot_count * shard_count))));
     _video_decoder_config = decoder_config;
+    _decode_slots.resize(slot_count);
+    for (auto &slot : _decode_slots)
+        slot.decoder = create_video_decoder(_video_decoder_config);
+    _video_reader = create_video_reader(reader_config);
+    start_decode_workers();
+}
 
-    // Initialize the ffmpeg context once for the video files.
-    size_t i = 0;
-    for (; i < _video_process_count; i++)
+void VideoReadAndDecode::start_decode_workers()
+{
+    _stop_workers = false;
+    for (size_t i = 0; i < _decode_slots.size(); i++)
+        _decode_workers.push_back(std::thread(&VideoReadAndDecode::decode_worker, this, i));
+}
+
+void VideoReadAndDecode::stop_decode_workers()
+{
     {
-        _video_decoder[i] = create_video_decoder(decoder_config);
-        std::vector<std::string> substrings;
-        char delim = '#';
-        substring_extraction(_video_names[i], delim, substrings);
-        video_map video_instance;
-        video_instance._video_map_idx = atoi(substrings[0].c_str());
-        video_instance._is_decoder_instance = true;
-        if (_video_decoder[i]->Initialize(substrings[1].c_str()) != VideoDecoder::Status::OK)
-            video_instance._is_decoder_instance = false;
-        _video_file_name_map.insert(std::pair<std::string, video_map>(_video_names[i], video_instance));
+        std::unique_lock<std::mutex> lock(_workers_lock);
+        _stop_workers = true;
     }
-    if (_video_process_count != _video_count)
+    _workers_start_cv.notify_all();
+    for (auto &worker : _decode_workers)
+        if (worker.joinable())
+            worker.join();
+    _decode_workers.clear();
+}
+
+void VideoReadAndDecode::decode_worker(size_t slot_idx)
+{
+    size_t generation = 0;
+    while (true)
     {
-        while (i < _video_count)
+        {
+            std::unique_lock<std::mutex> lock(_workers_lock);
+            _workers_start_cv.wait(lock, [&] { return _stop_workers || _batch_generation != generation; });
+            if (_stop_workers)
+                return;
+            generation = _batch_generation;
+        }
+        decode_slot(slot_idx);
+        {
+            std::unique_lock<std::mutex> lock(_workers_lock);
+            if (--_busy_workers == 0)
+                _workers_done_cv.notify_one();
+        }
+    }
+}
+
+void VideoReadAndDecode::decode_slot(size_t slot_idx)
+{
+    auto &slot = _decode_slots[slot_idx];
+    slot.failed = false;
+    for (auto sequence_index : slot.sequences)
+    {
+        // Keep the video opened by the decoder as long as the assigned sequences come from it
+        if (slot.video_path != _sequence_video_path[sequence_index])
         {
             std::vector<std::string> substrings;
             char delim = '#';
-            substring_extraction(_video_names[i], delim, substrings);
-            video_map video_instance;
-            video_instance._video_map_idx = atoi(substrings[0].c_str());
-            video_instance._is_decoder_instance = false;
-            _video_file_name_map.insert(std::pair<std::string, video_map>(_video_names[i], video_instance));
-            i++;
+            substring_extraction(_sequence_video_path[sequence_index], delim, substrings);
+            if (!slot.video_path.empty())
+                slot.decoder->release();
+            slot.video_path.clear();
+            if (slot.decoder->Initialize(substrings[1].c_str()) != VideoDecoder::Status::OK)
+            {
+                ERR("Failed to open the video " + substrings[1] + " for decoding");
+                slot.decoder->release();
+                // The sequences left unfilled fail the whole batch, the rest of the slot is not decoded
+                slot.failed = true;
+                return;
+            }
+            slot.video_path = _sequence_video_path[sequence_index];
+        }
+        if (slot.decoder->Decode(_decompressed_buff_ptrs[sequence_index], _sequence_start_frame_num[sequence_index], _sequence_length, _stride,
+                                 _max_decoded_width, _max_decoded_height, _max_decoded_stride, _out_pix_fmt) != VideoDecoder::Status::OK)
+        {
+            ERR("Failed to decode the sequence starting at frame " + TOSTR(_sequence_start_frame_num[sequence_index]) + " of " + _sequence_video_path[sequence_index]);
+            slot.failed = true;
+            return;
         }
+        _actual_decoded_width[sequence_index] = _max_decoded_width;
+        _actual_decoded_height[sequence_index] = _max_decoded_height;
+    }
+}
+
+size_t VideoReadAndDecode::keyframe_interval(const std::string &video_path, size_t frame_number)
+{
+    std::vector<std::string> substrings;
+    substring_extraction(video_path, '#', substrings);
+    // Keyframes are known once the video is probed or opened by a decoder, until then all its sequences are a single interval
+    std::vector<unsigned> keyframes;
+    if (!VideoKeyframeIndex::instance()->find(substrings[1], keyframes) || keyframes.empty())
+        return 0;
+    return std::upper_bound(keyframes.begin(), keyframes.end(), frame_number) - keyframes.begin();
+}
+
+void VideoReadAndDecode::schedule_sequences()
+{
+    for (auto &slot : _decode_slots)
+        slot.sequences.clear();
+
+    // Sequences starting in the same keyframe interval of a video decode the same frames after seeking,
+    // they are grouped and decoded in increasing frame order by a single decoder
+    std::map<std::pair<std::string, size_t>, std::vector<size_t>> groups;
+    for (size_t i = 0; i < _sequence_count; i++)
+        groups[std::make_pair(_sequence_video_path[i], keyframe_interval(_sequence_video_path[i], _sequence_start_frame_num[i]))].push_back(i);
+    std::vector<std::vector<size_t> *> pending_groups;
+    for (auto &group : groups)
+    {
+        auto &sequences = group.second;
+        std::sort(sequences.begin(), sequences.end(), [&](size_t a, size_t b) { return _sequence_start_frame_num[a] < _sequence_start_frame_num[b]; });
+        // First choice is an idle slot that has the video opened already
+        bool assigned = false;
+        for (auto &slot : _decode_slots)
+        {
+            if (slot.sequences.empty() && slot.video_path == group.first.first)
+            {
+                slot.sequences = sequences;
+                assigned = true;
+                break;
+            }
+        }
+        if (!assigned)
+            pending_groups.push_back(&sequences);
+    }
+    // Then the remaining groups go to the idle slots, and to the least loaded slots once all of them are busy
+    for (auto sequences : pending_groups)
+    {
+        size_t selected = 0;
+        for (size_t s = 1; s < _decode_slots.size(); s++)
+            if (_decode_slots[s].sequences.size() < _decode_slots[selected].sequences.size())
+                selected = s;
+        auto &slot_sequences = _decode_slots[selected].sequences;
+        slot_sequences.insert(slot_sequences.end(), sequences->begin(), sequences->end());
     }
-    _video_reader = create_video_reader(reader_config);
 }
 
 void VideoReadAndDecode::reset()
@@ -130,16 +258,6 @@ float VideoReadAndDecode::convert_framenum_to_timestamp(size_t frame_number)
     return timestamp;
 }
 
-void VideoReadAndDecode::decode_sequence(size_t sequence_index)
-{
-    if (_video_decoder[_sequence_video_idx[sequence_index]]->Decode(_decompressed_buff_ptrs[sequence_index], _sequence_start_frame_num[sequence_index], _sequence_length, _stride,
-                                                                    _max_decoded_width, _max_decoded_height, _max_decoded_stride, _out_pix_fmt) == VideoDecoder::Status::OK)
-    {
-        _actual_decoded_width[sequence_index] = _max_decoded_width;
-        _actual_decoded_height[sequence_index] = _max_decoded_height;
-    }
-}
-
 VideoLoaderModuleStatus
 VideoReadAndDecode::load(unsigned char *buff,
                          std::vector<std::string> &names,
@@ -175,10 +293,6 @@ VideoReadAndDecode::load(unsigned char *buff,
 
     _file_load_time.start(); // Debug timing
 
-    std::vector<size_t> sequential_decode_sequences;
-    std::vector<size_t> parallel_decode_sequences;
-    std::vector<int> video_index;
-    size_t parallel_sequence_count = 0;
     _sequence_start_frame_num.resize(_sequence_count);
     _sequence_video_path.resize(_sequence_count);
     for (size_t i = 0; i < _sequence_count; i++)
@@ -187,72 +301,31 @@ VideoReadAndDecode::load(unsigned char *buff,
         _sequence_start_frame_num[i] = sequence_info.start_frame_number;
         _sequence_video_path[i] = sequence_info.video_file_name;
         _decompressed_buff_ptrs[i] = buff + (i * image_size * _sequence_length);
-
-        // Check if the video file is already initialized otherwise use an existing decoder instance to initialize the video
-        // std::cerr << "\nThe source video is " << _sequence_video_path[i] << " MAP : "<<_video_file_name_map.find(_sequence_video_path[i])->second._video_map_idx << "\tThe start index is : " << _sequence_start_frame_num[i] << "\n";
-        std::map<std::string, video_map>::iterator itr = _video_file_name_map.find(_sequence_video_path[i]);
-        if (itr->second._is_decoder_instance == false)
-        {
-            std::map<std::string, video_map>::iterator temp_itr;
-            for (temp_itr = _video_file_name_map.begin(); temp_itr != _video_file_name_map.end(); ++temp_itr)
-            {
-                if (temp_itr->second._is_decoder_instance == true)
-                {
-                    int video_idx = temp_itr->second._video_map_idx;
-                    if ((std::count(_sequence_video_idx.begin(), _sequence_video_idx.end(), video_idx) >= 1) && (_sequence_video_idx.size() != 0))
-                        continue;
-                    std::vector<std::string> substrings;
-                    char delim = '#';
-                    substring_extraction(itr->first, delim, substrings);
-                    if (_video_decoder[video_idx]->Initialize(substrings[1].c_str()) == VideoDecoder::Status::OK)
-                    {
-                        itr->second._video_map_idx = video_idx;
-                        itr->second._is_decoder_instance = true;
-                    }
-                    temp_itr->second._is_decoder_instance = false;
-                    break;
-                }
-            }
-        }
-        if (itr->second._is_decoder_instance == false)
-            continue;
-        _sequence_video_idx.push_back(itr->second._video_map_idx);
-
-        // Check if the sequences are from same or different video file
-        video_index.push_back(_video_file_name_map[_sequence_video_path[i]]._video_map_idx);
-        if (std::count(video_index.begin(), video_index.end(), video_index[i]) > 1)
-        {
-            sequential_decode_sequences.push_back(i);
-        }
-        else
-        {
-            parallel_decode_sequences.push_back(i);
-            parallel_sequence_count++;
-        }
-    }
-    if (parallel_sequence_count == 1)
-    {
-        sequential_decode_sequences.push_back(parallel_decode_sequences.back());
-        parallel_decode_sequences.clear();
     }
+    schedule_sequences();
 
     _file_load_time.end(); // Debug timing
 
     _decode_time.start(); // Debug timing
 
-    for (size_t i = 0; i < sequential_decode_sequences.size(); i++)
-        decode_sequence(sequential_decode_sequences[i]);
-
-    // Initialize threads to decode
-    std::vector<std::thread> decode_threads;
-    for (size_t i = 0; i < parallel_decode_sequences.size(); i++)
-        decode_threads.push_back(std::thread(&VideoReadAndDecode::decode_sequence, this, parallel_decode_sequences[i]));
-
-    for (auto &th : decode_threads)
-        th.join();
+    // Hand the batch to the persistent decode workers and wait for all of them to finish
+    {
+        std::unique_lock<std::mutex> lock(_workers_lock);
+        _busy_workers = _decode_workers.size();
+        _batch_generation++;
+    }
+    _workers_start_cv.notify_all();
+    {
+        std::unique_lock<std::mutex> lock(_workers_lock);
+        _workers_done_cv.wait(lock, [&] { return _busy_workers == 0; });
+    }
 
     _decode_time.end(); // Debug timing
 
+    for (auto &slot : _decode_slots)
+        if (slot.failed)
+            return VideoLoaderModuleStatus::DECODE_FAILED;
+
     for (size_t i = 0; i < _sequence_count; i++)
     {
         std::vector<std::string> substrings1, substrings2;
@@ -275,7 +348,6 @@ VideoReadAndDecode::load(unsigned char *buff,
     sequence_frame_timestamps_vec.insert(sequence_frame_timestamps_vec.begin(), sequence_frame_timestamps);
     _sequence_start_frame_num.clear();
     _sequence_video_path.clear();
-    _sequence_video_idx.clear();
     return VideoLoaderModuleStatus::OK;
 }
 #endif
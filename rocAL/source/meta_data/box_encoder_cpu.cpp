@@ -0,0 +1,187 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <algorithm>
+#if ENABLE_SIMD
+#include <immintrin.h>
+#endif
+#include "box_encoder_cpu.h"
+
+BoxEncoderCpu::BoxEncoderCpu(size_t batch_size, const std::vector<float> &anchors, float criteria, const std::vector<float> &means, const std::vector<float> &stds, bool offset, float scale):
+        _batch_size(batch_size),
+        _anchor_count(anchors.size() / 4),
+        _criteria(criteria),
+        _offset(offset),
+        _scale(scale)
+{
+    if (criteria < 0.f || criteria > 1.f || means.size() != 4 || stds.size() != 4)
+        THROW("BoxEncoder invalid input parameter")
+    _anchors_l.resize(_anchor_count);
+    _anchors_t.resize(_anchor_count);
+    _anchors_r.resize(_anchor_count);
+    _anchors_b.resize(_anchor_count);
+    _anchors_area.resize(_anchor_count);
+    _anchors_xcycwh.resize(_anchor_count);
+    for (size_t i = 0; i < _anchor_count; i++)
+    {
+        _anchors_l[i] = anchors[i * 4];
+        _anchors_t[i] = anchors[i * 4 + 1];
+        _anchors_r[i] = anchors[i * 4 + 2];
+        _anchors_b[i] = anchors[i * 4 + 3];
+        _anchors_area[i] = (_anchors_b[i] - _anchors_t[i]) * (_anchors_r[i] - _anchors_l[i]);
+        _anchors_xcycwh[i] = {0.5f * (_anchors_l[i] + _anchors_r[i]), 0.5f * (_anchors_t[i] + _anchors_b[i]),
+                              _anchors_r[i] - _anchors_l[i], _anchors_b[i] - _anchors_t[i]};
+    }
+    for (unsigned i = 0; i < 4; i++)
+    {
+        _means[i] = means[i];
+        _inv_stds[i] = 1.f / stds[i];
+    }
+    _best_ious.resize(_batch_size * _anchor_count);
+    _best_idx.resize(_batch_size * _anchor_count);
+}
+
+void BoxEncoderCpu::match_box(const BoundingBoxCord &box, int box_idx, float *best_ious, int *best_idx) const
+{
+    const float box_area = (box.b - box.t) * (box.r - box.l);
+    float box_best_iou = -1.f;
+    size_t box_best_anchor = 0;
+    size_t anchor_idx = 0;
+#if (ENABLE_SIMD && __AVX2__)
+    const __m256 pbox_l = _mm256_set1_ps(box.l), pbox_t = _mm256_set1_ps(box.t), pbox_r = _mm256_set1_ps(box.r), pbox_b = _mm256_set1_ps(box.b);
+    const __m256 pbox_area = _mm256_set1_ps(box_area), pzero = _mm256_setzero_ps();
+    const __m256 pbox_idx = _mm256_castsi256_ps(_mm256_set1_epi32(box_idx));
+    const __m256i pstep = _mm256_set1_epi32(8);
+    __m256i panchor_idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256 pbox_best_iou = _mm256_set1_ps(-1.f);
+    __m256 pbox_best_anchor = _mm256_castsi256_ps(_mm256_setzero_si256());
+    for (; anchor_idx + 8 <= _anchor_count; anchor_idx += 8)
+    {
+        __m256 pw = _mm256_max_ps(pzero, _mm256_sub_ps(_mm256_min_ps(pbox_r, _mm256_loadu_ps(&_anchors_r[anchor_idx])), _mm256_max_ps(pbox_l, _mm256_loadu_ps(&_anchors_l[anchor_idx]))));
+        __m256 ph = _mm256_max_ps(pzero, _mm256_sub_ps(_mm256_min_ps(pbox_b, _mm256_loadu_ps(&_anchors_b[anchor_idx])), _mm256_max_ps(pbox_t, _mm256_loadu_ps(&_anchors_t[anchor_idx]))));
+        __m256 pintersection = _mm256_mul_ps(pw, ph);
+        __m256 piou = _mm256_div_ps(pintersection, _mm256_sub_ps(_mm256_add_ps(pbox_area, _mm256_loadu_ps(&_anchors_area[anchor_idx])), pintersection));
+        // The later box wins ties for an anchor, the first anchor wins ties for a box
+        __m256 pbest_iou = _mm256_loadu_ps(&best_ious[anchor_idx]);
+        __m256 ptake = _mm256_cmp_ps(piou, pbest_iou, _CMP_GE_OQ);
+        _mm256_storeu_ps(&best_ious[anchor_idx], _mm256_blendv_ps(pbest_iou, piou, ptake));
+        __m256 pbest_idx = _mm256_loadu_ps(reinterpret_cast<float *>(&best_idx[anchor_idx]));
+        _mm256_storeu_ps(reinterpret_cast<float *>(&best_idx[anchor_idx]), _mm256_blendv_ps(pbest_idx, pbox_idx, ptake));
+        __m256 pbetter = _mm256_cmp_ps(piou, pbox_best_iou, _CMP_GT_OQ);
+        pbox_best_iou = _mm256_blendv_ps(pbox_best_iou, piou, pbetter);
+        pbox_best_anchor = _mm256_blendv_ps(pbox_best_anchor, _mm256_castsi256_ps(panchor_idx), pbetter);
+        panchor_idx = _mm256_add_epi32(panchor_idx, pstep);
+    }
+    alignas(32) float lane_iou[8];
+    alignas(32) int lane_anchor[8];
+    _mm256_store_ps(lane_iou, pbox_best_iou);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lane_anchor), _mm256_castps_si256(pbox_best_anchor));
+    for (unsigned lane = 0; lane < 8; lane++)
+    {
+        if (lane_iou[lane] > box_best_iou || (lane_iou[lane] == box_best_iou && static_cast<size_t>(lane_anchor[lane]) < box_best_anchor))
+        {
+            box_best_iou = lane_iou[lane];
+            box_best_anchor = lane_anchor[lane];
+        }
+    }
+#endif
+    for (; anchor_idx < _anchor_count; anchor_idx++)
+    {
+        float w = std::max(0.f, std::min(box.r, _anchors_r[anchor_idx]) - std::max(box.l, _anchors_l[anchor_idx]));
+        float h = std::max(0.f, std::min(box.b, _anchors_b[anchor_idx]) - std::max(box.t, _anchors_t[anchor_idx]));
+        float intersection = w * h;
+        float iou = intersection / (box_area + _anchors_area[anchor_idx] - intersection);
+        if (iou >= best_ious[anchor_idx])
+        {
+            best_ious[anchor_idx] = iou;
+            best_idx[anchor_idx] = box_idx;
+        }
+        if (iou > box_best_iou)
+        {
+            box_best_iou = iou;
+            box_best_anchor = anchor_idx;
+        }
+    }
+    // The best anchor of each box is a match whatever its IoU, as if it was 2
+    best_ious[box_best_anchor] = 2.f;
+    best_idx[box_best_anchor] = box_idx;
+}
+
+void BoxEncoderCpu::encode_sample(const BoundingBoxCord *boxes, const int *labels, size_t box_count, float *best_ious, int *best_idx, float *encoded_boxes, int *encoded_labels) const
+{
+    std::fill(best_ious, best_ious + _anchor_count, -1.f);
+    std::fill(best_idx, best_idx + _anchor_count, 0);
+    for (size_t box_idx = 0; box_idx < box_count; box_idx++)
+        match_box(boxes[box_idx], box_idx, best_ious, best_idx);
+
+    auto out_boxes = reinterpret_cast<BoundingBoxCord_xcycwh *>(encoded_boxes);
+    const float half_scale = 0.5f * _scale;
+    for (size_t anchor_idx = 0; anchor_idx < _anchor_count; anchor_idx++)
+    {
+        if (best_ious[anchor_idx] > _criteria) // Its a match
+        {
+            const auto &box = boxes[best_idx[anchor_idx]];
+            auto &out = out_boxes[anchor_idx];
+            if (_offset)
+            {
+                // Offset of the box from the anchor in <xc,yc,w,h> format, normalized by the means and stds
+                const auto &anchor = _anchors_xcycwh[anchor_idx];
+                float anchor_w = anchor.w * _scale, anchor_h = anchor.h * _scale;
+                out.xc = (((box.l + box.r) * half_scale - anchor.xc * _scale) / anchor_w - _means[0]) * _inv_stds[0];
+                out.yc = (((box.t + box.b) * half_scale - anchor.yc * _scale) / anchor_h - _means[1]) * _inv_stds[1];
+                out.w = (std::log((box.r - box.l) * _scale / anchor_w) - _means[2]) * _inv_stds[2];
+                out.h = (std::log((box.b - box.t) * _scale / anchor_h) - _means[3]) * _inv_stds[3];
+            }
+            else
+            {
+                out = {0.5f * (box.l + box.r), 0.5f * (box.t + box.b), box.r - box.l, box.b - box.t};
+            }
+            encoded_labels[anchor_idx] = labels[best_idx[anchor_idx]];
+        }
+        else // Not a match
+        {
+            if (_offset)
+                out_boxes[anchor_idx] = {0, 0, 0, 0};
+            else
+                out_boxes[anchor_idx] = _anchors_xcycwh[anchor_idx];
+            encoded_labels[anchor_idx] = 0;
+        }
+    }
+}
+
+void BoxEncoderCpu::Run(pMetaDataBatch full_batch_meta_data, float *encoded_boxes, int *encoded_labels)
+{
+    if (!encoded_boxes || !encoded_labels)
+        THROW("BoxEncoder output buffers are not allocated")
+    size_t sample_count = full_batch_meta_data->size();
+    if (sample_count > _batch_size)
+        THROW("BoxEncoder expects at most " + TOSTR(_batch_size) + " samples, got " + TOSTR(sample_count))
+    const auto &bb = full_batch_meta_data->get_bb_batch();
+    #pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(sample_count); i++)
+    {
+        encode_sample(bb.cords_of(i), bb.labels_of(i), bb.count(i),
+                      _best_ious.data() + i * _anchor_count, _best_idx.data() + i * _anchor_count,
+                      encoded_boxes + i * _anchor_count * 4, encoded_labels + i * _anchor_count);
+    }
+}
@@ -0,0 +1,453 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#if ENABLE_SIMD
+#include <immintrin.h>
+#endif
+#include "box_transform_cpu.h"
+
+#define PI 3.14159265
+#define RAD(deg) (deg * PI / 180)
+
+// Below this many boxes in the batch the samples are cropped or rotated on the calling thread
+constexpr size_t PARALLEL_MIN_BOX_COUNT = 4096;
+
+#if (ENABLE_SIMD && __AVX2__)
+// The std::min/std::max operand order is kept so both paths give the same boxes
+static inline __m256 max_of(__m256 a, __m256 b) { return _mm256_max_ps(b, a); }
+static inline __m256 min_of(__m256 a, __m256 b) { return _mm256_min_ps(b, a); }
+
+// Loads 8 boxes as l, t, r, b registers holding boxes 0, 2, 4, 6, 1, 3, 5, 7
+static inline void load_boxes(const BoundingBoxCord *boxes, __m256 &l, __m256 &t, __m256 &r, __m256 &b)
+{
+    auto src = reinterpret_cast<const float *>(boxes);
+    __m256 p01 = _mm256_loadu_ps(src), p23 = _mm256_loadu_ps(src + 8), p45 = _mm256_loadu_ps(src + 16), p67 = _mm256_loadu_ps(src + 24);
+    __m256 plt0 = _mm256_unpacklo_ps(p01, p23), prb0 = _mm256_unpackhi_ps(p01, p23);
+    __m256 plt1 = _mm256_unpacklo_ps(p45, p67), prb1 = _mm256_unpackhi_ps(p45, p67);
+    l = _mm256_shuffle_ps(plt0, plt1, _MM_SHUFFLE(1, 0, 1, 0));
+    t = _mm256_shuffle_ps(plt0, plt1, _MM_SHUFFLE(3, 2, 3, 2));
+    r = _mm256_shuffle_ps(prb0, prb1, _MM_SHUFFLE(1, 0, 1, 0));
+    b = _mm256_shuffle_ps(prb0, prb1, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+// Writes the boxes of the registers selected by keep after out_boxes in their original order, returns how many were written
+static inline size_t store_kept_boxes(__m256 l, __m256 t, __m256 r, __m256 b, __m256 keep, const int *labels, BoundingBoxCord *out_boxes, int *out_labels)
+{
+    // Bit of box j in the movemask of a register loaded by load_boxes()
+    static const int LANE_OF_BOX[8] = {0, 4, 1, 5, 2, 6, 3, 7};
+    int mask = _mm256_movemask_ps(keep);
+    if (!mask)
+        return 0;
+    alignas(32) BoundingBoxCord boxes[8];
+    auto dst = reinterpret_cast<float *>(boxes);
+    __m256 plt0 = _mm256_unpacklo_ps(l, t), plt1 = _mm256_unpackhi_ps(l, t);
+    __m256 prb0 = _mm256_unpacklo_ps(r, b), prb1 = _mm256_unpackhi_ps(r, b);
+    _mm256_store_ps(dst, _mm256_shuffle_ps(plt0, prb0, _MM_SHUFFLE(1, 0, 1, 0)));
+    _mm256_store_ps(dst + 8, _mm256_shuffle_ps(plt0, prb0, _MM_SHUFFLE(3, 2, 3, 2)));
+    _mm256_store_ps(dst + 16, _mm256_shuffle_ps(plt1, prb1, _MM_SHUFFLE(1, 0, 1, 0)));
+    _mm256_store_ps(dst + 24, _mm256_shuffle_ps(plt1, prb1, _MM_SHUFFLE(3, 2, 3, 2)));
+    size_t kept = 0;
+    for (unsigned j = 0; j < 8; j++)
+    {
+        if (mask & (1 << LANE_OF_BOX[j]))
+        {
+            out_boxes[kept] = boxes[j];
+            out_labels[kept++] = labels[j];
+        }
+    }
+    return kept;
+}
+#endif
+
+// Runs sample_op on every sample writing its kept boxes at its input offset, one extra slot per sample leaves room
+// for the fallback box, then packs the samples. With masks sample_op is given the box indices as labels, the labels and
+// mask ids of the kept boxes are gathered with them once the samples are packed.
+template <typename SampleOp>
+static void filter_samples(const BoundingBoxBatchData &in, BoundingBoxBatchData &out, bool keep_one, SampleOp sample_op, bool parallel = false)
+{
+    // Built on the calling thread and shared by the threads of the loop
+    const bool masks = in.has_masks();
+    std::vector<int> box_index;
+    if (masks)
+    {
+        box_index.resize(in.labels.size());
+        std::iota(box_index.begin(), box_index.end(), 0);
+    }
+    const size_t sample_count = in.sample_count();
+    out.cords.resize(in.cords.size() + sample_count);
+    out.labels.resize(in.labels.size() + sample_count);
+    out.offsets.resize(sample_count + 1);
+    #pragma omp parallel for if (parallel || in.cords.size() >= PARALLEL_MIN_BOX_COUNT)
+    for (int i = 0; i < static_cast<int>(sample_count); i++)
+    {
+        size_t base = in.offsets[i] + i;
+        const int *labels = masks ? box_index.data() + in.offsets[i] : in.labels_of(i);
+        size_t kept = sample_op(i, in.cords_of(i), labels, in.count(i), out.cords.data() + base, out.labels.data() + base);
+        if (!kept && keep_one)
+        {
+            out.cords[base] = {0, 0, 1, 1};
+            out.labels[base] = masks ? -1 : 0;
+            kept = 1;
+        }
+        out.offsets[i + 1] = kept;
+    }
+    size_t packed = 0;
+    out.offsets[0] = 0;
+    for (size_t i = 0; i < sample_count; i++)
+    {
+        size_t base = in.offsets[i] + i, kept = out.offsets[i + 1];
+        if (base != packed)
+        {
+            // The boxes only ever move to the front, so a forward copy is safe on the overlapping ranges
+            std::copy(out.cords.begin() + base, out.cords.begin() + base + kept, out.cords.begin() + packed);
+            std::copy(out.labels.begin() + base, out.labels.begin() + base + kept, out.labels.begin() + packed);
+        }
+        packed += kept;
+        out.offsets[i + 1] = packed;
+    }
+    out.cords.resize(packed);
+    out.labels.resize(packed);
+    out.masks = in.masks;
+    out.mask_views = in.mask_views;
+    out.mask_ids.resize(masks ? packed : 0);
+    if (masks)
+    {
+        for (size_t k = 0; k < packed; k++)
+        {
+            int index = out.labels[k];
+            out.labels[k] = index < 0 ? 0 : in.labels[index];
+            out.mask_ids[k] = index < 0 ? -1 : in.mask_ids[index];
+        }
+    }
+}
+
+void flip_boxes(BoundingBoxBatchData &bb, const int *flip_axis)
+{
+    // A few cycles per box, it stays on the calling thread whatever the batch size
+    const int sample_count = bb.sample_count();
+    for (int i = 0; i < sample_count; i++)
+    {
+        if (flip_axis[i] != 0 && flip_axis[i] != 1)
+            continue;
+        const bool horizontal = flip_axis[i] == 0;
+        if (bb.has_masks())
+            bb.mask_views[i].flip(horizontal);
+        BoundingBoxCord *boxes = bb.cords_of(i);
+        size_t count = bb.count(i), j = 0;
+#if (ENABLE_SIMD && __AVX2__)
+        // Two boxes per register, <l, t, r, b> becomes <1 - r, t, 1 - l, b> or <l, 1 - b, r, 1 - t>
+        const __m256 pone = _mm256_set1_ps(1.f);
+        for (; j + 2 <= count; j += 2)
+        {
+            auto ptr = reinterpret_cast<float *>(boxes + j);
+            __m256 pbox = _mm256_loadu_ps(ptr);
+            if (horizontal)
+            {
+                __m256 pswapped = _mm256_permute_ps(pbox, _MM_SHUFFLE(3, 0, 1, 2));
+                _mm256_storeu_ps(ptr, _mm256_blend_ps(pswapped, _mm256_sub_ps(pone, pswapped), 0x55));
+            }
+            else
+            {
+                __m256 pswapped = _mm256_permute_ps(pbox, _MM_SHUFFLE(1, 2, 3, 0));
+                _mm256_storeu_ps(ptr, _mm256_blend_ps(pswapped, _mm256_sub_ps(pone, pswapped), 0xAA));
+            }
+        }
+#endif
+        for (; j < count; j++)
+        {
+            auto &box = boxes[j];
+            if (horizontal)
+            {
+                float l = 1 - box.r;
+                box.r = 1 - box.l;
+                box.l = l;
+            }
+            else
+            {
+                float t = 1 - box.b;
+                box.b = 1 - box.t;
+                box.t = t;
+            }
+        }
+    }
+}
+
+static size_t crop_sample(const BoundingBoxCord *boxes, const int *labels, size_t count, const BoxCropWindow &crop, const BoxCropOptions &options,
+                          BoundingBoxCord *out_boxes, int *out_labels)
+{
+    const auto &w = crop.window;
+    const float window_area = (w.b - w.t) * (w.r - w.l);
+    size_t kept = 0, j = 0;
+#if (ENABLE_SIMD && __AVX2__)
+    const __m256 pwl = _mm256_set1_ps(w.l), pwt = _mm256_set1_ps(w.t), pwr = _mm256_set1_ps(w.r), pwb = _mm256_set1_ps(w.b);
+    const __m256 pww = _mm256_set1_ps(w.r - w.l), pwh = _mm256_set1_ps(w.b - w.t), pwarea = _mm256_set1_ps(window_area);
+    const __m256 pmin = _mm256_set1_ps(crop.min_overlap), pmax = _mm256_set1_ps(crop.max_overlap);
+    const __m256 pzero = _mm256_setzero_ps(), pone = _mm256_set1_ps(1.f), phalf = _mm256_set1_ps(0.5f);
+    for (; j + 8 <= count; j += 8)
+    {
+        __m256 pl, pt, pr, pb;
+        load_boxes(boxes + j, pl, pt, pr, pb);
+        __m256 pxa = max_of(pwl, pl), pya = max_of(pwt, pt), pxb = min_of(pwr, pr), pyb = min_of(pwb, pb);
+        __m256 pintersection = _mm256_mul_ps(max_of(pzero, _mm256_sub_ps(pxb, pxa)), max_of(pzero, _mm256_sub_ps(pyb, pya)));
+        __m256 parea = _mm256_mul_ps(_mm256_sub_ps(pb, pt), _mm256_sub_ps(pr, pl));
+        __m256 poverlap = options.overlap_is_iou ? _mm256_div_ps(pintersection, _mm256_sub_ps(_mm256_add_ps(parea, pwarea), pintersection))
+                                                 : _mm256_div_ps(pintersection, parea);
+        __m256 pkeep = _mm256_and_ps(_mm256_cmp_ps(poverlap, pmin, _CMP_GE_OQ), _mm256_cmp_ps(poverlap, pmax, _CMP_LE_OQ));
+        if (options.center_in_window)
+        {
+            __m256 pxc = _mm256_mul_ps(phalf, _mm256_add_ps(pl, pr)), pyc = _mm256_mul_ps(phalf, _mm256_add_ps(pt, pb));
+            pkeep = _mm256_and_ps(pkeep, _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(pxc, pwl, _CMP_GE_OQ), _mm256_cmp_ps(pxc, pwr, _CMP_LE_OQ)),
+                                                       _mm256_and_ps(_mm256_cmp_ps(pyc, pwt, _CMP_GE_OQ), _mm256_cmp_ps(pyc, pwb, _CMP_LE_OQ))));
+        }
+        pl = _mm256_div_ps(_mm256_sub_ps(pxa, pwl), pww);
+        pt = _mm256_div_ps(_mm256_sub_ps(pya, pwt), pwh);
+        pr = _mm256_div_ps(_mm256_sub_ps(pxb, pwl), pww);
+        pb = _mm256_div_ps(_mm256_sub_ps(pyb, pwt), pwh);
+        if (crop.mirror)
+        {
+            __m256 pmirrored_l = _mm256_sub_ps(pone, pr);
+            pr = _mm256_sub_ps(pone, pl);
+            pl = pmirrored_l;
+        }
+        kept += store_kept_boxes(pl, pt, pr, pb, pkeep, labels + j, out_boxes + kept, out_labels + kept);
+    }
+#endif
+    for (; j < count; j++)
+    {
+        const auto &box = boxes[j];
+        float xA = std::max(w.l, box.l), yA = std::max(w.t, box.t), xB = std::min(w.r, box.r), yB = std::min(w.b, box.b);
+        float intersection = std::max(0.f, xB - xA) * std::max(0.f, yB - yA);
+        float area = (box.b - box.t) * (box.r - box.l);
+        float overlap = options.overlap_is_iou ? intersection / (area + window_area - intersection) : intersection / area;
+        if (!(overlap >= crop.min_overlap && overlap <= crop.max_overlap))
+            continue;
+        if (options.center_in_window)
+        {
+            float xc = 0.5f * (box.l + box.r), yc = 0.5f * (box.t + box.b);
+            if (!(xc >= w.l && xc <= w.r && yc >= w.t && yc <= w.b))
+                continue;
+        }
+        BoundingBoxCord out_box;
+        out_box.l = (xA - w.l) / (w.r - w.l);
+        out_box.t = (yA - w.t) / (w.b - w.t);
+        out_box.r = (xB - w.l) / (w.r - w.l);
+        out_box.b = (yB - w.t) / (w.b - w.t);
+        if (crop.mirror)
+        {
+            float l = 1 - out_box.r;
+            out_box.r = 1 - out_box.l;
+            out_box.l = l;
+        }
+        out_boxes[kept] = out_box;
+        out_labels[kept++] = labels[j];
+    }
+    return kept;
+}
+
+bool all_boxes_overlap(const BoundingBoxCord *boxes, size_t count, const BoxCropWindow &crop, bool overlap_is_iou)
+{
+    const auto &w = crop.window;
+    const float window_area = (w.b - w.t) * (w.r - w.l);
+    size_t j = 0;
+#if (ENABLE_SIMD && __AVX2__)
+    const __m256 pwl = _mm256_set1_ps(w.l), pwt = _mm256_set1_ps(w.t), pwr = _mm256_set1_ps(w.r), pwb = _mm256_set1_ps(w.b);
+    const __m256 pwarea = _mm256_set1_ps(window_area), pzero = _mm256_setzero_ps();
+    const __m256 pmin = _mm256_set1_ps(crop.min_overlap), pmax = _mm256_set1_ps(crop.max_overlap);
+    for (; j + 8 <= count; j += 8)
+    {
+        __m256 pl, pt, pr, pb;
+        load_boxes(boxes + j, pl, pt, pr, pb);
+        __m256 pintersection = _mm256_mul_ps(max_of(pzero, _mm256_sub_ps(min_of(pwr, pr), max_of(pwl, pl))),
+                                             max_of(pzero, _mm256_sub_ps(min_of(pwb, pb), max_of(pwt, pt))));
+        __m256 parea = _mm256_mul_ps(_mm256_sub_ps(pb, pt), _mm256_sub_ps(pr, pl));
+        __m256 poverlap = overlap_is_iou ? _mm256_div_ps(pintersection, _mm256_sub_ps(_mm256_add_ps(parea, pwarea), pintersection))
+                                         : _mm256_div_ps(pintersection, parea);
+        // Ordered compares, a NaN overlap does not reject the window
+        if (_mm256_movemask_ps(_mm256_or_ps(_mm256_cmp_ps(poverlap, pmin, _CMP_LT_OQ), _mm256_cmp_ps(poverlap, pmax, _CMP_GT_OQ))))
+            return false;
+    }
+#endif
+    for (; j < count; j++)
+    {
+        const auto &box = boxes[j];
+        float intersection = std::max(0.f, std::min(w.r, box.r) - std::max(w.l, box.l)) * std::max(0.f, std::min(w.b, box.b) - std::max(w.t, box.t));
+        float area = (box.b - box.t) * (box.r - box.l);
+        float overlap = overlap_is_iou ? intersection / (area + window_area - intersection) : intersection / area;
+        if (overlap < crop.min_overlap || overlap > crop.max_overlap)
+            return false;
+    }
+    return true;
+}
+
+bool any_box_center_in(const BoundingBoxCord *boxes, size_t count, const BoundingBoxCord &window, bool strict)
+{
+    size_t j = 0;
+#if (ENABLE_SIMD && __AVX2__)
+    const __m256 pwl = _mm256_set1_ps(window.l), pwt = _mm256_set1_ps(window.t), pwr = _mm256_set1_ps(window.r), pwb = _mm256_set1_ps(window.b);
+    const __m256 phalf = _mm256_set1_ps(0.5f);
+    for (; j + 8 <= count; j += 8)
+    {
+        __m256 pl, pt, pr, pb;
+        load_boxes(boxes + j, pl, pt, pr, pb);
+        __m256 pxc = _mm256_mul_ps(phalf, _mm256_add_ps(pl, pr)), pyc = _mm256_mul_ps(phalf, _mm256_add_ps(pt, pb));
+        __m256 pinside = strict ? _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(pxc, pwl, _CMP_GT_OQ), _mm256_cmp_ps(pxc, pwr, _CMP_LT_OQ)),
+                                                _mm256_and_ps(_mm256_cmp_ps(pyc, pwt, _CMP_GT_OQ), _mm256_cmp_ps(pyc, pwb, _CMP_LT_OQ)))
+                                : _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(pxc, pwl, _CMP_GE_OQ), _mm256_cmp_ps(pxc, pwr, _CMP_LE_OQ)),
+                                                _mm256_and_ps(_mm256_cmp_ps(pyc, pwt, _CMP_GE_OQ), _mm256_cmp_ps(pyc, pwb, _CMP_LE_OQ)));
+        if (_mm256_movemask_ps(pinside))
+            return true;
+    }
+#endif
+    for (; j < count; j++)
+    {
+        float xc = 0.5f * (boxes[j].l + boxes[j].r), yc = 0.5f * (boxes[j].t + boxes[j].b);
+        bool inside = strict ? (xc > window.l && xc < window.r && yc > window.t && yc < window.b)
+                             : (xc >= window.l && xc <= window.r && yc >= window.t && yc <= window.b);
+        if (inside)
+            return true;
+    }
+    return false;
+}
+
+void crop_boxes(const BoundingBoxBatchData &in, BoundingBoxBatchData &out, const BoxCropWindow *windows, const BoxCropOptions &options)
+{
+    filter_samples(in, out, options.keep_one, [&](int i, const BoundingBoxCord *boxes, const int *labels, size_t count, BoundingBoxCord *out_boxes, int *out_labels) {
+        return crop_sample(boxes, labels, count, windows[i], options, out_boxes, out_labels);
+    });
+    for (size_t i = 0; i < out.mask_views.size(); i++)
+        out.mask_views[i].crop(windows[i].window, windows[i].mirror);
+}
+
+void crop_boxes(const BoundingBoxBatchData &in, BoundingBoxBatchData &out, const std::function<BoxCropWindow(int)> &window_of, const BoxCropOptions &options)
+{
+    // The windows may be drawn by window_of(), the mask views are moved by the ones it returned
+    std::vector<BoxCropWindow> windows(in.has_masks() ? in.sample_count() : 0);
+    filter_samples(in, out, options.keep_one, [&](int i, const BoundingBoxCord *boxes, const int *labels, size_t count, BoundingBoxCord *out_boxes, int *out_labels) {
+        BoxCropWindow crop = window_of(i);
+        if (!windows.empty())
+            windows[i] = crop;
+        return crop_sample(boxes, labels, count, crop, options, out_boxes, out_labels);
+    }, true);
+    for (size_t i = 0; i < out.mask_views.size(); i++)
+        out.mask_views[i].crop(windows[i].window, windows[i].mirror);
+}
+
+// Rotation of one sample, the integer image centers are the ones of the rotate augmentation
+struct BoxRotation
+{
+    float m[4];
+    float src_cx, src_cy, dst_cx, dst_cy;
+};
+
+static size_t rotate_sample(const BoundingBoxCord *boxes, const int *labels, size_t count, const BoxRotation &rot, const BoundingBoxCord &dst_image, float min_overlap,
+                            BoundingBoxCord *out_boxes, int *out_labels)
+{
+    size_t kept = 0, j = 0;
+#if (ENABLE_SIMD && __AVX2__)
+    const __m256 pm0 = _mm256_set1_ps(rot.m[0]), pm1 = _mm256_set1_ps(rot.m[1]), pm2 = _mm256_set1_ps(rot.m[2]), pm3 = _mm256_set1_ps(rot.m[3]);
+    const __m256 psrc_cx = _mm256_set1_ps(rot.src_cx), psrc_cy = _mm256_set1_ps(rot.src_cy), pdst_cx = _mm256_set1_ps(rot.dst_cx), pdst_cy = _mm256_set1_ps(rot.dst_cy);
+    const __m256 pdst_r = _mm256_set1_ps(dst_image.r), pdst_b = _mm256_set1_ps(dst_image.b);
+    const __m256 pzero = _mm256_setzero_ps(), pmin_overlap = _mm256_set1_ps(min_overlap);
+    for (; j + 8 <= count; j += 8)
+    {
+        __m256 px, py, pw, ph;
+        load_boxes(boxes + j, px, py, pw, ph);
+        __m256 pdx0 = _mm256_sub_ps(px, psrc_cx), pdx1 = _mm256_sub_ps(_mm256_add_ps(px, pw), psrc_cx);
+        __m256 pdy0 = _mm256_sub_ps(py, psrc_cy), pdy1 = _mm256_sub_ps(_mm256_add_ps(py, ph), psrc_cy);
+        // Corners (x0, y0), (x1, y0), (x0, y1), (x1, y1) of the box in the destination image
+        __m256 px1 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pm0, pdx0), _mm256_mul_ps(pm1, pdy0)), pdst_cx);
+        __m256 py1 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pm2, pdx0), _mm256_mul_ps(pm3, pdy0)), pdst_cy);
+        __m256 px2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pm0, pdx1), _mm256_mul_ps(pm1, pdy0)), pdst_cx);
+        __m256 py2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pm2, pdx1), _mm256_mul_ps(pm3, pdy0)), pdst_cy);
+        __m256 px3 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pm0, pdx0), _mm256_mul_ps(pm1, pdy1)), pdst_cx);
+        __m256 py3 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pm2, pdx0), _mm256_mul_ps(pm3, pdy1)), pdst_cy);
+        __m256 px4 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pm0, pdx1), _mm256_mul_ps(pm1, pdy1)), pdst_cx);
+        __m256 py4 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pm2, pdx1), _mm256_mul_ps(pm3, pdy1)), pdst_cy);
+        __m256 pl = max_of(min_of(px1, min_of(px2, min_of(px3, px4))), pzero);
+        __m256 pt = max_of(min_of(py1, min_of(py2, min_of(py3, py4))), pzero);
+        __m256 pr = max_of(px1, max_of(px2, max_of(px3, px4)));
+        __m256 pb = max_of(py1, max_of(py2, max_of(py3, py4)));
+        __m256 pxa = max_of(pzero, pl), pya = max_of(pzero, pt), pxb = min_of(pdst_r, pr), pyb = min_of(pdst_b, pb);
+        __m256 pintersection = _mm256_mul_ps(max_of(pzero, _mm256_sub_ps(pxb, pxa)), max_of(pzero, _mm256_sub_ps(pyb, pya)));
+        __m256 parea = _mm256_mul_ps(_mm256_sub_ps(pb, pt), _mm256_sub_ps(pr, pl));
+        __m256 pkeep = _mm256_cmp_ps(_mm256_div_ps(pintersection, parea), pmin_overlap, _CMP_GE_OQ);
+        kept += store_kept_boxes(pxa, pya, pxb, pyb, pkeep, labels + j, out_boxes + kept, out_labels + kept);
+    }
+#endif
+    for (; j < count; j++)
+    {
+        float x = boxes[j].l, y = boxes[j].t, w = boxes[j].r, h = boxes[j].b;
+        float x1 = (rot.m[0] * (x - rot.src_cx)) + (rot.m[1] * (y - rot.src_cy)) + rot.dst_cx;
+        float y1 = (rot.m[2] * (x - rot.src_cx)) + (rot.m[3] * (y - rot.src_cy)) + rot.dst_cy;
+        float x2 = (rot.m[0] * ((x + w) - rot.src_cx)) + (rot.m[1] * (y - rot.src_cy)) + rot.dst_cx;
+        float y2 = (rot.m[2] * ((x + w) - rot.src_cx)) + (rot.m[3] * (y - rot.src_cy)) + rot.dst_cy;
+        float x3 = (rot.m[0] * (x - rot.src_cx)) + (rot.m[1] * ((y + h) - rot.src_cy)) + rot.dst_cx;
+        float y3 = (rot.m[2] * (x - rot.src_cx)) + (rot.m[3] * ((y + h) - rot.src_cy)) + rot.dst_cy;
+        float x4 = (rot.m[0] * ((x + w) - rot.src_cx)) + (rot.m[1] * ((y + h) - rot.src_cy)) + rot.dst_cx;
+        float y4 = (rot.m[2] * ((x + w) - rot.src_cx)) + (rot.m[3] * ((y + h) - rot.src_cy)) + rot.dst_cy;
+        BoundingBoxCord box;
+        box.l = std::max(std::min(x1, std::min(x2, std::min(x3, x4))), 0.0f);
+        box.t = std::max(std::min(y1, std::min(y2, std::min(y3, y4))), 0.0f);
+        box.r = std::max(x1, std::max(x2, std::max(x3, x4)));
+        box.b = std::max(y1, std::max(y2, std::max(y3, y4)));
+        float xA = std::max(dst_image.l, box.l), yA = std::max(dst_image.t, box.t), xB = std::min(dst_image.r, box.r), yB = std::min(dst_image.b, box.b);
+        float intersection = std::max(0.f, xB - xA) * std::max(0.f, yB - yA);
+        float area = (box.b - box.t) * (box.r - box.l);
+        if (intersection / area >= min_overlap)
+        {
+            out_boxes[kept] = {xA, yA, xB, yB};
+            out_labels[kept++] = labels[j];
+        }
+    }
+    return kept;
+}
+
+void rotate_boxes(const BoundingBoxBatchData &in, BoundingBoxBatchData &out, const float *angles, const uint32_t *src_width, const uint32_t *src_height,
+                  uint32_t dst_width, uint32_t dst_height, float min_overlap)
+{
+    const BoundingBoxCord dst_image = {0, 0, static_cast<float>(dst_width), static_cast<float>(dst_height)};
+    filter_samples(in, out, true, [&](int i, const BoundingBoxCord *boxes, const int *labels, size_t count, BoundingBoxCord *out_boxes, int *out_labels) {
+        BoxRotation rot;
+        float radian = RAD(angles[i]);
+        rot.m[0] = rot.m[3] = cos(radian);
+        rot.m[1] = sin(radian);
+        rot.m[2] = -1 * rot.m[1];
+        rot.src_cx = src_width[i] / 2;
+        rot.src_cy = src_height[i] / 2;
+        rot.dst_cx = dst_width / 2;
+        rot.dst_cy = dst_height / 2;
+        return rotate_sample(boxes, labels, count, rot, dst_image, min_overlap, out_boxes, out_labels);
+    });
+    // The output pixel p comes from the source pixel M^T (p - dst_center) + src_center, written in normalized coordinates
+    for (size_t i = 0; i < out.mask_views.size(); i++)
+    {
+        float radian = RAD(angles[i]);
+        float c = cos(radian), s = sin(radian);
+        float sw = src_width[i], sh = src_height[i], dw = dst_width, dh = dst_height;
+        float scx = src_width[i] / 2, scy = src_height[i] / 2, dcx = dst_width / 2, dcy = dst_height / 2;
+        out.mask_views[i].then({c * dw / sw, -s * dh / sw, (-c * dcx + s * dcy + scx) / sw,
+                                s * dw / sh, c * dh / sh, (-s * dcx - c * dcy + scy) / sh});
+    }
+}
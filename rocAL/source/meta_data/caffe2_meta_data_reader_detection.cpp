@@ -66,6 +66,7 @@ void Caffe2MetaDataReaderDetection::lookup(const std::vector<std::string> &_imag
     }
     if (_image_names.size() != (unsigned)_output->size())
         _output->resize(_image_names.size());
+    _output->get_bb_batch().clear();
 
     for (unsigned i = 0; i < _image_names.size(); i++)
     {
@@ -73,8 +74,7 @@ void Caffe2MetaDataReaderDetection::lookup(const std::vector<std::string> &_imag
         auto it = _map_content.find(image_name);
         if (_map_content.end() == it)
             THROW("ERROR: Given name not present in the map" + image_name)
-        _output->get_bb_cords_batch()[i] = it->second->get_bb_cords();
-        _output->get_bb_labels_batch()[i] = it->second->get_bb_labels();
+        _output->get_bb_batch().append_sample(it->second->get_bb_cords(), it->second->get_bb_labels());
         _output->get_img_sizes_batch()[i] = it->second->get_img_size();
     }
 }
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include <iostream>
 #include <utility>
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include "lookahead_parser.h"
 
@@ -33,6 +34,8 @@ void COCOMetaDataReader::init(const MetaDataConfig &cfg)
 {
     _path = cfg.path();
     _output = new BoundingBoxBatch();
+    if (cfg.type() == MetaDataType::PolygonMask)
+        _masks = std::make_shared<MaskStore>();
 }
 
 bool COCOMetaDataReader::exists(const std::string &image_name)
@@ -48,8 +51,12 @@ void COCOMetaDataReader::lookup(const std::vector<std::string> &image_names)
         WRN("No image names passed")
         return;
     }
+    // The masks are only referenced by the batch, they are decoded when they are emitted
+    _output->get_bb_batch().masks = _masks;
     if (image_names.size() != (unsigned)_output->size())
         _output->resize(image_names.size());
+    _output->get_bb_batch().clear();
+    _output->get_fields().reset(_fields);
 
     for (unsigned i = 0; i < image_names.size(); i++)
     {
@@ -57,25 +64,105 @@ void COCOMetaDataReader::lookup(const std::vector<std::string> &image_names)
         auto it = _map_content.find(image_name);
         if (_map_content.end() == it)
             THROW("ERROR: Given name not present in the map" + image_name)
-        _output->get_bb_cords_batch()[i] = it->second->get_bb_cords();
-        _output->get_bb_labels_batch()[i] = it->second->get_bb_labels();
+        _output->get_bb_batch().append_sample(it->second->get_bb_cords(), it->second->get_bb_labels(), _masks ? it->second->get_mask_ids().data() : nullptr);
         _output->get_img_sizes_batch()[i] = it->second->get_img_size();
+        _output->get_fields().add_row(_fields, it->second->get_field_row());
     }
 }
 
-void COCOMetaDataReader::add(std::string image_name, BoundingBoxCords bb_coords, BoundingBoxLabels bb_labels, ImgSize image_size)
+void COCOMetaDataReader::add(std::string image_name, BoundingBoxCords bb_coords, BoundingBoxLabels bb_labels, ImgSize image_size, int mask_id)
 {
     if (exists(image_name))
     {
         auto it = _map_content.find(image_name);
         it->second->get_bb_cords().push_back(bb_coords[0]);
         it->second->get_bb_labels().push_back(bb_labels[0]);
+        if (_masks)
+            it->second->get_mask_ids().push_back(mask_id);
         return;
     }
     pMetaDataBox info = std::make_shared<BoundingBox>(bb_coords, bb_labels, image_size);
+    if (_masks)
+        info->get_mask_ids().push_back(mask_id);
     _map_content.insert(pair<std::string, std::shared_ptr<BoundingBox>>(image_name, info));
 }
 
+// Appends the segmentation of an annotation to the store, the polygons are in pixels until the size of their image is known
+static int read_segmentation(LookaheadParser &parser, MaskStore &store)
+{
+    MaskStore::Entry entry = {};
+    if (parser.PeekType() == kArrayType)
+    {
+        entry.kind = MaskStore::Kind::Polygons;
+        entry.first = store.polygon_offsets.size() - 1;
+        parser.EnterArray();
+        while (parser.NextArrayValue())
+        {
+            if (parser.PeekType() != kArrayType)
+            {
+                parser.SkipValue();
+                continue;
+            }
+            parser.EnterArray();
+            while (parser.NextArrayValue())
+                store.points.push_back(parser.GetDouble());
+            store.points.resize(store.points.size() & ~size_t(1));
+            store.polygon_offsets.push_back(store.points.size() / 2);
+            entry.count++;
+        }
+    }
+    else if (parser.PeekType() == kObjectType)
+    {
+        parser.EnterObject();
+        while (const char *key = parser.NextObjectKey())
+        {
+            if (0 == std::strcmp(key, "counts") && parser.PeekType() == kStringType)
+            {
+                const char *chars = parser.GetString();
+                entry.kind = MaskStore::Kind::RleString;
+                entry.first = store.rle_chars.size();
+                entry.count = std::strlen(chars);
+                store.rle_chars.append(chars);
+            }
+            else if (0 == std::strcmp(key, "counts") && parser.PeekType() == kArrayType)
+            {
+                entry.kind = MaskStore::Kind::RleCounts;
+                entry.first = store.rle_counts.size();
+                parser.EnterArray();
+                while (parser.NextArrayValue())
+                    store.rle_counts.push_back(parser.GetInt());
+                entry.count = store.rle_counts.size() - entry.first;
+            }
+            else if (0 == std::strcmp(key, "size") && parser.PeekType() == kArrayType)
+            {
+                // [height, width]
+                uint32_t size[2] = {};
+                int i = 0;
+                parser.EnterArray();
+                while (parser.NextArrayValue())
+                {
+                    int value = parser.GetInt();
+                    if (i < 2)
+                        size[i++] = value;
+                }
+                entry.height = size[0];
+                entry.width = size[1];
+            }
+            else
+            {
+                parser.SkipValue();
+            }
+        }
+    }
+    else
+    {
+        parser.SkipValue();
+        return -1;
+    }
+    store.entries.push_back(entry);
+    return store.entries.size() - 1;
+}
+
 void COCOMetaDataReader::print_map_contents()
 {
     BoundingBoxCords bb_coords;
@@ -139,6 +226,7 @@ void COCOMetaDataReader::read_all(const std::string &path)
             while (parser.NextArrayValue())
             {
                 string image_name;
+                int image_id = -1;
                 if (parser.PeekType() != kObjectType)
                 {
                     continue;
@@ -158,12 +246,17 @@ void COCOMetaDataReader::read_all(const std::string &path)
                     {
                         image_name = parser.GetString();
                     }
+                    else if (0 == std::strcmp(internal_key, "id"))
+                    {
+                        image_id = parser.GetInt();
+                    }
                     else
                     {
                         parser.SkipValue();
                     }
                 }
                 _map_img_sizes.insert(pair<std::string, ImgSize>(image_name, img_size));
+                _map_img_ids.insert(pair<std::string, int>(image_name, image_id));
                 img_size = {};
             }
         }
@@ -200,7 +293,7 @@ void COCOMetaDataReader::read_all(const std::string &path)
             parser.EnterArray();
             while (parser.NextArrayValue())
             {
-                int id = 1, label = 0;
+                int id = 1, label = 0, mask_id = -1;
                 std::array<float, 4> bbox = {};
                 if (parser.PeekType() != kObjectType)
                 {
@@ -228,6 +321,10 @@ void COCOMetaDataReader::read_all(const std::string &path)
                             ++i;
                         }
                     }
+                    else if (0 == std::strcmp(internal_key, "segmentation") && _masks)
+                    {
+                        mask_id = read_segmentation(parser, *_masks);
+                    }
                     else
                     {
                         parser.SkipValue();
@@ -246,7 +343,25 @@ void COCOMetaDataReader::read_all(const std::string &path)
                 box.b = (bbox[1] + bbox[3]) / image_size.h;
                 bb_coords.push_back(box);
                 bb_labels.push_back(label);
-                add(file_name, bb_coords, bb_labels, image_size);
+                if (mask_id >= 0)
+                {
+                    // Polygons are normalized like the boxes, a run-length encoding without a size is for the whole image
+                    auto &entry = _masks->entries[mask_id];
+                    if (entry.kind == MaskStore::Kind::Polygons)
+                    {
+                        for (uint32_t k = _masks->polygon_offsets[entry.first]; k < _masks->polygon_offsets[entry.first + entry.count]; k++)
+                        {
+                            _masks->points[2 * k] /= image_size.w;
+                            _masks->points[2 * k + 1] /= image_size.h;
+                        }
+                    }
+                    else if (!entry.width || !entry.height)
+                    {
+                        entry.width = image_size.w;
+                        entry.height = image_size.h;
+                    }
+                }
+                add(file_name, bb_coords, bb_labels, image_size, mask_id);
                 bb_coords.clear();
                 bb_labels.clear();
                 image_size = {};
@@ -257,8 +372,14 @@ void COCOMetaDataReader::read_all(const std::string &path)
             parser.SkipValue();
         }
     }
+    // The image ids are given as an extra field, the evaluation of the detections needs them
+    auto &image_ids = _fields.column("image_id", MetaDataFieldType::INT32, 1);
     for (auto &elem : _map_content)
     {
+        auto id_it = _map_img_ids.find(elem.first);
+        int image_id = id_it != _map_img_ids.end() ? id_it->second : -1;
+        elem.second->set_field_row(image_ids.sample_count());
+        image_ids.add(&image_id, 1);
         bb_coords = elem.second->get_bb_cords();
         bb_labels = elem.second->get_bb_labels();
         BoundingBoxLabels continuous_label_id;
@@ -289,6 +410,11 @@ void COCOMetaDataReader::release()
 {
     _map_content.clear();
     _map_img_sizes.clear();
+    _map_img_ids.clear();
+    _fields = {};
+    // Batches still in the ring buffer keep the store they reference
+    if (_masks)
+        _masks = std::make_shared<MaskStore>();
 }
 
 COCOMetaDataReader::COCOMetaDataReader() : _coco_metadata_read_time("coco meta read time", DBG_TIMING)
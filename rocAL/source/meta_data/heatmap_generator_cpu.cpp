@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "heatmap_generator_cpu.h"
+#include "exception.h"
+
+HeatmapGeneratorCpu::HeatmapGeneratorCpu(size_t batch_size, unsigned image_width, unsigned image_height, unsigned heatmap_width, unsigned heatmap_height, float sigma):
+        _batch_size(batch_size),
+        _image_width(image_width),
+        _image_height(image_height),
+        _heatmap_width(heatmap_width),
+        _heatmap_height(heatmap_height)
+{
+    if (!image_width || !image_height || !heatmap_width || !heatmap_height || sigma <= 0.f)
+        THROW("HeatmapTargets invalid input parameter, the pose output size, heatmap size and sigma must be positive")
+    _feat_stride_x = static_cast<float>(image_width) / heatmap_width;
+    _feat_stride_y = static_cast<float>(image_height) / heatmap_height;
+    _patch_radius = sigma * 3;
+    // The reference takes the center of the patch from the unrounded size, so it is off the middle when 6 * sigma is not an integer
+    const float size = 2 * _patch_radius + 1;
+    _patch_size = static_cast<int>(std::ceil(size));
+    const int center = static_cast<int>(std::floor(size / 2));
+    _patch.resize(_patch_size * _patch_size);
+    for (int y = 0; y < _patch_size; y++)
+        for (int x = 0; x < _patch_size; x++)
+            _patch[y * _patch_size + x] = std::exp(-static_cast<float>((x - center) * (x - center) + (y - center) * (y - center)) / (2 * sigma * sigma));
+}
+
+float HeatmapGeneratorCpu::render_joint(float x, float y, float visibility, float *heatmap) const
+{
+    const int hm_w = _heatmap_width, hm_h = _heatmap_height;
+    int mu_x = static_cast<int>(x / _feat_stride_x + 0.5f);
+    int mu_y = static_cast<int>(y / _feat_stride_y + 0.5f);
+    // Corners of the patch, a joint whose patch is entirely outside the heatmap is not trained on
+    int ul_x = static_cast<int>(mu_x - _patch_radius), ul_y = static_cast<int>(mu_y - _patch_radius);
+    int br_x = static_cast<int>(mu_x + _patch_radius + 1), br_y = static_cast<int>(mu_y + _patch_radius + 1);
+    if (ul_x >= hm_w || ul_y >= hm_h || br_x < 0 || br_y < 0)
+        return 0.f;
+    if (visibility > 0.5f)
+    {
+        int x0 = std::max(0, ul_x), x1 = std::min(std::min(br_x, hm_w), ul_x + _patch_size);
+        int y0 = std::max(0, ul_y), y1 = std::min(std::min(br_y, hm_h), ul_y + _patch_size);
+        for (int row = y0; row < y1; row++)
+            memcpy(heatmap + row * hm_w + x0, _patch.data() + (row - ul_y) * _patch_size + (x0 - ul_x), (x1 - x0) * sizeof(float));
+    }
+    return visibility;
+}
+
+void HeatmapGeneratorCpu::Run(pMetaDataBatch full_batch_meta_data, float *heatmaps, float *target_weights)
+{
+    const auto &joints_data = full_batch_meta_data->get_joints_data_batch();
+    const size_t sample_count = joints_data.joints_batch.size();
+    if (sample_count > _batch_size)
+        THROW("HeatmapTargets got " + TOSTR(sample_count) + " samples for a batch of " + TOSTR(_batch_size))
+    const size_t heatmap_size = static_cast<size_t>(_heatmap_width) * _heatmap_height;
+    // Samples missing from a partial batch are left empty
+    const size_t rendered = sample_count * NUMBER_OF_JOINTS;
+    memset(heatmaps + rendered * heatmap_size, 0, (heatmaps_size() - rendered * heatmap_size) * sizeof(float));
+    memset(target_weights + rendered, 0, (target_weights_size() - rendered) * sizeof(float));
+    // Each heatmap is cleared by the thread rendering it
+    #pragma omp parallel for
+    for (int idx = 0; idx < static_cast<int>(sample_count * NUMBER_OF_JOINTS); idx++)
+    {
+        const size_t i = idx / NUMBER_OF_JOINTS, j = idx % NUMBER_OF_JOINTS;
+        const auto &joints = joints_data.joints_batch[i];
+        const auto &visibility = joints_data.joints_visibility_batch[i];
+        memset(heatmaps + idx * heatmap_size, 0, heatmap_size * sizeof(float));
+        target_weights[idx] = 0.f;
+        if (j >= joints.size() || j >= visibility.size())
+            continue;
+        // Affine transform of the person box to the pose output image, a similarity rotating by -rotation around its center
+        const auto &center = joints_data.center_batch[i];
+        const auto &scale = joints_data.scale_batch[i];
+        const float rotation = joints_data.rotation_batch.size() > i ? joints_data.rotation_batch[i] : 0.f;
+        const float ratio = _image_width / (scale[0] * PIXEL_STD);
+        const float radian = rotation * static_cast<float>(M_PI) / 180.f;
+        const float cos_r = ratio * std::cos(radian), sin_r = ratio * std::sin(radian);
+        const float dx = joints[j][0] - center[0], dy = joints[j][1] - center[1];
+        const float x = cos_r * dx + sin_r * dy + 0.5f * _image_width;
+        const float y = -sin_r * dx + cos_r * dy + 0.5f * _image_height;
+        target_weights[idx] = render_joint(x, y, visibility[j][0], heatmaps + idx * heatmap_size);
+    }
+}
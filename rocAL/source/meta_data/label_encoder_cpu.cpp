@@ -0,0 +1,187 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <algorithm>
+#include "label_encoder_cpu.h"
+#include "exception.h"
+
+LabelEncoderCpu::LabelEncoderCpu(size_t batch_size, unsigned num_classes, float on_value, float off_value, float mixup_alpha, float cutmix_alpha, float mix_probability, unsigned seed):
+        _batch_size(batch_size),
+        _num_classes(num_classes),
+        _on_value(on_value),
+        _off_value(off_value),
+        _mixup_alpha(mixup_alpha),
+        _cutmix_alpha(cutmix_alpha),
+        _mix_probability(mix_probability),
+        _rng(seed)
+{
+    if (!num_classes)
+        THROW("LabelEncoder invalid input parameter, the number of classes must be positive")
+    if (mixup_alpha < 0 || cutmix_alpha < 0 || mix_probability < 0 || mix_probability > 1)
+        THROW("LabelEncoder invalid input parameter, the alphas must not be negative and the mix probability must be in [0, 1]")
+    if (is_mixing())
+        _unmixed.resize(targets_size());
+}
+
+int LabelEncoderCpu::class_of(int label) const
+{
+    if (label > 0 && label <= static_cast<int>(_num_classes))
+        return label - 1;
+    if (label == 0)
+        return _num_classes - 1;
+    return -1;
+}
+
+float LabelEncoderCpu::beta(float alpha)
+{
+    std::gamma_distribution<float> gamma(alpha, 1.f);
+    float x = gamma(_rng), y = gamma(_rng);
+    return (x + y) > 0 ? x / (x + y) : 1.f;
+}
+
+void LabelEncoderCpu::Run(pMetaDataBatch full_batch_meta_data, float *targets, float *mix_params)
+{
+    const auto &labels = full_batch_meta_data->get_label_batch();
+    const auto &bb = full_batch_meta_data->get_bb_batch();
+    const size_t sample_count = labels.empty() ? bb.sample_count() : labels.size();
+    if (sample_count > _batch_size)
+        THROW("LabelEncoder got " + TOSTR(sample_count) + " samples for a batch of " + TOSTR(_batch_size))
+    const size_t n = _num_classes;
+    float *encoded = is_mixing() ? _unmixed.data() : targets;
+    std::fill(encoded, encoded + sample_count * n, _off_value);
+    std::fill(targets + sample_count * n, targets + targets_size(), 0.f);
+    for (size_t i = 0; i < sample_count; i++)
+    {
+        if (!labels.empty())
+        {
+            int c = class_of(labels[i]);
+            if (c >= 0)
+                encoded[i * n + c] = _on_value;
+            continue;
+        }
+        // Multi-hot of the classes of the boxes
+        const int *box_labels = bb.labels_of(i);
+        for (size_t j = 0; j < bb.count(i); j++)
+        {
+            int c = class_of(box_labels[j]);
+            if (c >= 0)
+                encoded[i * n + c] = _on_value;
+        }
+    }
+    for (size_t i = 0; i < _batch_size; i++)
+    {
+        float *params = mix_params + i * MIX_PARAM_COUNT;
+        params[0] = i;
+        params[1] = 1.f;
+        params[2] = params[3] = params[4] = params[5] = 0.f;
+    }
+    if (!is_mixing())
+        return;
+
+    // Each sample is mixed with the one at its index in a shuffle of the batch, as the training frameworks do
+    std::vector<unsigned> partners(sample_count);
+    std::iota(partners.begin(), partners.end(), 0);
+    std::shuffle(partners.begin(), partners.end(), _rng);
+    std::uniform_real_distribution<float> uniform(0.f, 1.f);
+    for (size_t i = 0; i < sample_count; i++)
+    {
+        float *params = mix_params + i * MIX_PARAM_COUNT;
+        const size_t partner = partners[i];
+        float weight = 1.f;
+        if (partner != i && uniform(_rng) < _mix_probability)
+        {
+            bool cutmix = _cutmix_alpha > 0 && (_mixup_alpha <= 0 || uniform(_rng) < 0.5f);
+            weight = beta(cutmix ? _cutmix_alpha : _mixup_alpha);
+            if (cutmix)
+            {
+                // Box of 1 - weight of the area around a random center, the weight is then the part left after clipping
+                float cut = std::sqrt(1.f - weight);
+                float cx = uniform(_rng), cy = uniform(_rng);
+                params[2] = std::max(cx - cut / 2, 0.f);
+                params[3] = std::max(cy - cut / 2, 0.f);
+                params[4] = std::min(cx + cut / 2, 1.f);
+                params[5] = std::min(cy + cut / 2, 1.f);
+                weight = 1.f - (params[4] - params[2]) * (params[5] - params[3]);
+            }
+            params[0] = partner;
+            params[1] = weight;
+        }
+        const float *own = encoded + i * n, *other = encoded + partner * n;
+        for (size_t c = 0; c < n; c++)
+            targets[i * n + c] = weight * own[c] + (1.f - weight) * other[c];
+    }
+}
+
+void LabelEncoderCpu::mix_images(const float *mix_params, const std::vector<void *> &buffers, unsigned width, unsigned height, unsigned channels, bool planar,
+                                 const std::vector<std::vector<uint32_t>> &roi_width, const std::vector<std::vector<uint32_t>> &roi_height)
+{
+    const size_t sample_size = static_cast<size_t>(width) * height * channels;
+    _unmixed_images.resize(sample_size * _batch_size);
+    for (size_t b = 0; b < buffers.size(); b++)
+    {
+        auto *images = static_cast<unsigned char *>(buffers[b]);
+        memcpy(_unmixed_images.data(), images, _unmixed_images.size());
+        #pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < _batch_size; i++)
+        {
+            const float *params = mix_params + i * MIX_PARAM_COUNT;
+            const float weight = params[1];
+            if (weight >= 1.f)
+                continue;
+            unsigned char *dst = images + i * sample_size;
+            const unsigned char *src = _unmixed_images.data() + static_cast<size_t>(params[0]) * sample_size;
+            if (params[4] <= params[2] || params[5] <= params[3])
+            {
+                const unsigned char *own = _unmixed_images.data() + i * sample_size;
+                for (size_t k = 0; k < sample_size; k++)
+                    dst[k] = static_cast<unsigned char>(weight * own[k] + (1.f - weight) * src[k] + 0.5f);
+                continue;
+            }
+            // The box is relative to the part of the sample the image uses
+            size_t w = b < roi_width.size() && i < roi_width[b].size() ? roi_width[b][i] : width;
+            size_t h = b < roi_height.size() && i < roi_height[b].size() ? roi_height[b][i] : height;
+            size_t x0 = std::lround(params[2] * w), x1 = std::min<size_t>(std::lround(params[4] * w), width);
+            size_t y0 = std::lround(params[3] * h), y1 = std::min<size_t>(std::lround(params[5] * h), height);
+            if (x1 <= x0)
+                continue;
+            for (size_t y = y0; y < y1; y++)
+            {
+                if (planar)
+                {
+                    for (size_t c = 0; c < channels; c++)
+                    {
+                        size_t offset = (c * height + y) * width + x0;
+                        memcpy(dst + offset, src + offset, x1 - x0);
+                    }
+                }
+                else
+                {
+                    size_t offset = (y * width + x0) * channels;
+                    memcpy(dst + offset, src + offset, (x1 - x0) * channels);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,262 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "mask_transform_cpu.h"
+
+// Inverse of a mask view, maps normalized source coordinates to the output sample. False when the view is degenerate.
+static bool invert_view(const MaskView &view, float inverse[6])
+{
+    const float *m = view.m;
+    float det = m[0] * m[4] - m[1] * m[3];
+    if (det == 0)
+        return false;
+    inverse[0] = m[4] / det;
+    inverse[1] = -m[1] / det;
+    inverse[3] = -m[3] / det;
+    inverse[4] = m[0] / det;
+    inverse[2] = -(inverse[0] * m[2] + inverse[1] * m[5]);
+    inverse[5] = -(inverse[3] * m[2] + inverse[4] * m[5]);
+    return true;
+}
+
+// Sutherland-Hodgman clipping of a polygon of x, y pairs to the unit square, in place
+static void clip_to_unit_square(std::vector<float> &polygon, std::vector<float> &clipped)
+{
+    for (int edge = 0; edge < 4 && !polygon.empty(); edge++)
+    {
+        const int axis = edge & 1;
+        const float bound = edge < 2 ? 0.f : 1.f;
+        auto inside = [&](const float *vertex) { return edge < 2 ? vertex[axis] >= bound : vertex[axis] <= bound; };
+        const size_t count = polygon.size() / 2;
+        clipped.clear();
+        for (size_t k = 0; k < count; k++)
+        {
+            const float *cur = &polygon[2 * k], *prev = &polygon[2 * ((k + count - 1) % count)];
+            if (inside(cur) != inside(prev))
+            {
+                float t = (bound - prev[axis]) / (cur[axis] - prev[axis]);
+                float crossing[2] = {prev[0] + t * (cur[0] - prev[0]), prev[1] + t * (cur[1] - prev[1])};
+                crossing[axis] = bound;
+                clipped.insert(clipped.end(), crossing, crossing + 2);
+            }
+            if (inside(cur))
+                clipped.insert(clipped.end(), cur, cur + 2);
+        }
+        polygon.swap(clipped);
+    }
+}
+
+void mask_polygons(const BoundingBoxBatchData &bb, MaskPolygonBatch &out)
+{
+    out.polygon_counts.assign(bb.cords.size(), 0);
+    out.vertex_counts.clear();
+    out.points.clear();
+    if (!bb.has_masks())
+        return;
+    const MaskStore &store = *bb.masks;
+    std::vector<float> polygon, clipped;
+    for (size_t i = 0; i < bb.sample_count(); i++)
+    {
+        float inverse[6];
+        if (!invert_view(bb.mask_views[i], inverse))
+            continue;
+        for (size_t j = bb.offsets[i]; j < bb.offsets[i + 1]; j++)
+        {
+            if (bb.mask_ids[j] < 0)
+                continue;
+            const auto &entry = store.entries[bb.mask_ids[j]];
+            if (entry.kind != MaskStore::Kind::Polygons)
+                continue;
+            for (uint32_t p = entry.first; p < entry.first + entry.count; p++)
+            {
+                polygon.clear();
+                for (uint32_t k = store.polygon_offsets[p]; k < store.polygon_offsets[p + 1]; k++)
+                {
+                    float x = store.points[2 * k], y = store.points[2 * k + 1];
+                    polygon.push_back(inverse[0] * x + inverse[1] * y + inverse[2]);
+                    polygon.push_back(inverse[3] * x + inverse[4] * y + inverse[5]);
+                }
+                clip_to_unit_square(polygon, clipped);
+                if (polygon.size() < 6)
+                    continue;
+                out.points.insert(out.points.end(), polygon.begin(), polygon.end());
+                out.vertex_counts.push_back(polygon.size() / 2);
+                out.polygon_counts[j]++;
+            }
+        }
+    }
+}
+
+// Fills the pixels whose center is inside one of the polygons of the mask, each polygon by the even-odd rule
+static void fill_polygons(const MaskStore &store, const MaskStore::Entry &entry, const float inverse[6], unsigned width, unsigned height, uint8_t *mask,
+                          std::vector<float> &vertices, std::vector<float> &crossings)
+{
+    for (uint32_t p = entry.first; p < entry.first + entry.count; p++)
+    {
+        vertices.clear();
+        float top = INFINITY, bottom = -INFINITY;
+        for (uint32_t k = store.polygon_offsets[p]; k < store.polygon_offsets[p + 1]; k++)
+        {
+            float x = store.points[2 * k], y = store.points[2 * k + 1];
+            float py = (inverse[3] * x + inverse[4] * y + inverse[5]) * height;
+            vertices.push_back((inverse[0] * x + inverse[1] * y + inverse[2]) * width);
+            vertices.push_back(py);
+            top = std::min(top, py);
+            bottom = std::max(bottom, py);
+        }
+        const size_t count = vertices.size() / 2;
+        if (count < 3)
+            continue;
+        // Rows whose center is in [top, bottom)
+        int first_row = std::max(0, static_cast<int>(std::ceil(top - 0.5f)));
+        int last_row = std::min(static_cast<int>(height), static_cast<int>(std::ceil(bottom - 0.5f)));
+        for (int y = first_row; y < last_row; y++)
+        {
+            const float yc = y + 0.5f;
+            crossings.clear();
+            for (size_t k = 0; k < count; k++)
+            {
+                const float *a = &vertices[2 * ((k + count - 1) % count)], *b = &vertices[2 * k];
+                if ((a[1] <= yc) != (b[1] <= yc))
+                    crossings.push_back(a[0] + (yc - a[1]) * (b[0] - a[0]) / (b[1] - a[1]));
+            }
+            std::sort(crossings.begin(), crossings.end());
+            for (size_t c = 0; c + 1 < crossings.size(); c += 2)
+            {
+                int x0 = std::max(0, static_cast<int>(std::ceil(crossings[c] - 0.5f)));
+                int x1 = std::min(static_cast<int>(width), static_cast<int>(std::ceil(crossings[c + 1] - 0.5f)));
+                if (x0 < x1)
+                    memset(mask + static_cast<size_t>(y) * width + x0, 1, x1 - x0);
+            }
+        }
+    }
+}
+
+// Decodes the run-length encoding in its image, then samples it at the output pixel centers through the view
+static void fill_rle(const MaskStore &store, const MaskStore::Entry &entry, const MaskView &view, unsigned width, unsigned height, uint8_t *mask,
+                     std::vector<uint32_t> &counts, std::vector<uint8_t> &bitmap)
+{
+    const uint32_t *runs = store.rle_counts.data() + entry.first;
+    size_t run_count = entry.count;
+    if (entry.kind == MaskStore::Kind::RleString)
+    {
+        counts.clear();
+        decode_rle_string(store.rle_chars.data() + entry.first, entry.count, counts);
+        runs = counts.data();
+        run_count = counts.size();
+    }
+    const size_t src_width = entry.width, src_height = entry.height, src_size = src_width * src_height;
+    bitmap.assign(src_size, 0);
+    size_t pos = 0;
+    for (size_t r = 0; r < run_count && pos < src_size; r++)
+    {
+        size_t length = std::min<size_t>(runs[r], src_size - pos);
+        if (r & 1)
+            memset(bitmap.data() + pos, 1, length);
+        pos += length;
+    }
+    const float *m = view.m;
+    for (unsigned y = 0; y < height; y++)
+    {
+        const float v = (y + 0.5f) / height;
+        uint8_t *row = mask + static_cast<size_t>(y) * width;
+        for (unsigned x = 0; x < width; x++)
+        {
+            const float u = (x + 0.5f) / width;
+            float sx = (m[0] * u + m[1] * v + m[2]) * src_width, sy = (m[3] * u + m[4] * v + m[5]) * src_height;
+            if (sx >= 0 && sy >= 0 && sx < src_width && sy < src_height)
+                row[x] = bitmap[static_cast<size_t>(sx) * src_height + static_cast<size_t>(sy)];  // Column major
+        }
+    }
+}
+
+void rasterize_masks(const BoundingBoxBatchData &bb, unsigned width, unsigned height, uint8_t *out)
+{
+    const size_t mask_size = static_cast<size_t>(width) * height;
+    const int box_count = bb.cords.size();
+    if (!bb.has_masks())
+    {
+        memset(out, 0, mask_size * box_count);
+        return;
+    }
+    const MaskStore &store = *bb.masks;
+    std::vector<int> sample_of(box_count);
+    for (size_t i = 0; i < bb.sample_count(); i++)
+        std::fill(sample_of.begin() + bb.offsets[i], sample_of.begin() + bb.offsets[i + 1], i);
+    #pragma omp parallel
+    {
+        std::vector<float> vertices, crossings;
+        std::vector<uint32_t> counts;
+        std::vector<uint8_t> bitmap;
+        #pragma omp for schedule(dynamic)
+        for (int j = 0; j < box_count; j++)
+        {
+            uint8_t *mask = out + j * mask_size;
+            memset(mask, 0, mask_size);
+            if (bb.mask_ids[j] < 0)
+                continue;
+            const auto &entry = store.entries[bb.mask_ids[j]];
+            const MaskView &view = bb.mask_views[sample_of[j]];
+            if (entry.kind == MaskStore::Kind::Polygons)
+            {
+                float inverse[6];
+                if (invert_view(view, inverse))
+                    fill_polygons(store, entry, inverse, width, height, mask, vertices, crossings);
+            }
+            else
+            {
+                fill_rle(store, entry, view, width, height, mask, counts, bitmap);
+            }
+        }
+    }
+}
+
+void decode_rle_string(const char *chars, size_t length, std::vector<uint32_t> &counts)
+{
+    // Each count is a signed difference to the count two runs before, from the third one, in 5 bit groups offset by '0'
+    const size_t first = counts.size();
+    size_t p = 0;
+    while (p < length && chars[p])
+    {
+        // Unsigned so the sign extension and the wrap around of the delta are defined, the bits are the same as in the reference
+        unsigned long long x = 0;
+        int k = 0;
+        bool more = true;
+        while (more && p < length)
+        {
+            unsigned long long c = static_cast<unsigned long long>(chars[p] - 48);
+            if (5 * k < 64)
+                x |= (c & 0x1f) << (5 * k);
+            more = c & 0x20;
+            p++;
+            k++;
+            if (!more && (c & 0x10) && 5 * k < 64)
+                x |= ~((1ULL << (5 * k)) - 1);
+        }
+        if (counts.size() - first > 2)
+            x += counts[counts.size() - 2];
+        counts.push_back(static_cast<uint32_t>(x));
+    }
+}
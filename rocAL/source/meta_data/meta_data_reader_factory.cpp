@@ -89,8 +89,8 @@ std::shared_ptr<MetaDataReader> create_meta_data_reader(const MetaDataConfig& co
             break;
         case MetaDataReaderType::COCO_META_DATA_READER:
         {
-            if(config.type() != MetaDataType::BoundingBox)
-                THROW("FOLDER_BASED_LABEL_READER can only be used to load bounding boxes")
+            if(config.type() != MetaDataType::BoundingBox && config.type() != MetaDataType::PolygonMask)
+                THROW("COCO_META_DATA_READER can only be used to load bounding boxes and masks")
             auto ret = std::make_shared<COCOMetaDataReader>();
             ret->init(config);
             return ret;
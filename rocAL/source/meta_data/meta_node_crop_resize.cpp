@@ -23,78 +23,28 @@ THE SOFTWARE.
 #include "meta_node_crop_resize.h"
 void CropResizeMetaNode::initialize()
 {
-    _x1_val.resize(_batch_size);
-    _y1_val.resize(_batch_size);
-    _x2_val.resize(_batch_size);
-    _y2_val.resize(_batch_size);
+    _windows.resize(_batch_size);
 }
 
 void CropResizeMetaNode::update_parameters(MetaDataBatch* input_meta_data)
 {
-    initialize();
     if(_batch_size != input_meta_data->size())
     {
         _batch_size = input_meta_data->size();
     }
-    _meta_crop_param = _node->get_crop_param();    
+    initialize();
+    _meta_crop_param = _node->get_crop_param();
     _dst_width = _node->get_dst_width();
     _dst_height = _node->get_dst_height();
-    _x1 = _meta_crop_param->x1_arr;
-    _y1 = _meta_crop_param->y1_arr;
-    _x2 = _meta_crop_param->x2_arr;
-    _y2 = _meta_crop_param->y2_arr;
-    vxCopyArrayRange((vx_array)_x1, 0, _batch_size, sizeof(uint),_x1_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_y1, 0, _batch_size, sizeof(uint),_y1_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_x2, 0, _batch_size, sizeof(uint),_x2_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_y2, 0, _batch_size, sizeof(uint),_y2_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    BoundingBoxCord temp_box = {0, 0, 1, 1};
-
+    const auto &x1 = _meta_crop_param->get_x1_arr_val();
+    const auto &y1 = _meta_crop_param->get_y1_arr_val();
+    const auto &x2 = _meta_crop_param->get_x2_arr_val();
+    const auto &y2 = _meta_crop_param->get_y2_arr_val();
     for(int i = 0; i < _batch_size; i++)
     {
-        auto bb_count = input_meta_data->get_bb_labels_batch()[i].size();
-        int labels_buf[bb_count];
-        float coords_buf[bb_count*4];
-        memcpy(labels_buf, input_meta_data->get_bb_labels_batch()[i].data(),  sizeof(int)*bb_count);
-        memcpy(coords_buf, input_meta_data->get_bb_cords_batch()[i].data(), input_meta_data->get_bb_cords_batch()[i].size() * sizeof(BoundingBoxCord));
-        BoundingBoxCords bb_coords;
-        BoundingBoxLabels bb_labels;
-        BoundingBoxCord crop_box;
-        _crop_w = _x2_val[i] - _x1_val[i];
-        _crop_h = _y2_val[i] - _y1_val[i];
-        //TBD
-        crop_box.l = _x1_val[i];
-        crop_box.t = _y1_val[i];
-        crop_box.r = _x1_val[i]+_crop_w;
-        crop_box.b = _y1_val[i]+_crop_h;
-        for(uint j = 0, m = 0; j < bb_count; j++)
-        {
-            BoundingBoxCord box;
-            box.l = coords_buf[m++];
-            box.t = coords_buf[m++];
-            box.r = coords_buf[m++];
-            box.b = coords_buf[m++];
-            
-            if (BBoxIntersectionOverUnion(box, crop_box) >= _iou_threshold)
-            {
-                float xA = std::max(crop_box.l, box.l);
-                float yA = std::max(crop_box.t, box.t);
-                float xB = std::min(crop_box.r, box.r);
-                float yB = std::min(crop_box.b, box.b);
-                box.l = (xA - crop_box.l) / (crop_box.r - crop_box.l);
-                box.t = (yA - crop_box.t) / (crop_box.b - crop_box.t);
-                box.r = (xB - crop_box.l) / (crop_box.r - crop_box.l);
-                box.b = (yB - crop_box.t) / (crop_box.b - crop_box.t);
-                
-                bb_coords.push_back(box);
-                bb_labels.push_back(labels_buf[j]);
-            }
-        }
-        if(bb_coords.size() == 0)
-        {
-            bb_coords.push_back(temp_box);
-            bb_labels.push_back(0);
-        }
-        input_meta_data->get_bb_cords_batch()[i] = bb_coords;
-        input_meta_data->get_bb_labels_batch()[i] = bb_labels;
+        _windows[i].window = {(float)x1[i], (float)y1[i], (float)x2[i], (float)y2[i]};
+        _windows[i].min_overlap = _iou_threshold;
     }
+    crop_boxes(input_meta_data->get_bb_batch(), _output_bb, _windows.data(), BoxCropOptions());
+    std::swap(input_meta_data->get_bb_batch(), _output_bb);
 }
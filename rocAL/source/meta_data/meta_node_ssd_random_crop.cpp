@@ -21,69 +21,27 @@ THE SOFTWARE.
 */
 
 #include "meta_node_ssd_random_crop.h"
-void SSDRandomCropMetaNode::initialize()
-{
-    _crop_width_val.resize(_batch_size);
-    _crop_height_val.resize(_batch_size);
-    _x1_val.resize(_batch_size);
-    _y1_val.resize(_batch_size);
-}
+
 void SSDRandomCropMetaNode::update_parameters(MetaDataBatch *input_meta_data)
 {
-    initialize();
     if(_batch_size != input_meta_data->size())
     {
         _batch_size = input_meta_data->size();
     }
-    std::vector<std::pair<float, float>> iou_range = _node->get_iou_range();
-    bool entire_iou = _node->is_entire_iou();
     _meta_crop_param = _node->get_crop_param();
     _dst_width = _node->get_dst_width();
     _dst_height = _node->get_dst_height();
-    _crop_width = _meta_crop_param->cropw_arr;
-    _crop_height = _meta_crop_param->croph_arr;
-    _x1 = _meta_crop_param->x1_arr;
-    _y1 = _meta_crop_param->y1_arr;
-    vxCopyArrayRange((vx_array)_crop_width, 0, _batch_size, sizeof(uint),_crop_width_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_crop_height, 0, _batch_size, sizeof(uint),_crop_height_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_x1, 0, _batch_size, sizeof(uint),_x1_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    vxCopyArrayRange((vx_array)_y1, 0, _batch_size, sizeof(uint),_y1_val.data(), VX_READ_ONLY, VX_MEMORY_TYPE_HOST);
-    for(int i = 0; i < _batch_size; i++)
+    auto &input_bb = input_meta_data->get_bb_batch();
+    // The node has already cropped these boxes while drawing the windows
+    if (_boxes_from_node && _node->crops_boxes_of(input_bb))
     {
-        auto bb_count = input_meta_data->get_bb_labels_batch()[i].size();
-        int labels_buf[bb_count];
-        BoundingBoxCords box_coords_buf;
-        box_coords_buf.resize(bb_count);
-        memcpy(labels_buf, input_meta_data->get_bb_labels_batch()[i].data(),  sizeof(int)*bb_count);
-        memcpy((void *)box_coords_buf.data(), input_meta_data->get_bb_cords_batch()[i].data(), input_meta_data->get_bb_cords_batch()[i].size() * sizeof(BoundingBoxCord));
-        BoundingBoxCords bb_coords;
-        BoundingBoxLabels bb_labels;
-        BoundingBoxCord crop_box;
-        crop_box.l = _x1_val[i];
-        crop_box.t = _y1_val[i];
-        crop_box.r = _x1_val[i] + _crop_width_val[i];
-        crop_box.b = _y1_val[i] + _crop_height_val[i];
-        for(uint j = 0; j < bb_count; j++)
-        {
-            auto x_c = 0.5f * (box_coords_buf[j].l + box_coords_buf[j].r);
-            auto y_c = 0.5f * (box_coords_buf[j].t + box_coords_buf[j].b);
-            bool is_center_in_crop = (x_c >= crop_box.l && x_c <= crop_box.r) && (y_c >= crop_box.t && y_c <= crop_box.b);
-            float bb_iou = BBoxIntersectionOverUnion(box_coords_buf[j], crop_box, entire_iou);
-            if (bb_iou >= iou_range[j].first && bb_iou <= iou_range[j].second && is_center_in_crop)
-            {
-                float xA = std::max(crop_box.l, box_coords_buf[j].l);
-                float yA = std::max(crop_box.t, box_coords_buf[j].t);
-                float xB = std::min(crop_box.r, box_coords_buf[j].r);
-                float yB = std::min(crop_box.b, box_coords_buf[j].b);
-                box_coords_buf[j].l = (xA - crop_box.l) / (crop_box.r - crop_box.l);
-                box_coords_buf[j].t = (yA - crop_box.t) / (crop_box.b - crop_box.t);
-                box_coords_buf[j].r = (xB - crop_box.l) / (crop_box.r - crop_box.l);
-                box_coords_buf[j].b = (yB - crop_box.t) / (crop_box.b - crop_box.t);
-                bb_coords.push_back(box_coords_buf[j]);
-                bb_labels.push_back(labels_buf[j]);
-            }
-        }
-        input_meta_data->get_bb_cords_batch()[i] = bb_coords;
-        input_meta_data->get_bb_labels_batch()[i] = bb_labels;
+        std::swap(input_bb, _node->cropped_boxes());
+        return;
     }
-}
\ No newline at end of file
+    BoxCropOptions options;
+    options.overlap_is_iou = _node->is_entire_iou();
+    options.center_in_window = true;
+    options.keep_one = false;
+    crop_boxes(input_bb, _output_bb, _node->get_windows().data(), options);
+    std::swap(input_bb, _output_bb);
+}
@@ -0,0 +1,70 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <cmath>
+#include "ssd_crop_sampler.h"
+
+BoxCropWindow SSDCropSampler::sample(const BoundingBoxCord *boxes, size_t count, SampleRandStream &rand, unsigned image_width, unsigned x_align) const
+{
+    BoxCropWindow crop;
+    for (unsigned attempt = 0; !_config.max_attempts || attempt < _config.max_attempts; attempt++)
+    {
+        const auto &option = _config.options[rand.uniform_int(_config.options.size())];
+        crop.min_overlap = option.min_overlap;
+        crop.max_overlap = option.max_overlap;
+        if (option.whole_image)
+        {
+            crop.window = {0, 0, 1, 1};
+            return crop;
+        }
+        float width = rand.uniform(_config.min_scale, _config.max_scale);
+        float height = rand.uniform(_config.min_scale, _config.max_scale);
+        float aspect_ratio = width / height;
+        if (aspect_ratio < _config.min_aspect_ratio || aspect_ratio > _config.max_aspect_ratio)
+            continue;
+        float left = rand.uniform(0.f, 1.f - width);
+        float top = rand.uniform(0.f, 1.f - height);
+        if (x_align && image_width)
+        {
+            long x = std::lround(left * image_width);
+            left = static_cast<float>(x - x % x_align) / image_width;
+        }
+        crop.window = {left, top, left + width, top + height};
+        if ((!_config.all_boxes_overlap || all_boxes_overlap(boxes, count, crop, _config.overlap_is_iou)) &&
+            any_box_center_in(boxes, count, crop.window, _config.strict_center))
+            return crop;
+    }
+    crop.window = {0, 0, 1, 1};
+    crop.min_overlap = 0;
+    crop.max_overlap = 1;
+    return crop;
+}
+
+void SSDCropSampler::sample_and_crop(const BoundingBoxBatchData &in, std::vector<SampleRandStream> &streams, std::vector<BoxCropWindow> &windows,
+                                     BoundingBoxBatchData &out, const BoxCropOptions &crop_options) const
+{
+    windows.resize(in.sample_count());
+    crop_boxes(in, out, [&](int i) {
+        windows[i] = sample(in.cords_of(i), in.count(i), streams[i]);
+        return windows[i];
+    }, crop_options);
+}
@@ -39,9 +39,10 @@ bool TextFileMetaDataReader::exists(const std::string& image_name)
     return _map_content.find(image_name) != _map_content.end();
 }
 
-void TextFileMetaDataReader::add(std::string image_name, int label)
+void TextFileMetaDataReader::add(std::string image_name, int label, int field_row)
 {
     pMetaData info = std::make_shared<Label>(label);
+    info->set_field_row(field_row);
     if(exists(image_name))
     {
         WRN("Entity with the same name exists")
@@ -58,6 +59,7 @@ void TextFileMetaDataReader::lookup(const std::vector<std::string> &image_names)
     }
     if(image_names.size() != (unsigned)_output->size())   
         _output->resize(image_names.size());
+    _output->get_fields().reset(_fields);
     for(unsigned i = 0; i < image_names.size(); i++)
     {
         auto image_name = image_names[i];
@@ -65,6 +67,8 @@ void TextFileMetaDataReader::lookup(const std::vector<std::string> &image_names)
         if(_map_content.end() == it)
             THROW("ERROR: Given name not present in the map"+ image_name )
         _output->get_label_batch()[i] = it->second->get_label();
+        if (!_fields.empty())
+            _output->get_fields().add_row(_fields, it->second->get_field_row());
     }
 }
 
@@ -74,6 +78,7 @@ void TextFileMetaDataReader::read_all(const std::string &path) {
 	{
 		//_text_file.open(path.c_str(), std::ifstream::in);
 		std::string line;
+        std::vector<float> values;
 		while(std::getline(text_file, line))
 		{
             std::istringstream line_ss(line);
@@ -81,8 +86,22 @@ void TextFileMetaDataReader::read_all(const std::string &path) {
             std::string image_name;
             if(!(line_ss>>image_name>>label))
                 continue;
-			add(image_name, label);
+            // Numbers after the label, such as soft labels, multi-hot vectors or weights
+            values.clear();
+            float value;
+            while (line_ss >> value)
+                values.push_back(value);
+            if (!values.empty() && _fields.empty())
+                _fields.column("values", MetaDataFieldType::FLOAT32);
+            int field_row = -1;
+            if (!_fields.empty())
+            {
+                field_row = _fields.columns[0].sample_count();
+                _fields.columns[0].add(values.data(), values.size());
+            }
+			add(image_name, label, field_row);
 		}
+        _fields.fix_widths();
 	}
 	else
     {
@@ -101,6 +120,7 @@ void TextFileMetaDataReader::release(std::string image_name) {
 
 void TextFileMetaDataReader::release() {
 	_map_content.clear();
+    _fields = {};
 }
 
 TextFileMetaDataReader::TextFileMetaDataReader() {
@@ -38,6 +38,14 @@ void TFMetaDataReader::init(const MetaDataConfig &cfg)
     _path = cfg.path();
     _feature_key_map = cfg.feature_key_map();
     _output = new LabelBatch();
+    for (auto &entry : _feature_key_map)
+    {
+        if (entry.first.rfind("field/", 0) != 0)
+            continue;
+        _field_keys.push_back(entry.second);
+        _fields.column(entry.second, MetaDataFieldType::FLOAT32);
+        _field_typed.push_back(false);
+    }
     _last_rec = false;
 }
 
@@ -46,9 +54,10 @@ bool TFMetaDataReader::exists(const std::string& _image_name)
     return _map_content.find(_image_name) != _map_content.end();
 }
 
-void TFMetaDataReader::add(std::string image_name, int label)
+void TFMetaDataReader::add(std::string image_name, int label, int field_row)
 {
     pMetaData info = std::make_shared<Label>(label);
+    info->set_field_row(field_row);
     if(exists(image_name))
     {
         WRN("Entity with the same name exists")
@@ -66,6 +75,7 @@ void TFMetaDataReader::lookup(const std::vector<std::string> &_image_names)
     }
     if(_image_names.size() != (unsigned)_output->size())   
         _output->resize(_image_names.size());
+    _output->get_fields().reset(_fields);
 
     for(unsigned i = 0; i < _image_names.size(); i++)
     {
@@ -74,6 +84,8 @@ void TFMetaDataReader::lookup(const std::vector<std::string> &_image_names)
         if(_map_content.end() == it)
             THROW("ERROR: Given name not present in the map"+ _image_name )
         _output->get_label_batch()[i] = it->second->get_label();
+        if (!_fields.empty())
+            _output->get_fields().add_row(_fields, it->second->get_field_row());
     }
 
 }
@@ -130,13 +142,59 @@ void TFMetaDataReader::read_record(std::ifstream &file_contents, uint file_size,
     single_feature = feature.at(user_label_key);
     label = single_feature.int64_list().value()[0];
     //std::cout << "TFMeta read record <name, label>" << fname << " " << label << std::endl;
-    add(fname, label);
+    int field_row = -1;
+    if (!_field_keys.empty())
+    {
+        field_row = _fields.columns[0].sample_count();
+        read_fields(feature);
+    }
+    add(fname, label, field_row);
     file_contents.read((char *)&data_crc, sizeof(data_crc));
     if(!file_contents)
         THROW("TFMetaDataReader: Error in reading TF records")
     delete[] data;
 }
 
+void TFMetaDataReader::read_fields(const google::protobuf::Map<std::string, tensorflow::Feature> &features)
+{
+    for (size_t c = 0; c < _field_keys.size(); c++)
+    {
+        auto &column = _fields.columns[c];
+        auto it = features.find(_field_keys[c]);
+        if (it == features.end())
+        {
+            column.add(nullptr, 0);
+            continue;
+        }
+        const auto &feature = it->second;
+        MetaDataFieldType type;
+        switch (feature.kind_case())
+        {
+            case tensorflow::Feature::kInt64List: type = MetaDataFieldType::INT64; break;
+            case tensorflow::Feature::kFloatList: type = MetaDataFieldType::FLOAT32; break;
+            default: type = MetaDataFieldType::UINT8; break;
+        }
+        if (!_field_typed[c])
+        {
+            // Only records without the feature were read so far, the column has no values yet
+            column.type = type;
+            _field_typed[c] = true;
+        }
+        else if (column.type != type)
+        {
+            THROW("TFMetaDataReader: feature " + _field_keys[c] + " does not have the same type in all the records")
+        }
+        if (type == MetaDataFieldType::INT64)
+            column.add(feature.int64_list().value().data(), feature.int64_list().value_size());
+        else if (type == MetaDataFieldType::FLOAT32)
+            column.add(feature.float_list().value().data(), feature.float_list().value_size());
+        else if (feature.bytes_list().value_size())  // The first bytes value, usually a string
+            column.add(feature.bytes_list().value(0).data(), feature.bytes_list().value(0).size());
+        else
+            column.add(nullptr, 0);
+    }
+}
+
 void TFMetaDataReader::read_all(const std::string &path)
 {
     std::string label_key = "image/class/label";
@@ -161,6 +219,7 @@ void TFMetaDataReader::read_all(const std::string &path)
         _last_rec = false;
         file_contents.close();
     }
+    _fields.fix_widths();
 }
 
 void TFMetaDataReader::release(std::string _image_name)
@@ -175,6 +234,7 @@ void TFMetaDataReader::release(std::string _image_name)
 
 void TFMetaDataReader::release() {
     _map_content.clear();
+    _fields.clear();
 }
 
 void TFMetaDataReader::read_files(const std::string& _path)
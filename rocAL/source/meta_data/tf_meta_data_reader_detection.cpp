@@ -69,6 +69,7 @@ void TFMetaDataReaderDetection::lookup(const std::vector<std::string> &image_nam
     }
     if(image_names.size() != (unsigned)_output->size())   
         _output->resize(image_names.size());
+    _output->get_bb_batch().clear();
 
     for(unsigned i = 0; i < image_names.size(); i++)
     {
@@ -77,14 +78,13 @@ void TFMetaDataReaderDetection::lookup(const std::vector<std::string> &image_nam
 	
         if(_map_content.end() == it)
         {
-            _output->get_bb_cords_batch()[i] = {{0, 0, 0, 0}};
-            _output->get_bb_labels_batch()[i] = {{0}};
+            _output->get_bb_batch().add({0, 0, 0, 0}, 0);
+            _output->get_bb_batch().end_sample();
             _output->get_img_sizes_batch()[i] = {0, 0};
         }
         else
         {
-            _output->get_bb_cords_batch()[i] = it->second->get_bb_cords();
-            _output->get_bb_labels_batch()[i] = it->second->get_bb_labels();
+            _output->get_bb_batch().append_sample(it->second->get_bb_cords(), it->second->get_bb_labels());
             _output->get_img_sizes_batch()[i] = it->second->get_img_size();
         }
     }
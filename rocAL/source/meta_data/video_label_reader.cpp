@@ -56,7 +56,7 @@ bool VideoLabelReader::exists(const std::string &frame_name)
 void VideoLabelReader::add(std::string frame_name, int label, unsigned int video_frame_count, unsigned int start_frame)
 {
     Properties props;
-    open_video_context(frame_name.c_str(), props);
+    get_video_properties(frame_name, props);
     unsigned frame_count = video_frame_count ? video_frame_count : props.frames_count;
     if ((video_frame_count + start_frame) > props.frames_count)
         THROW("The given frame numbers in txt file exceeds the maximum frames in the video" + frame_name)
@@ -130,16 +130,27 @@ void VideoLabelReader::read_text_file(const std::string &_path)
     {
         std::string line;
         Properties props;
+        std::vector<std::string> lines, video_file_names;
         while (std::getline(text_file, line))
+        {
+            std::string video_file_name;
+            std::istringstream line_ss(line);
+            if (!(line_ss >> video_file_name))
+                continue;
+            lines.push_back(line);
+            video_file_names.push_back(video_file_name);
+        }
+        prefetch_video_properties(video_file_names, _path.c_str());
+        for (auto &video_line : lines)
         {
             int label;
             std::string video_file_name;
             unsigned start_frame_number = 0;
             unsigned end_frame_number = 0;
-            std::istringstream line_ss(line);
+            std::istringstream line_ss(video_line);
             if (!(line_ss >> video_file_name >> label))
                 continue;
-            open_video_context(video_file_name.c_str(), props);
+            get_video_properties(video_file_name, props);
             if (!_file_list_frame_num)
             {
                 float start_time = 0.0;
@@ -177,6 +188,7 @@ void VideoLabelReader::read_all(const std::string &_path)
         }
         else if (pathObj.has_extension() && pathObj.extension().string() == ".mp4")
         {
+            prefetch_video_properties({_path}, _path.c_str());
             add(_path, 0);
         }
     }
@@ -195,6 +207,9 @@ void VideoLabelReader::read_all(const std::string &_path)
         }
         std::sort(entry_name_list.begin(), entry_name_list.end());
         closedir(_sub_dir);
+        // The videos and their labels are listed first so they can be probed together
+        std::vector<std::string> video_file_names;
+        std::vector<int> labels;
         for (unsigned dir_count = 0; dir_count < entry_name_list.size(); ++dir_count)
         {
             std::string subfolder_path = _full_path + "/" + entry_name_list[dir_count];
@@ -212,7 +227,8 @@ void VideoLabelReader::read_all(const std::string &_path)
                 read_files(_folder_path);
                 for (unsigned i = 0; i < _subfolder_video_file_names.size(); i++)
                 {
-                    add(_subfolder_video_file_names[i], i);
+                    video_file_names.push_back(_subfolder_video_file_names[i]);
+                    labels.push_back(i);
                 }
                 break; // assume directory has only files.
             }
@@ -227,10 +243,14 @@ void VideoLabelReader::read_all(const std::string &_path)
                     char delim = '/';
                     substring_extraction(_subfolder_video_file_names[i], delim, substrings);
                     int label = atoi(substrings[substrings.size() - 2].c_str());
-                    add(_subfolder_video_file_names[i], label);
+                    video_file_names.push_back(_subfolder_video_file_names[i]);
+                    labels.push_back(label);
                 }
             }
         }
+        prefetch_video_properties(video_file_names, _path.c_str());
+        for (unsigned i = 0; i < video_file_names.size(); i++)
+            add(video_file_names[i], labels[i]);
     }
     // print_map_contents();
 }
@@ -0,0 +1,68 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include "parameter_counter_rand.h"
+
+thread_local BatchRandKeys *BatchRandKeys::_current = nullptr;
+
+std::array<uint32_t, 4>
+BatchRandKeys::philox(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key)
+{
+    constexpr uint32_t MULTIPLIER_0 = 0xD2511F53, MULTIPLIER_1 = 0xCD9E8D57;
+    constexpr uint32_t WEYL_0 = 0x9E3779B9, WEYL_1 = 0xBB67AE85;
+    for (unsigned round = 0; round < 10; round++)
+    {
+        uint64_t product_0 = static_cast<uint64_t>(MULTIPLIER_0) * counter[0];
+        uint64_t product_1 = static_cast<uint64_t>(MULTIPLIER_1) * counter[2];
+        counter = {static_cast<uint32_t>(product_1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(product_1),
+                   static_cast<uint32_t>(product_0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(product_0)};
+        key[0] += WEYL_0;
+        key[1] += WEYL_1;
+    }
+    return counter;
+}
+
+uint64_t
+BatchRandKeys::sample_id(const std::string &name)
+{
+    // FNV-1a, unlike std::hash it gives the same ids across platforms and standard libraries
+    uint64_t hash = 0xCBF29CE484222325;
+    for (unsigned char c : name)
+    {
+        hash ^= c;
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+void
+BatchRandKeys::uniform(double *values, size_t count, uint32_t stream) const
+{
+    const std::array<uint32_t, 2> key = {seed, epoch};
+    for (size_t i = 0; i < count; i++)
+    {
+        auto bits = philox({static_cast<uint32_t>(sample_ids[i]), static_cast<uint32_t>(sample_ids[i] >> 32), node_id, stream}, key);
+        // 53 random bits scaled to [0, 1)
+        uint64_t mantissa = ((static_cast<uint64_t>(bits[0]) << 32) | bits[1]) >> 11;
+        values[i] = static_cast<double>(mantissa) * (1.0 / 9007199254740992.0);
+    }
+}
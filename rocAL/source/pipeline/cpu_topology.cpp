@@ -0,0 +1,155 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <fstream>
+#include <sstream>
+#include <pthread.h>
+#include <algorithm>
+#include "cpu_topology.h"
+
+namespace
+{
+// Parses a sysfs CPU/node list such as "0-31,64-95"
+std::vector<unsigned> parse_cpu_list(const std::string &list)
+{
+    std::vector<unsigned> values;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ','))
+    {
+        if (range.empty() || range == "\n")
+            continue;
+        auto dash = range.find('-');
+        unsigned first = std::stoul(range.substr(0, dash));
+        unsigned last = (dash == std::string::npos) ? first : std::stoul(range.substr(dash + 1));
+        for (unsigned value = first; value <= last; value++)
+            values.push_back(value);
+    }
+    return values;
+}
+
+std::string read_line(const std::string &path)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (file.is_open())
+        std::getline(file, line);
+    return line;
+}
+}
+
+CpuTopology* CpuTopology::instance()
+{
+    static CpuTopology topology;
+    return &topology;
+}
+
+CpuTopology::CpuTopology()
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0)
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            CPU_SET(cpu, &allowed);
+
+    // Only the CPUs the process is allowed on are kept, nodes left without any are dropped
+    for (auto node : parse_cpu_list(read_line("/sys/devices/system/node/online")))
+    {
+        std::vector<unsigned> cpus;
+        for (auto cpu : parse_cpu_list(read_line("/sys/devices/system/node/node" + TOSTR(node) + "/cpulist")))
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+                cpus.push_back(cpu);
+        if (!cpus.empty())
+            _node_cpus.push_back(cpus);
+    }
+    if (_node_cpus.empty())
+    {
+        std::vector<unsigned> cpus;
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if (CPU_ISSET(cpu, &allowed))
+                cpus.push_back(cpu);
+        _node_cpus.push_back(cpus);
+    }
+    // A core is identified by its SMT sibling list, a CPU without topology information is taken as a core of its own
+    std::vector<std::string> cores;
+    for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (!CPU_ISSET(cpu, &allowed))
+            continue;
+        auto siblings = read_line("/sys/devices/system/cpu/cpu" + TOSTR(cpu) + "/topology/thread_siblings_list");
+        cores.push_back(siblings.empty() ? TOSTR(cpu) : siblings);
+    }
+    std::sort(cores.begin(), cores.end());
+    _physical_core_count = std::max<unsigned>(std::unique(cores.begin(), cores.end()) - cores.begin(), 1);
+    LOG("CPU topology: " + TOSTR(_node_cpus.size()) + " NUMA node(s) with " + TOSTR(_node_cpus[0].size()) + " CPU(s) on node 0")
+}
+
+cpu_set_t CpuTopology::node_cpu_set(unsigned node) const
+{
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (auto cpu : _node_cpus[node % node_count()])
+        CPU_SET(cpu, &cpu_set);
+    return cpu_set;
+}
+
+cpu_set_t CpuTopology::shards_cpu_set(const std::vector<unsigned> &shard_ids) const
+{
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (unsigned node = 0; node < node_count(); node++)
+    {
+        if (!shard_ids.empty() && std::none_of(shard_ids.begin(), shard_ids.end(), [&](unsigned shard_id) { return shard_node(shard_id) == node; }))
+            continue;
+        cpu_set_t node_set = node_cpu_set(node);
+        CPU_OR(&cpu_set, &cpu_set, &node_set);
+    }
+    return cpu_set;
+}
+
+void CpuTopology::pin_current_thread_to_shards(const std::vector<unsigned> &shard_ids) const
+{
+    cpu_set_t cpu_set = shards_cpu_set(shard_ids);
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+    if (ret != 0)
+        WRN("Error calling pthread_setaffinity_np: " + TOSTR(ret))
+}
+
+ScopedNodePlacement::ScopedNodePlacement(CpuPlacement placement, unsigned shard_id)
+{
+    if (placement != CpuPlacement::NUMA)
+        return;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &_previous_mask) != 0)
+        return;
+    auto topology = CpuTopology::instance();
+    cpu_set_t cpu_set = topology->node_cpu_set(topology->shard_node(shard_id));
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+    if (ret != 0)
+        WRN("Error calling pthread_setaffinity_np: " + TOSTR(ret))
+    _pinned = (ret == 0);
+}
+
+ScopedNodePlacement::~ScopedNodePlacement()
+{
+    if (_pinned)
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &_previous_mask);
+}
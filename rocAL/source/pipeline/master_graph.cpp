@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include <half/half.hpp>
 #include "master_graph.h"
 #include "parameter_factory.h"
+#include "cpu_topology.h"
+#include "trace_recorder.h"
 #include "ocl_setup.h"
 #include "log.h"
 #include "meta_data_reader_factory.h"
@@ -111,16 +113,21 @@ MasterGraph::~MasterGraph()
     release();
 }
 
-MasterGraph::MasterGraph(size_t batch_size, RocalAffinity affinity, size_t cpu_thread_count, int gpu_id, size_t prefetch_queue_depth, RocalTensorDataType output_tensor_data_type):
+MasterGraph::MasterGraph(size_t batch_size, RocalAffinity affinity, size_t cpu_thread_count, int gpu_id, size_t prefetch_queue_depth, RocalTensorDataType output_tensor_data_type, CpuPlacement cpu_placement):
         _ring_buffer(prefetch_queue_depth),
         _output_tensor(nullptr),
         _graph(nullptr),
         _affinity(affinity),
+        _user_cpu_num_threads(cpu_thread_count),
         _cpu_num_threads(cpu_thread_count),
+        _cpu_placement(cpu_placement),
+        _decode_client(DecodeScheduler::instance()->create_client()),
         _gpu_id(gpu_id),
         _convert_time("Conversion Time", DBG_TIMING),
         _process_time("Process Time", DBG_TIMING),
         _bencode_time("BoxEncoder Time", DBG_TIMING),
+        _mask_load_time("Mask Load Time", DBG_TIMING),
+        _mask_process_time("Mask Process Time", DBG_TIMING),
         _user_batch_size(batch_size),
 #if ENABLE_HIP
         _mem_type ((_affinity == RocalAffinity::GPU) ? RocalMemType::HIP : RocalMemType::HOST),
@@ -137,7 +144,12 @@ MasterGraph::MasterGraph(size_t batch_size, RocalAffinity affinity, size_t cpu_t
         _box_encoder_gpu(nullptr),
 #endif
         _rb_block_if_empty_time("Ring Buffer Block IF Empty Time"),
-        _rb_block_if_full_time("Ring Buffer Block IF Full Time")
+        _rb_block_if_full_time("Ring Buffer Block IF Full Time"),
+        _pipeline_time("Pipeline Time", DBG_TIMING),
+        _prepare_stage_time("Prepare Stage Time", DBG_TIMING),
+        _meta_data_stage_time("Meta Data Stage Time", DBG_TIMING),
+        _graph_stage_time("Graph Stage Time", DBG_TIMING),
+        _commit_stage_time("Commit Stage Time", DBG_TIMING)
 {
     try {
         vx_status status;
@@ -223,6 +235,12 @@ MasterGraph::run()
         return MasterGraph::Status::NO_MORE_DATA;
     }
 
+    TraceRecorder::set_thread_batch(_run_count++);
+    if(_stats_enabled.load(std::memory_order_relaxed))
+    {
+        _ring_buffer_level_sum += _ring_buffer.level();
+        _ring_buffer_level_samples++;
+    }
     _rb_block_if_empty_time.start();
     _ring_buffer.block_if_empty();// wait here if the user thread (caller of this function) is faster in consuming the processed images compare to th output routine in producing them
     _rb_block_if_empty_time.end();
@@ -244,6 +262,9 @@ MasterGraph::run()
 
     decrease_image_count();
 
+    if(_tuning_batch_count > 0)
+        tune_prefetch();
+
     return MasterGraph::Status::OK;
 }
 
@@ -255,22 +276,54 @@ MasterGraph::decrease_image_count()
 }
 
 size_t
-MasterGraph::calculate_cpu_num_threads(size_t shard_count)
+MasterGraph::calculate_cpu_num_threads(size_t shard_count, unsigned shard_id)
 {
-    if (_cpu_num_threads <= 0) {
-        const unsigned minimum_cpu_thread_count = 2;
-        const unsigned default_smt_count = 2;
-        unsigned thread_count = std::thread::hardware_concurrency();
-        if(thread_count < minimum_cpu_thread_count)
-        {
-            thread_count = minimum_cpu_thread_count;
-            WRN("hardware_concurrency() call failed, assuming rocAL can run " + TOSTR(thread_count) + " threads")
-        }
-        size_t core_count = thread_count / default_smt_count;
-        _cpu_num_threads = core_count / shard_count;
+    // Use the num_threads passed by the user if any
+    if (_user_cpu_num_threads > 0)
+        return _user_cpu_num_threads;
+    const unsigned minimum_cpu_thread_count = 2;
+    const unsigned default_smt_count = 2;
+    unsigned thread_count = std::thread::hardware_concurrency();
+    if(thread_count < minimum_cpu_thread_count)
+    {
+        thread_count = minimum_cpu_thread_count;
+        WRN("hardware_concurrency() call failed, assuming rocAL can run " + TOSTR(thread_count) + " threads")
+    }
+    size_t core_count = thread_count / default_smt_count;
+    size_t cpu_num_threads = core_count / shard_count;
+    if (_cpu_placement == CpuPlacement::NUMA)
+    {
+        // The shard only runs on the cores of its node, shared with the other shards placed on the same node
+        auto topology = CpuTopology::instance();
+        unsigned node = topology->shard_node(shard_id);
+        size_t shards_on_node = 0;
+        for (unsigned id = 0; id < shard_count; id++)
+            if (topology->shard_node(id) == node)
+                shards_on_node++;
+        cpu_num_threads = std::max<size_t>(topology->node_cpu_count(node) / default_smt_count / std::max<size_t>(shards_on_node, 1), 1);
     }
-    // Use _cpu_num_threads if user has already passed non-negative num_threads
-    return _cpu_num_threads;
+    // Computed again for every shard, the processing threads are sized by the first call
+    if (_cpu_num_threads <= 0)
+        _cpu_num_threads = cpu_num_threads;
+    return cpu_num_threads;
+}
+
+void
+MasterGraph::place_processing_thread()
+{
+    if (_cpu_placement != CpuPlacement::NUMA)
+        return;
+    // The graph, its OpenMP threads and the pipeline stage threads started from the calling thread inherit its affinity,
+    // keeping the processing on the nodes the loader shards write their buffers on
+    std::vector<unsigned> shard_ids;
+#ifdef ROCAL_VIDEO
+    if (_is_video_loader)
+        shard_ids = _video_loader_module->get_shard_ids();
+    else
+#endif
+    if (_loader_module)
+        shard_ids = _loader_module->get_shard_ids();
+    CpuTopology::instance()->pin_current_thread_to_shards(shard_ids);
 }
 
 void
@@ -305,12 +358,31 @@ MasterGraph::build()
             THROW("Dimension of the output images do not match")
 
     allocate_output_tensor();
+    if(_prefetch_memory_budget > 0)
+    {
+        size_t slot_size = output_byte_size() * _output_images.size();
+        if (_heatmap_generator)
+            slot_size += (_heatmap_generator->heatmaps_size() + _heatmap_generator->target_weights_size()) * sizeof(float);
+        if (_label_encoder)
+            slot_size += (_label_encoder->targets_size() + _label_encoder->mix_params_size()) * sizeof(float);
+        if (_is_box_encoder)
+            slot_size += _user_batch_size * _num_anchors * (4 * sizeof(float) + sizeof(int));
+        _ring_buffer.set_capacity(PrefetchTuner::depth_within_budget(_prefetch_memory_budget / 2, slot_size, _prefetch_queue_depth));
+    }
 #if ENABLE_HIP || ENABLE_OPENCL
     _ring_buffer.init(_mem_type, (void *)_device.resources(), output_byte_size(), _output_images.size());
 #else
     _ring_buffer.init(_mem_type, nullptr, output_byte_size(), _output_images.size());
 #endif
     if (_is_box_encoder) _ring_buffer.initBoxEncoderMetaData(_mem_type, _user_batch_size*_num_anchors*4*sizeof(float), _user_batch_size*_num_anchors*sizeof(int));
+    if (_heatmap_generator) _ring_buffer.initHeatmapMetaData(_heatmap_generator->heatmaps_size() * sizeof(float), _heatmap_generator->target_weights_size() * sizeof(float));
+    if (_label_encoder)
+    {
+        // The images are mixed in place in the ring buffer by the host
+        if (_label_encoder->is_mixing() && (_mem_type != RocalMemType::HOST || _is_sequence_reader_output || _is_video_loader))
+            THROW("Mixup and cutmix of the LabelEncoder need the output images on the host and are not supported for videos and sequences")
+        _ring_buffer.initLabelEncoderMetaData(_label_encoder->targets_size() * sizeof(float), _label_encoder->mix_params_size() * sizeof(float));
+    }
     create_single_graph();
     start_processing();
     return Status::OK;
@@ -399,18 +471,36 @@ void MasterGraph::release()
 }
 
 MasterGraph::Status
-MasterGraph::update_node_parameters()
+MasterGraph::update_node_parameters(const std::vector<std::string> &names)
 {
     // Randomize random parameters
     ParameterFactory::instance()->renew_parameters();
 
     // Apply renewed parameters to VX parameters used in augmentation
-    for(auto& node: _nodes)
-        node->update_parameters();
+    apply_node_parameters(names);
 
     return Status::OK;
 }
 
+void
+MasterGraph::apply_node_parameters(const std::vector<std::string> &sample_keys)
+{
+    _rand_keys.seed = ParameterFactory::instance()->get_seed();
+    _rand_keys.epoch = _epoch;
+    _rand_keys.sample_ids.resize(sample_keys.size());
+    for(size_t i = 0; i < sample_keys.size(); i++)
+        _rand_keys.sample_ids[i] = BatchRandKeys::sample_id(sample_keys[i]);
+    BatchRandKeys::set_current(&_rand_keys);
+    _rand_keys.node_id = 0;
+    for(auto& node: _nodes)
+    {
+        _rand_keys.param_idx = 0;
+        node->update_parameters();
+        _rand_keys.node_id++;
+    }
+    BatchRandKeys::set_current(nullptr);
+}
+
 size_t
 MasterGraph::augmentation_branch_count()
 {
@@ -509,6 +599,7 @@ MasterGraph::reset()
     if(_output_thread.joinable())
         _output_thread.join();
     _ring_buffer.reset();
+    _epoch++;
     // clearing meta ring buffer
 #ifdef ROCAL_VIDEO
     if(_is_video_loader)
@@ -561,12 +652,131 @@ MasterGraph::timing()
     {
         t  = _loader_module->timing();
         t.image_process_time += _process_time.get_timing();
+        t.pipeline_time = _pipeline_time.get_timing();
+        t.prepare_stage_time = _prepare_stage_time.get_timing();
+        t.meta_data_stage_time = _meta_data_stage_time.get_timing();
+        t.graph_stage_time = _graph_stage_time.get_timing();
+        t.commit_stage_time = _commit_stage_time.get_timing();
     }
     t.copy_to_output += _convert_time.get_timing();
     t.bb_process_time += _bencode_time.get_timing();
+    t.mask_load_time += _mask_load_time.get_timing();
+    t.mask_process_time += _mask_process_time.get_timing();
     return t;
 }
 
+static RocalLatencyStats
+latency_stats(const LatencyHistogram &histogram)
+{
+    return {histogram.count(), histogram.total(), histogram.percentile(0.5), histogram.percentile(0.95),
+            histogram.percentile(0.99), histogram.max()};
+}
+
+void
+MasterGraph::enable_stats(bool enable)
+{
+    _stats_requested = enable;
+    record_stats(enable || _tuning_batch_count > 0);
+}
+
+void
+MasterGraph::record_stats(bool enable)
+{
+    _stats_enabled = enable;
+    for(auto timer : {&_rb_block_if_empty_time, &_rb_block_if_full_time, &_process_time, &_graph_stage_time,
+                      &_meta_data_stage_time, &_bencode_time, &_convert_time})
+        timer->enable_stats(enable);
+    if(_loader_module)
+        _loader_module->enable_stats(enable);
+#ifdef ROCAL_VIDEO
+    if(_video_loader_module)
+        _video_loader_module->enable_stats(enable);
+#endif
+}
+
+void
+MasterGraph::enable_auto_tune(size_t memory_budget, unsigned tuning_batch_count)
+{
+    if(_loader_module)
+        THROW("Auto tuning should be enabled before the loader is created")
+    if(memory_budget == 0 || tuning_batch_count == 0)
+        THROW("Auto tuning needs a memory budget and a number of batches to tune on")
+    _prefetch_memory_budget = memory_budget;
+    _tuning_batch_count = tuning_batch_count;
+    record_stats(true);
+}
+
+void
+MasterGraph::tune_prefetch()
+{
+    // Only the image loaders can change their decode threads and prefetch depth while running
+    if(!_loader_module)
+    {
+        _tuning_batch_count = 0;
+        record_stats(_stats_requested);
+        return;
+    }
+    if(!_prefetch_tuner)
+        _prefetch_tuner = std::make_unique<PrefetchTuner>(_prefetch_queue_depth, _ring_buffer.capacity(), _loader_module->decode_parallelism(),
+                                                          DecodeScheduler::instance()->thread_budget(), _loader_module->get_shard_ids().size(),
+                                                          _tuning_batch_count);
+    if(!_prefetch_tuner->count_batch())
+        return;
+    if(_prefetch_tuner->update(stats()))
+    {
+        _ring_buffer.set_active_depth(_prefetch_tuner->depth());
+        _loader_module->set_active_prefetch_depth(_prefetch_tuner->depth());
+        if(_prefetch_tuner->decode_threads() > 0)
+            _loader_module->set_decode_parallelism(_prefetch_tuner->decode_threads());
+    }
+    if(_prefetch_tuner->done())
+    {
+        _tuning_batch_count = 0;
+        record_stats(_stats_requested);
+        auto config = auto_tune_config();
+        INFO("Auto tuning done, prefetch_queue_depth " + TOSTR(config.prefetch_queue_depth) + " cpu_thread_count " + TOSTR(config.cpu_thread_count))
+    }
+}
+
+RocalAutoTuneConfig
+MasterGraph::auto_tune_config()
+{
+    if(!_prefetch_tuner)
+        return {_prefetch_queue_depth, _loader_module ? _loader_module->decode_parallelism() : _cpu_num_threads, false};
+    return {_prefetch_tuner->depth(), _prefetch_tuner->decode_threads(), _prefetch_tuner->done()};
+}
+
+RocalPipelineStats
+MasterGraph::stats()
+{
+    LoaderStats loader_stats;
+#ifdef ROCAL_VIDEO
+    if(_is_video_loader && _video_loader_module)
+        loader_stats = _video_loader_module->stats();
+    else
+#endif
+    if(_loader_module)
+        loader_stats = _loader_module->stats();
+    RocalPipelineStats s;
+    s.read = latency_stats(loader_stats.read_time);
+    s.decode = latency_stats(loader_stats.decode_time);
+    s.output_wait = latency_stats(_rb_block_if_empty_time.stats());
+    s.consumer_wait = latency_stats(_rb_block_if_full_time.stats());
+    s.process = latency_stats(_process_time.stats());
+    s.graph = latency_stats(_graph_stage_time.stats());
+    s.meta_data = latency_stats(_meta_data_stage_time.stats());
+    s.box_encode = latency_stats(_bencode_time.stats());
+    s.copy_out = latency_stats(_convert_time.stats());
+    s.bytes_read = loader_stats.bytes_read;
+    s.ring_buffer_level = _ring_buffer.level();
+    s.ring_buffer_depth = _ring_buffer.active_depth();
+    auto samples = _ring_buffer_level_samples.load();
+    s.ring_buffer_mean_level = samples ? static_cast<double>(_ring_buffer_level_sum.load()) / samples : 0;
+    s.circular_buffer_level = loader_stats.buffer_level;
+    s.circular_buffer_depth = loader_stats.buffer_depth;
+    s.circular_buffer_mean_level = loader_stats.mean_buffer_level;
+    return s;
+}
 
 #define CHECK_CL_CALL_RET(x) { cl_int ret; ret = x; if( ret != CL_SUCCESS) THROW("ocl call failed "+STR(#x)+" error "+TOSTR(ret)) }
 
@@ -580,7 +790,7 @@ MasterGraph::to_tensor(void *out_ptr, RocalTensorFormat format, float multiplier
     if (output_color_format() == RocalColorFormat::RGB_PLANAR)
         return MasterGraph::copy_out_tensor_planar(out_ptr,format,multiplier0, multiplier1, multiplier2, offset0, offset1, offset2, reverse_channels, output_data_type);
 
-    _convert_time.start();
+    TimingScope convert_timing(_convert_time);
     // Copies to the output context given by the user
     unsigned int n = _user_batch_size;
     const size_t c = output_depth();
@@ -912,7 +1122,6 @@ MasterGraph::to_tensor(void *out_ptr, RocalTensorFormat format, float multiplier
             }
         }
     }
-    _convert_time.end();
     return Status::OK;
 }
 
@@ -927,7 +1136,7 @@ MasterGraph::copy_output(unsigned char *out_ptr, size_t out_size_in_bytes)
     if (out_size_in_bytes != (size *_output_images.size()))
         return MasterGraph::Status::INVALID_ARGUMENTS;
 
-    _convert_time.start();
+    TimingScope convert_timing(_convert_time);
 
 #if ENABLE_OPENCL
     if(processing_on_device_ocl())
@@ -984,21 +1193,188 @@ MasterGraph::copy_output(unsigned char *out_ptr, size_t out_size_in_bytes)
 #if ENABLE_OPENCL || ENABLE_HIP
     }
 #endif    
-    _convert_time.end();
     return Status::OK;
 }
 
+MasterGraph::Status
+MasterGraph::lease_output(void **out_ptr, size_t *out_size, int *lease_id)
+{
+    if(no_more_processed_data())
+        return MasterGraph::Status::NO_MORE_DATA;
+    if(_mem_type != RocalMemType::HOST)
+        THROW("Output buffers can only be leased when processing on the host")
+
+    // lease_read_slot() blocks if _ring_buffer is empty, till internal processing thread process a new batch and store in the _ring_buffer
+    auto slot = _ring_buffer.lease_read_slot();
+    *out_ptr = _ring_buffer.get_host_master_buffer(slot);
+    *out_size = output_byte_size() * _output_images.size();
+    *lease_id = slot;
+    return Status::OK;
+}
+
+MasterGraph::Status
+MasterGraph::release_output_lease(int lease_id)
+{
+    if(lease_id < 0)
+        return MasterGraph::Status::INVALID_ARGUMENTS;
+    _ring_buffer.release_lease(lease_id);
+    return Status::OK;
+}
+
+size_t
+MasterGraph::ragged_output_layout(std::vector<unsigned> &shapes, std::vector<size_t> &offsets)
+{
+    const size_t planes = output_depth();
+    const size_t full_width = output_width();
+    const size_t full_height = output_height() / _user_batch_size;
+    // Batches pushed without the sizes of their samples (e.g. video) are copied with every sample at the full output size
+    auto &output_roi = _ring_buffer.get_output_roi();
+    shapes.clear();
+    offsets.clear();
+    size_t offset = 0;
+    for (size_t out_idx = 0; out_idx < _output_images.size(); out_idx++)
+    {
+        bool has_roi = out_idx < output_roi.width.size();
+        for (size_t sample_idx = 0; sample_idx < _user_batch_size; sample_idx++)
+        {
+            size_t width = has_roi ? std::min<size_t>(output_roi.width[out_idx][sample_idx], full_width) : full_width;
+            size_t height = has_roi ? std::min<size_t>(output_roi.height[out_idx][sample_idx], full_height) : full_height;
+            shapes.insert(shapes.end(), {(unsigned)height, (unsigned)width, (unsigned)planes});
+            offsets.push_back(offset);
+            offset += height * width * planes * SAMPLE_SIZE;
+        }
+    }
+    return offset;
+}
+
+size_t
+MasterGraph::ragged_output_byte_size()
+{
+    std::vector<unsigned> shapes;
+    std::vector<size_t> offsets;
+    return ragged_output_layout(shapes, offsets);
+}
+
+MasterGraph::Status
+MasterGraph::copy_output_ragged(unsigned char *out_ptr, size_t out_size_in_bytes, unsigned *shapes, size_t *offsets)
+{
+    if(no_more_processed_data())
+        return MasterGraph::Status::NO_MORE_DATA;
+
+    if(output_color_format() == RocalColorFormat::RGB_PLANAR)
+        THROW("Ragged output is not supported for planar color formats")
+
+    std::vector<unsigned> sample_shapes;
+    std::vector<size_t> sample_offsets;
+    size_t packed_size = ragged_output_layout(sample_shapes, sample_offsets);
+    if (out_size_in_bytes < packed_size)
+        return MasterGraph::Status::INVALID_ARGUMENTS;
+
+    TimingScope convert_timing(_convert_time);
+    // Rows of a sample are strided by the full output width in the ring buffer and packed by the sample's own width in out_ptr
+    const size_t src_row_size = output_width() * output_depth() * SAMPLE_SIZE;
+    const size_t src_sample_size = src_row_size * (output_height() / _user_batch_size);
+    // get_read_buffers() calls block_if_empty() internally and blocks if buffers are empty until a new batch is processed
+    auto output_buffers = _ring_buffer.get_read_buffers();
+#if ENABLE_OPENCL
+    if(processing_on_device_ocl())
+    {
+        for (size_t out_idx = 0; out_idx < output_buffers.size(); out_idx++)
+        {
+            for (size_t sample_idx = 0; sample_idx < _user_batch_size; sample_idx++)
+            {
+                size_t idx = out_idx * _user_batch_size + sample_idx;
+                size_t dst_row_size = sample_shapes[idx * 3 + 1] * sample_shapes[idx * 3 + 2] * SAMPLE_SIZE;
+                size_t buffer_origin[3] = {0, sample_idx * (src_sample_size / src_row_size), 0};
+                size_t host_origin[3] = {0, 0, 0};
+                size_t region[3] = {dst_row_size, sample_shapes[idx * 3], 1};
+                if (!dst_row_size || !region[1])
+                    continue;
+                cl_int status;
+                if((status = clEnqueueReadBufferRect(_device.resources()->cmd_queue, (cl_mem)output_buffers[out_idx], CL_FALSE,
+                                                     buffer_origin, host_origin, region, src_row_size, 0, dst_row_size, 0,
+                                                     out_ptr + sample_offsets[idx], 0, nullptr, nullptr)) != CL_SUCCESS)
+                    THROW("clEnqueueReadBufferRect failed: " + TOSTR(status))
+            }
+        }
+        if (clFinish(_device.resources()->cmd_queue) != CL_SUCCESS)
+            THROW("clFinish failed for clEnqueueReadBufferRect")
+    }
+    else {
+#elif ENABLE_HIP
+    if(processing_on_device_hip())
+    {
+        for (size_t out_idx = 0; out_idx < output_buffers.size(); out_idx++)
+        {
+            for (size_t sample_idx = 0; sample_idx < _user_batch_size; sample_idx++)
+            {
+                size_t idx = out_idx * _user_batch_size + sample_idx;
+                size_t dst_row_size = sample_shapes[idx * 3 + 1] * sample_shapes[idx * 3 + 2] * SAMPLE_SIZE;
+                if (!dst_row_size || !sample_shapes[idx * 3])
+                    continue;
+                hipError_t err = hipMemcpy2DAsync(out_ptr + sample_offsets[idx], dst_row_size, (unsigned char *)output_buffers[out_idx] + sample_idx * src_sample_size,
+                                                  src_row_size, dst_row_size, sample_shapes[idx * 3], hipMemcpyDeviceToHost, _device.resources()->hip_stream);
+                if (err)
+                    THROW("hipMemcpy2DAsync failed: " + TOSTR(err))
+            }
+        }
+        // sync to finish copy
+        if (hipStreamSynchronize(_device.resources()->hip_stream) != hipSuccess)
+            THROW("hipStreamSynchronize failed for hipMemcpy2DAsync")
+    }
+    else {
+#endif
+        for (size_t out_idx = 0; out_idx < output_buffers.size(); out_idx++)
+        {
+            auto src_buffer = static_cast<unsigned char *>(output_buffers[out_idx]);
+#pragma omp parallel for num_threads(_cpu_num_threads)
+            for (size_t sample_idx = 0; sample_idx < _user_batch_size; sample_idx++)
+            {
+                size_t idx = out_idx * _user_batch_size + sample_idx;
+                size_t dst_row_size = sample_shapes[idx * 3 + 1] * sample_shapes[idx * 3 + 2] * SAMPLE_SIZE;
+                auto src_ptr = src_buffer + sample_idx * src_sample_size;
+                auto dst_ptr = out_ptr + sample_offsets[idx];
+                if (dst_row_size == src_row_size)
+                {
+                    memcpy(dst_ptr, src_ptr, dst_row_size * sample_shapes[idx * 3]);
+                    continue;
+                }
+                for (unsigned row = 0; row < sample_shapes[idx * 3]; row++)
+                    memcpy(dst_ptr + row * dst_row_size, src_ptr + row * src_row_size, dst_row_size);
+            }
+        }
+#if ENABLE_OPENCL || ENABLE_HIP
+    }
+#endif
+    if (shapes)
+        memcpy(shapes, sample_shapes.data(), sample_shapes.size() * sizeof(unsigned));
+    if (offsets)
+        memcpy(offsets, sample_offsets.data(), sample_offsets.size() * sizeof(size_t));
+    return Status::OK;
+}
+
+// The image pipeline runs in stages so that the host side work of consecutive batches overlaps the graph execution:
+// while the graph processes batch N, the meta data stage augments the meta data of batch N and renews the random parameters
+// of batch N+1, and the commit stage box encodes batch N-1 and pushes it to the ring buffer. Each batch in flight keeps its
+// own ring buffer slot and meta data in a PipelineSlot. Loading, updating the node parameters and running the graph stay on
+// this thread since they share the OpenVX objects of the graph.
 void MasterGraph::output_routine()
 {
     INFO("Output routine started with "+TOSTR(_remaining_count) + " to load");
+    place_processing_thread();
+    TraceRecorder::instance()->set_thread_name("Output routine");
+    start_pipeline_stages();
+    int64_t batch_index = 0;
     try {
+        // Parameters of the first batch are renewed here, the meta data stage renews them ahead for the next batches
+        ParameterFactory::instance()->renew_parameters();
         while (_processing)
         {
-            ImageNameBatch full_batch_image_names = {};
-            pMetaDataBatch full_batch_meta_data = nullptr;
-            pMetaDataBatch augmented_batch_meta_data = nullptr;
             if (_loader_module->remaining_count() < (_is_sequence_reader_output ? _sequence_batch_size : _user_batch_size))
             {
+                // Batches still in flight are pushed to the ring buffer before the user thread is told processing is finished
+                if (!wait_for_pipeline_stages(true))
+                    break;
                 // If the internal process routine ,output_routine(), has finished processing all the images, and last
                 // processed images stored in the _ring_buffer will be consumed by the user when it calls the run() func
                 notify_user_thread();
@@ -1007,12 +1383,19 @@ void MasterGraph::output_routine()
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
                 continue;
             }
+            TraceRecorder::set_thread_batch(batch_index);
+            _pipeline_time.start();
             _rb_block_if_full_time.start();
-            // _ring_buffer.get_write_buffers() is blocking and blocks here until user uses processed image by calling run() and frees space in the ring_buffer
-            auto write_buffers = _ring_buffer.get_write_buffers();
+            // _ring_buffer.reserve_write_slot() is blocking and blocks here until user uses processed image by calling run() and frees space in the ring_buffer
+            PipelineSlot slot;
+            slot.batch_index = batch_index++;
+            slot.ring_slot = _ring_buffer.reserve_write_slot();
             _rb_block_if_full_time.end();
 
+            if (!_processing)
+                break;
             _process_time.start();
+            _prepare_stage_time.start();
 
             // Swap handles on the input image, so that new image is loaded to be processed
             auto load_ret = _loader_module->load_next();
@@ -1021,23 +1404,28 @@ void MasterGraph::output_routine()
 
             if (!_processing)
                 break;
-            auto this_cycle_names =  _loader_module->get_id();
-            auto decode_image_info = _loader_module->get_decode_image_info();
-            auto crop_image_info = _loader_module->get_crop_image_info();
+            slot.names = _loader_module->get_id();
+            slot.decode_info = _loader_module->get_decode_image_info();
+            slot.crop_info = _loader_module->get_crop_image_info();
 
-            if(this_cycle_names.size() != _user_batch_size)
-                WRN("Internal problem: names count "+ TOSTR(this_cycle_names.size()))
+            if(slot.names.size() != _user_batch_size)
+                WRN("Internal problem: names count "+ TOSTR(slot.names.size()))
 
             // meta_data lookup is done before _meta_data_graph->process() is called to have the new meta_data ready for processing
             if (_meta_data_reader)
-                _meta_data_reader->lookup(this_cycle_names);
-
-            full_batch_image_names += this_cycle_names;
+            {
+                if (_is_mask_output)
+                    _mask_load_time.start();
+                _meta_data_reader->lookup(slot.names);
+                if (_is_mask_output)
+                    _mask_load_time.end();
+            }
 
             if (!_processing)
                 break;
 
-            // Swap handles on the output images, so that new processed image will be written to the a new buffer
+            // Swap handles on the output images, so that new processed image will be written to the reserved slot of the ring buffer
+            auto write_buffers = _ring_buffer.get_write_buffers(slot.ring_slot);
             for (size_t idx = 0; idx < _output_images.size(); idx++)
             {
                 _output_images[idx]->swap_handle(write_buffers[idx]);
@@ -1054,49 +1442,197 @@ void MasterGraph::output_routine()
                 }
             }
 
-            update_node_parameters();
-            if(_augmented_meta_data)
+            // Apply the parameters renewed for this batch to VX parameters used in augmentation, the streams are keyed on
+            // the sample keys since the names can repeat across the sub folders of the dataset
+            if (slot.decode_info._sample_keys.size() == slot.names.size())
+                apply_node_parameters(slot.decode_info._sample_keys);
+            else
+                apply_node_parameters(slot.names);
+            // The nodes set the output ROIs of this batch, they are kept with the batch for the ragged output copy
+            for (auto &output_image: _output_images)
+            {
+                slot.output_roi.width.push_back(output_image->info().get_roi_width_vec());
+                slot.output_roi.height.push_back(output_image->info().get_roi_height_vec());
+            }
+            _prepare_stage_time.end();
+
+            // The meta data of this batch is augmented while the graph runs, both only read the parameters applied above
+            {
+                std::unique_lock<std::mutex> lock(_pipeline_lock);
+                _meta_data_stage_slot = std::move(slot);
+                _meta_data_stage_busy = true;
+            }
+            _pipeline_cv.notify_all();
+            _graph_stage_time.start();
+            _graph->process();
+            _graph_stage_time.end();
+
+            // The meta data stage is done before the next lookup and parameter update, then the batch moves to the commit stage
+            if (!wait_for_pipeline_stages(false))
+                break;
+            {
+                std::unique_lock<std::mutex> lock(_pipeline_lock);
+                _commit_queue.push(std::move(_meta_data_stage_slot));
+            }
+            _pipeline_cv.notify_all();
+            _process_time.end();
+            _pipeline_time.end();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        ERR("Exception thrown in the process routine: " + STR(e.what()) + STR("\n"));
+        _processing = false;
+        _ring_buffer.release_all_blocked_calls();
+    }
+    stop_pipeline_stages();
+}
+
+void MasterGraph::meta_data_stage_routine()
+{
+    TraceRecorder::instance()->set_thread_name("Meta data stage");
+    std::unique_lock<std::mutex> lock(_pipeline_lock);
+    while (_pipeline_running)
+    {
+        _pipeline_cv.wait(lock, [this] { return !_pipeline_running || _meta_data_stage_busy; });
+        if (!_pipeline_running)
+            break;
+        lock.unlock();
+        TraceRecorder::set_thread_batch(_meta_data_stage_slot.batch_index);
+        try
+        {
+            _meta_data_stage_time.start();
+            auto &slot = _meta_data_stage_slot;
+            if (_augmented_meta_data)
             {
                 if (_meta_data_graph)
                 {
-                    if(_is_random_bbox_crop)
+                    // Boxes are only adjusted when the loader has applied the RandomBBoxCrop windows while decoding
+                    if (_is_random_bbox_crop && !slot.crop_info._crop_image_coords.empty())
                     {
-                        _meta_data_graph->update_random_bbox_meta_data(_augmented_meta_data, decode_image_info, crop_image_info);
+                        _meta_data_graph->update_random_bbox_meta_data(_augmented_meta_data, slot.decode_info, slot.crop_info);
                     }
                     _meta_data_graph->process(_augmented_meta_data);
                 }
-                if (full_batch_meta_data)
-                    full_batch_meta_data->concatenate(_augmented_meta_data);
-                else
-                    full_batch_meta_data = _augmented_meta_data->clone();
+                // The reader's output is refilled by the lookup of the next batch, the slot takes over its buffers
+                slot.meta_data = _augmented_meta_data->take();
+                if (_label_encoder)
+                {
+                    auto label_encoder_write_buffers = _ring_buffer.get_label_encoder_write_buffers(slot.ring_slot);
+                    _label_encoder->Run(slot.meta_data, (float *)label_encoder_write_buffers.first, (float *)label_encoder_write_buffers.second);
+                }
             }
-            _graph->process();
+            // Randomize random parameters of the next batch, the values of this batch are already in the VX parameters
+            ParameterFactory::instance()->renew_parameters();
+            _meta_data_stage_time.end();
+        }
+        catch (const std::exception &e)
+        {
+            ERR("Exception thrown in the meta data stage: " + STR(e.what()) + STR("\n"));
+            _processing = false;
+            _pipeline_stage_failed = true;
+            _ring_buffer.release_all_blocked_calls();
+        }
+        lock.lock();
+        _meta_data_stage_busy = false;
+        _pipeline_cv.notify_all();
+    }
+}
+
+void MasterGraph::commit_stage_routine()
+{
+    TraceRecorder::instance()->set_thread_name("Commit stage");
+    std::unique_lock<std::mutex> lock(_pipeline_lock);
+    while (_pipeline_running)
+    {
+        _pipeline_cv.wait(lock, [this] { return !_pipeline_running || !_commit_queue.empty(); });
+        if (!_pipeline_running)
+            break;
+        auto slot = std::move(_commit_queue.front());
+        _commit_queue.pop();
+        _commit_stage_busy = true;
+        lock.unlock();
+        TraceRecorder::set_thread_batch(slot.batch_index);
+        try
+        {
+            _commit_stage_time.start();
             _bencode_time.start();
-            if(_is_box_encoder )
+            if(_is_box_encoder)
             {
+                // get bbox encoder write buffers of the slot reserved for this batch
+                auto bbox_encode_write_buffers = _ring_buffer.get_box_encode_write_buffers(slot.ring_slot);
 #if ENABLE_HIP
-                if(_mem_type == RocalMemType::HIP){
-                    // get bbox encoder read buffers
-                    auto bbox_encode_write_buffers = _ring_buffer.get_box_encode_write_buffers();
-                    if (_box_encoder_gpu) _box_encoder_gpu->Run(full_batch_meta_data, (float *)bbox_encode_write_buffers.first, (int *)bbox_encode_write_buffers.second);
-                    //_meta_data_graph->update_box_encoder_meta_data_gpu(_anchors_gpu_buf, num_anchors, full_batch_meta_data, _criteria, _offset, _scale, _means, _stds);
-                }else
+                if (_box_encoder_gpu)
+                    _box_encoder_gpu->Run(slot.meta_data, (float *)bbox_encode_write_buffers.first, (int *)bbox_encode_write_buffers.second);
+                else
 #endif
-                    _meta_data_graph->update_box_encoder_meta_data(&_anchors, full_batch_meta_data, _criteria, _offset, _scale, _means, _stds);
+                    _box_encoder_cpu->Run(slot.meta_data, (float *)bbox_encode_write_buffers.first, (int *)bbox_encode_write_buffers.second);
             }
             _bencode_time.end();
-            _ring_buffer.set_meta_data(full_batch_image_names, full_batch_meta_data);
-            _ring_buffer.push(); // Image data and metadata is now stored in output the ring_buffer, increases it's level by 1
+            if (_heatmap_generator && slot.meta_data)
+            {
+                auto heatmap_write_buffers = _ring_buffer.get_heatmap_write_buffers(slot.ring_slot);
+                _heatmap_generator->Run(slot.meta_data, (float *)heatmap_write_buffers.first, (float *)heatmap_write_buffers.second);
+            }
+            if (_label_encoder && _label_encoder->is_mixing() && slot.meta_data)
+            {
+                // The mix parameters were drawn with the targets in the meta data stage
+                auto mix_params = (const float *)_ring_buffer.get_label_encoder_write_buffers(slot.ring_slot).second;
+                _label_encoder->mix_images(mix_params, _ring_buffer.get_write_buffers(slot.ring_slot), output_width(), _output_image_info.height_single(),
+                                           output_depth(), output_color_format() == RocalColorFormat::RGB_PLANAR, slot.output_roi.width, slot.output_roi.height);
+            }
+            _ring_buffer.push_reserved(std::move(slot.names), slot.meta_data, std::move(slot.output_roi)); // Image data and metadata is now stored in output the ring_buffer, increases it's level by 1
+            _commit_stage_time.end();
+        }
+        catch (const std::exception &e)
+        {
+            ERR("Exception thrown in the commit stage: " + STR(e.what()) + STR("\n"));
+            _processing = false;
+            _pipeline_stage_failed = true;
+            _ring_buffer.release_all_blocked_calls();
         }
-        _process_time.end();
+        lock.lock();
+        _commit_stage_busy = false;
+        _pipeline_cv.notify_all();
+    }
+}
 
+void MasterGraph::start_pipeline_stages()
+{
+    {
+        std::unique_lock<std::mutex> lock(_pipeline_lock);
+        _pipeline_running = true;
+        _pipeline_stage_failed = false;
+        _meta_data_stage_busy = false;
+        _commit_stage_busy = false;
+        _commit_queue = std::queue<PipelineSlot>();
     }
-    catch (const std::exception &e)
+    _meta_data_stage_thread = std::thread(&MasterGraph::meta_data_stage_routine, this);
+    _commit_stage_thread = std::thread(&MasterGraph::commit_stage_routine, this);
+}
+
+void MasterGraph::stop_pipeline_stages()
+{
     {
-        ERR("Exception thrown in the process routine: " + STR(e.what()) + STR("\n"));
-        _processing = false;
-        _ring_buffer.release_all_blocked_calls();
+        std::unique_lock<std::mutex> lock(_pipeline_lock);
+        // The meta data stage is let finish the batch it is given since it uses the meta data reader's output
+        _pipeline_cv.wait(lock, [this] { return !_meta_data_stage_busy; });
+        _pipeline_running = false;
     }
+    _pipeline_cv.notify_all();
+    if (_meta_data_stage_thread.joinable())
+        _meta_data_stage_thread.join();
+    if (_commit_stage_thread.joinable())
+        _commit_stage_thread.join();
+}
+
+bool MasterGraph::wait_for_pipeline_stages(bool commit_stage)
+{
+    std::unique_lock<std::mutex> lock(_pipeline_lock);
+    _pipeline_cv.wait(lock, [this, commit_stage] {
+        return _pipeline_stage_failed || (!_meta_data_stage_busy && (!commit_stage || (_commit_queue.empty() && !_commit_stage_busy)));
+    });
+    return !_pipeline_stage_failed;
 }
 
 #ifdef ROCAL_VIDEO
@@ -1104,6 +1640,9 @@ void MasterGraph::output_routine_video()
 {
     _process_time.start();
     INFO("Output routine of video pipeline started with "+TOSTR(_remaining_count) + " to load");
+    place_processing_thread();
+    TraceRecorder::instance()->set_thread_name("Video output routine");
+    int64_t batch_index = 0;
     try {
         while (_processing)
         {
@@ -1121,6 +1660,7 @@ void MasterGraph::output_routine_video()
                 continue;
             }
 
+            TraceRecorder::set_thread_batch(batch_index++);
             // _ring_buffer.get_write_buffers() is blocking and blocks here until user uses processed image by calling run() and frees space in the ring_buffer
             _rb_block_if_full_time.start();
             auto write_buffers = _ring_buffer.get_write_buffers();
@@ -1167,7 +1707,7 @@ void MasterGraph::output_routine_video()
                 }
             }
 
-            update_node_parameters();
+            update_node_parameters(this_cycle_names);
             if(_augmented_meta_data)
             {
                 if (_meta_data_graph)
@@ -1177,12 +1717,23 @@ void MasterGraph::output_routine_video()
                 if (full_batch_meta_data)
                     full_batch_meta_data->concatenate(_augmented_meta_data);
                 else
-                    full_batch_meta_data = _augmented_meta_data->clone();
+                    full_batch_meta_data = _augmented_meta_data->take();
             }
             _graph->process();
             if(_is_box_encoder )
             {
-                _meta_data_graph->update_box_encoder_meta_data(&_anchors, full_batch_meta_data, _criteria, _offset, _scale, _means, _stds);
+                auto bbox_encode_write_buffers = _ring_buffer.get_box_encode_write_buffers();
+#if ENABLE_HIP
+                if (_box_encoder_gpu)
+                    _box_encoder_gpu->Run(full_batch_meta_data, (float *)bbox_encode_write_buffers.first, (int *)bbox_encode_write_buffers.second);
+                else
+#endif
+                    _box_encoder_cpu->Run(full_batch_meta_data, (float *)bbox_encode_write_buffers.first, (int *)bbox_encode_write_buffers.second);
+            }
+            if (_label_encoder && full_batch_meta_data)
+            {
+                auto label_encoder_write_buffers = _ring_buffer.get_label_encoder_write_buffers();
+                _label_encoder->Run(full_batch_meta_data, (float *)label_encoder_write_buffers.first, (float *)label_encoder_write_buffers.second);
             }
             _ring_buffer.set_meta_data(full_batch_image_names, full_batch_meta_data);
             _ring_buffer.push(); // Image data and metadata is now stored in output the ring_buffer, increases it's level by 1
@@ -1244,6 +1795,10 @@ MetaDataBatch * MasterGraph::create_coco_meta_data_reader(const char *source_pat
     MetaDataConfig config(label_type, reader_type, source_path, std::map<std::string, std::string>(), std::string());
     config.set_out_img_width(pose_output_width);
     config.set_out_img_height(pose_output_height);
+    _pose_sigma = sigma;
+    _pose_output_width = pose_output_width;
+    _pose_output_height = pose_output_height;
+    _is_mask_output = label_type == MetaDataType::PolygonMask;
     _meta_data_graph = create_meta_data_graph(config);
     _meta_data_reader = create_meta_data_reader(config);
     _meta_data_reader->init(config);
@@ -1331,6 +1886,8 @@ void MasterGraph::create_randombboxcrop_reader(RandomBBoxCrop_MetaDataReaderType
 {
     if( _randombboxcrop_meta_data_reader)
         THROW("A metadata reader has already been created")
+    if(_loader_module)
+        WRN("RandomBBoxCrop is created after the loader, the loader cannot use its crop windows for partial decode")
     _is_random_bbox_crop = true;
     RandomBBoxCrop_MetaDataConfig config(label_type, reader_type, all_boxes_overlap, no_crop, aspect_ratio, has_shape, crop_width, crop_height, num_attempts, scaling, total_num_attempts, seed);
     _randombboxcrop_meta_data_reader = create_meta_data_reader(config);
@@ -1341,6 +1898,23 @@ void MasterGraph::create_randombboxcrop_reader(RandomBBoxCrop_MetaDataReaderType
         _random_bbox_crop_cords_data = _randombboxcrop_meta_data_reader->get_output();
 }
 
+void MasterGraph::heatmap_targets(unsigned heatmap_width, unsigned heatmap_height, float sigma)
+{
+    if (!_meta_data_reader || !_pose_output_width || !_pose_output_height)
+        THROW("HeatmapTargets needs the COCO keypoints reader to be created first with the pose output size")
+    if (sigma <= 0)
+        sigma = _pose_sigma;
+    _heatmap_generator = std::make_unique<HeatmapGeneratorCpu>(_user_batch_size, _pose_output_width, _pose_output_height, heatmap_width, heatmap_height, sigma);
+}
+
+void MasterGraph::label_encoder(unsigned num_classes, float on_value, float off_value, float mixup_alpha, float cutmix_alpha, float mix_probability)
+{
+    if (!_meta_data_reader)
+        THROW("LabelEncoder needs a meta data reader to be created first")
+    _label_encoder = std::make_unique<LabelEncoderCpu>(_user_batch_size, num_classes, on_value, off_value, mixup_alpha, cutmix_alpha, mix_probability,
+                                                       ParameterFactory::instance()->get_seed());
+}
+
 void MasterGraph::box_encoder(std::vector<float> &anchors, float criteria, const std::vector<float> &means, const std::vector<float> &stds, bool offset, float scale)
 {
     _is_box_encoder = true;
@@ -1354,11 +1928,7 @@ void MasterGraph::box_encoder(std::vector<float> &anchors, float criteria, const
         return;
     }
 #endif
-    _offset = offset;
-    _anchors = anchors;
-    _scale = scale;
-    _means = means;
-    _stds = stds;
+    _box_encoder_cpu = std::make_unique<BoxEncoderCpu>(_user_batch_size, anchors, criteria, means, stds, offset, scale);
 }
 
 MetaDataBatch * MasterGraph::create_caffe2_lmdb_record_meta_data_reader(const char *source_path, MetaDataReaderType reader_type , MetaDataType label_type)
@@ -1421,12 +1991,32 @@ size_t MasterGraph::bounding_box_batch_count(int *buf, pMetaDataBatch meta_data_
     size_t size = 0;
     for(unsigned i = 0; i < _user_batch_size; i++)
     {
-        buf[i] = _is_box_encoder? _num_anchors: meta_data_batch->get_bb_labels_batch()[i].size();
+        buf[i] = _is_box_encoder? _num_anchors: meta_data_batch->get_bb_batch().count(i);
         size += buf[i];
     }
     return size;
 }
 
+const MaskPolygonBatch& MasterGraph::mask_polygons(pMetaDataBatch meta_data_batch)
+{
+    // The count, vertex and coordinate calls of a batch share the polygons moved for the first one
+    if (_mask_polygons_batch.lock() != meta_data_batch)
+    {
+        _mask_process_time.start();
+        ::mask_polygons(meta_data_batch->get_bb_batch(), _mask_polygons);
+        _mask_polygons_batch = meta_data_batch;
+        _mask_process_time.end();
+    }
+    return _mask_polygons;
+}
+
+void MasterGraph::rasterize_masks(pMetaDataBatch meta_data_batch, unsigned width, unsigned height, unsigned char *buf)
+{
+    _mask_process_time.start();
+    ::rasterize_masks(meta_data_batch->get_bb_batch(), width, height, buf);
+    _mask_process_time.end();
+}
+
 size_t MasterGraph::output_sample_size()
 {
     return output_height() * output_width() * output_depth();
@@ -1462,7 +2052,7 @@ MasterGraph::copy_out_tensor_planar(void *out_ptr, RocalTensorFormat format, flo
     if(no_more_processed_data())
         return MasterGraph::Status::NO_MORE_DATA;
 
-    _convert_time.start();
+    TimingScope convert_timing(_convert_time);
     // Copies to the output context given by the user, each image is copied separate for planar
     const size_t w = output_width();
     const size_t h = _output_image_info.height_single();
@@ -1609,7 +2199,6 @@ MasterGraph::copy_out_tensor_planar(void *out_ptr, RocalTensorFormat format, flo
             dest_buf_offset += single_output_image_size;
         }
     }
-    _convert_time.end();
     return Status::OK;
 }
 
@@ -1626,3 +2215,101 @@ MasterGraph::get_bbox_encoded_buffers(float **boxes_buf_ptr, int **labels_buf_pt
     }
     return Status::OK;
 }
+
+MasterGraph::Status
+MasterGraph::copy_bbox_encoded_buffers(float *boxes_buf, int *labels_buf)
+{
+    if (!_is_box_encoder)
+        THROW("Box encoder is not part of the pipeline")
+    auto encoded_boxes_and_lables = _ring_buffer.get_box_encode_read_buffers();
+    size_t box_count = _user_batch_size * _num_anchors;
+#if ENABLE_HIP
+    if (_mem_type == RocalMemType::HIP)
+    {
+        hipError_t err = hipSuccess;
+        if (boxes_buf)
+            err = hipMemcpyDtoH(boxes_buf, encoded_boxes_and_lables.first, box_count * 4 * sizeof(float));
+        if (err == hipSuccess && labels_buf)
+            err = hipMemcpyDtoH(labels_buf, encoded_boxes_and_lables.second, box_count * sizeof(int));
+        if (err != hipSuccess)
+            THROW("hipMemcpyDtoH failed for the encoded boxes and labels " + TOSTR(err))
+        return Status::OK;
+    }
+#endif
+    if (boxes_buf)
+        memcpy(boxes_buf, encoded_boxes_and_lables.first, box_count * 4 * sizeof(float));
+    if (labels_buf)
+        memcpy(labels_buf, encoded_boxes_and_lables.second, box_count * sizeof(int));
+    return Status::OK;
+}
+
+MasterGraph::Status
+MasterGraph::get_heatmap_targets(float **heatmaps_ptr, float **target_weights_ptr)
+{
+    if (!_heatmap_generator)
+        THROW("HeatmapTargets is not part of the pipeline")
+    auto heatmap_read_buffers = _ring_buffer.get_heatmap_read_buffers();
+    *heatmaps_ptr = (float *)heatmap_read_buffers.first;
+    *target_weights_ptr = (float *)heatmap_read_buffers.second;
+    return Status::OK;
+}
+
+MasterGraph::Status
+MasterGraph::copy_heatmap_targets(float *heatmaps, float *target_weights)
+{
+    if (!_heatmap_generator)
+        THROW("HeatmapTargets is not part of the pipeline")
+    auto heatmap_read_buffers = _ring_buffer.get_heatmap_read_buffers();
+    memcpy(heatmaps, heatmap_read_buffers.first, _heatmap_generator->heatmaps_size() * sizeof(float));
+    memcpy(target_weights, heatmap_read_buffers.second, _heatmap_generator->target_weights_size() * sizeof(float));
+    return Status::OK;
+}
+
+MasterGraph::Status
+MasterGraph::heatmap_targets_size(size_t *heatmaps_size, size_t *target_weights_size)
+{
+    if (!_heatmap_generator)
+        THROW("HeatmapTargets is not part of the pipeline")
+    *heatmaps_size = _heatmap_generator->heatmaps_size();
+    *target_weights_size = _heatmap_generator->target_weights_size();
+    return Status::OK;
+}
+
+MasterGraph::Status
+MasterGraph::get_encoded_labels(float **targets_ptr, float **mix_params_ptr)
+{
+    if (!_label_encoder)
+        THROW("LabelEncoder is not part of the pipeline")
+    auto label_encoder_read_buffers = _ring_buffer.get_label_encoder_read_buffers();
+    *targets_ptr = (float *)label_encoder_read_buffers.first;
+    if (mix_params_ptr)
+        *mix_params_ptr = (float *)label_encoder_read_buffers.second;
+    return Status::OK;
+}
+
+MasterGraph::Status
+MasterGraph::copy_encoded_labels(void *targets, float *mix_params, bool to_device)
+{
+    if (!_label_encoder)
+        THROW("LabelEncoder is not part of the pipeline")
+    auto label_encoder_read_buffers = _ring_buffer.get_label_encoder_read_buffers();
+    size_t targets_bytes = _label_encoder->targets_size() * sizeof(float);
+    if (mix_params)
+        memcpy(mix_params, label_encoder_read_buffers.second, _label_encoder->mix_params_size() * sizeof(float));
+    if (!to_device)
+    {
+        memcpy(targets, label_encoder_read_buffers.first, targets_bytes);
+        return Status::OK;
+    }
+#if ENABLE_HIP
+    hipError_t err = hipMemcpyHtoD(targets, label_encoder_read_buffers.first, targets_bytes);
+    if (err != hipSuccess)
+        THROW("hipMemcpyHtoD failed for the encoded labels " + TOSTR(err))
+#elif ENABLE_OPENCL
+    if (clEnqueueWriteBuffer(_device.resources()->cmd_queue, (cl_mem)targets, CL_TRUE, 0, targets_bytes, label_encoder_read_buffers.first, 0, NULL, NULL) != CL_SUCCESS)
+        THROW("clEnqueueWriteBuffer failed for the encoded labels")
+#else
+    THROW("Copying the encoded labels to a device needs a GPU backend")
+#endif
+    return Status::OK;
+}
@@ -68,4 +68,6 @@ Node::update_src_roi()
     height_status = vxCopyArrayRange((vx_array)_src_roi_height, 0, _batch_size, sizeof(vx_uint32), _inputs[0]->info().get_roi_height(), VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
     if(width_status != 0 || height_status != 0)
         THROW(" Failed calling vxCopyArrayRange for width / height status : "+ TOSTR(width_status) + " / "+ TOSTR(height_status))
+    _src_roi_width_val.assign(_inputs[0]->info().get_roi_width(), _inputs[0]->info().get_roi_width() + _batch_size);
+    _src_roi_height_val.assign(_inputs[0]->info().get_roi_height(), _inputs[0]->info().get_roi_height() + _batch_size);
 }
\ No newline at end of file
@@ -0,0 +1,108 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include "prefetch_tuner.h"
+
+namespace
+{
+// Mean duration of the runs of a stage between two snapshots of the statistics
+double mean_duration(const RocalLatencyStats &now, const RocalLatencyStats &before)
+{
+    auto count = now.count - before.count;
+    return count ? static_cast<double>(now.total - before.total) / count : 0;
+}
+}
+
+size_t PrefetchTuner::depth_within_budget(size_t memory_budget, size_t batch_size_in_bytes, size_t min_depth)
+{
+    if (batch_size_in_bytes == 0)
+        return min_depth;
+    return std::max(min_depth, std::min(MAX_DEPTH, memory_budget / batch_size_in_bytes));
+}
+
+PrefetchTuner::PrefetchTuner(size_t depth, size_t max_depth, size_t decode_threads, size_t max_decode_threads,
+                             size_t shard_count, unsigned tuning_batch_count):
+        _depth(depth),
+        _max_depth(std::max(depth, max_depth)),
+        _decode_threads(decode_threads),
+        _max_decode_threads(std::max(decode_threads, max_decode_threads)),
+        _shard_count(std::max<size_t>(shard_count, 1)),
+        _tuning_batch_count(tuning_batch_count),
+        _window_start(std::chrono::steady_clock::now())
+{
+}
+
+bool PrefetchTuner::count_batch()
+{
+    _batch_count++;
+    return (_batch_count % WINDOW_SIZE) == 0 || done();
+}
+
+bool PrefetchTuner::update(const RocalPipelineStats &stats)
+{
+    auto now = std::chrono::steady_clock::now();
+    double window_time = std::chrono::duration<double, std::micro>(now - _window_start).count();
+    auto before = _window_start_stats;
+    _window_start_stats = stats;
+    _window_start = now;
+    // The first window includes filling the buffers and warming up the decoders, it is not representative
+    if (_first_window)
+    {
+        _first_window = false;
+        return false;
+    }
+    double interval = window_time / WINDOW_SIZE;
+    double user_wait = static_cast<double>(stats.output_wait.total - before.output_wait.total) / WINDOW_SIZE;
+    double pipeline_wait = static_cast<double>(stats.consumer_wait.total - before.consumer_wait.total) / WINDOW_SIZE;
+    // The shards load their batches in parallel, every shard provides one batch out of _shard_count
+    double load_time = (mean_duration(stats.read, before.read) + mean_duration(stats.decode, before.decode)) / _shard_count;
+    double graph_time = mean_duration(stats.graph, before.graph);
+
+    Action action = Action::NONE;
+    if (user_wait > STARVING_RATIO * interval)
+    {
+        if (_decode_threads > 0 && load_time >= graph_time && _decode_threads < _max_decode_threads)
+            action = Action::MORE_THREADS;
+        else if (_depth < _max_depth)
+            action = Action::DEEPER;
+    }
+    else if (pipeline_wait > IDLE_RATIO * interval && _last_action != Action::MORE_THREADS && _decode_threads > 1)
+    {
+        // Loading with one thread less should still keep up with the user
+        double projected_load_time = load_time * _decode_threads / (_decode_threads - 1);
+        if (projected_load_time < (1 - IDLE_RATIO) * interval)
+            action = Action::FEWER_THREADS;
+    }
+    switch (action)
+    {
+        case Action::MORE_THREADS: _decode_threads++; break;
+        case Action::FEWER_THREADS: _decode_threads--; break;
+        case Action::DEEPER: _depth++; break;
+        case Action::NONE: break;
+    }
+    _last_action = action;
+    if (action != Action::NONE)
+        LOG("Prefetch tuner: user wait " + TOSTR(user_wait) + " us, pipeline wait " + TOSTR(pipeline_wait) + " us per batch, depth " +
+            TOSTR(_depth) + " decode threads " + TOSTR(_decode_threads))
+    return action != Action::NONE;
+}
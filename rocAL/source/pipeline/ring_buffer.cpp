@@ -22,13 +22,22 @@ THE SOFTWARE.
 
 #include <device_manager.h>
 #include "ring_buffer.h"
+#include "trace_recorder.h"
 
 RingBuffer::RingBuffer(unsigned buffer_depth):
         BUFF_DEPTH(buffer_depth),
+        _active_depth(buffer_depth),
         _dev_sub_buffer(buffer_depth),
         _host_master_buffers(buffer_depth),
         _dev_bbox_buffer(buffer_depth),
-        _dev_labels_buffer(buffer_depth)
+        _dev_labels_buffer(buffer_depth),
+        _host_bbox_buffer(buffer_depth),
+        _host_labels_buffer(buffer_depth),
+        _host_heatmap_buffer(buffer_depth),
+        _host_target_weight_buffer(buffer_depth),
+        _host_label_targets_buffer(buffer_depth),
+        _host_mix_params_buffer(buffer_depth),
+        _leases(buffer_depth, 0)
 {
     reset();
 }
@@ -39,6 +48,7 @@ void RingBuffer::block_if_empty()
     { // if the current read buffer is being written wait on it
         if(_dont_block)
             return;
+        TraceScope trace("Ring buffer empty");
         _wait_for_load.wait(lock);
     }
 }
@@ -51,9 +61,18 @@ void RingBuffer:: block_if_full()
     {
         if(_dont_block)
             return;
+        TraceScope trace("Ring buffer full");
         _wait_for_unload.wait(lock);
     }
+    wait_if_leased(lock, _write_ptr);
 }
+
+void RingBuffer::wait_if_leased(std::unique_lock<std::mutex> &lock, size_t slot)
+{
+    // A slot leased to the user is only written once the user releases it
+    _wait_for_unload.wait(lock, [this, slot] { return !_leases[slot] || _dont_block || _writer_released; });
+}
+
 std::vector<void*> RingBuffer::get_read_buffers()
 {
     block_if_empty();
@@ -74,9 +93,9 @@ void *RingBuffer::get_host_master_read_buffer() {
 std::pair<void*, void*> RingBuffer::get_box_encode_read_buffers()
 {
     block_if_empty();
-    if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
+    if(_mem_type == RocalMemType::HIP)
         return std::make_pair(_dev_bbox_buffer[_read_ptr], _dev_labels_buffer[_read_ptr]);
-    return std::make_pair(nullptr, nullptr);   // todo:: implement the same scheme for host as well
+    return std::make_pair(_host_bbox_buffer[_read_ptr], _host_labels_buffer[_read_ptr]);
 }
 
 std::vector<void*> RingBuffer::get_write_buffers()
@@ -91,13 +110,73 @@ std::vector<void*> RingBuffer::get_write_buffers()
 std::pair<void*, void*> RingBuffer::get_box_encode_write_buffers()
 {
     block_if_full();
-    if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
+    if(_mem_type == RocalMemType::HIP)
         return std::make_pair(_dev_bbox_buffer[_write_ptr], _dev_labels_buffer[_write_ptr]);
-    return std::make_pair(nullptr, nullptr); 
+    return std::make_pair(_host_bbox_buffer[_write_ptr], _host_labels_buffer[_write_ptr]);
 }
+size_t RingBuffer::reserve_write_slot()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    // Same as block_if_full() but the slots already reserved and not pushed yet are counted as well
+    // The predicate is checked again on every wake up, the lease and depth notifications do not mean a slot was freed
+    if(_level + _reserved >= _active_depth - 1 && !_dont_block && !_writer_released)
+    {
+        TraceScope trace("Ring buffer full");
+        _wait_for_unload.wait(lock, [this] { return _level + _reserved < _active_depth - 1 || _dont_block || _writer_released; });
+    }
+    auto slot = (_write_ptr + _reserved) % BUFF_DEPTH;
+    wait_if_leased(lock, slot);
+    _reserved++;
+    return slot;
+}
+
+std::vector<void*> RingBuffer::get_write_buffers(size_t slot)
+{
+    if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
+        return _dev_sub_buffer[slot];
+
+    return _host_sub_buffers[slot];
+}
+
+std::pair<void*, void*> RingBuffer::get_box_encode_write_buffers(size_t slot)
+{
+    if(_mem_type == RocalMemType::HIP)
+        return std::make_pair(_dev_bbox_buffer[slot], _dev_labels_buffer[slot]);
+    return std::make_pair(_host_bbox_buffer[slot], _host_labels_buffer[slot]);
+}
+
+std::pair<void*, void*> RingBuffer::get_heatmap_write_buffers(size_t slot)
+{
+    return std::make_pair(_host_heatmap_buffer[slot], _host_target_weight_buffer[slot]);
+}
+
+std::pair<void*, void*> RingBuffer::get_heatmap_read_buffers()
+{
+    block_if_empty();
+    return std::make_pair(_host_heatmap_buffer[_read_ptr], _host_target_weight_buffer[_read_ptr]);
+}
+
+std::pair<void*, void*> RingBuffer::get_label_encoder_write_buffers()
+{
+    block_if_full();
+    return std::make_pair(_host_label_targets_buffer[_write_ptr], _host_mix_params_buffer[_write_ptr]);
+}
+
+std::pair<void*, void*> RingBuffer::get_label_encoder_write_buffers(size_t slot)
+{
+    return std::make_pair(_host_label_targets_buffer[slot], _host_mix_params_buffer[slot]);
+}
+
+std::pair<void*, void*> RingBuffer::get_label_encoder_read_buffers()
+{
+    block_if_empty();
+    return std::make_pair(_host_label_targets_buffer[_read_ptr], _host_mix_params_buffer[_read_ptr]);
+}
+
 void RingBuffer::unblock_reader()
 {
     // Wake up the reader thread in case it's waiting for a load
+    TraceRecorder::instance()->instant("Ring buffer unblock reader");
     _wait_for_load.notify_all();
 }
 
@@ -115,6 +194,11 @@ void RingBuffer::release_if_empty()
 
 void RingBuffer::unblock_writer()
 {
+    TraceRecorder::instance()->instant("Ring buffer unblock writer");
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _writer_released = true;
+    }
     // Wake up the writer thread in case it's waiting for an unload
     _wait_for_unload.notify_all();
 }
@@ -230,35 +314,42 @@ void RingBuffer::initBoxEncoderMetaData(RocalMemType mem_type, size_t encoded_bb
             }
         }
     }
-#elif ENABLE_OPENCL
-    DeviceResources *dev_ocl = static_cast<DeviceResources *>(_dev);
-    if(mem_type== RocalMemType::OCL)
+#endif
+    // The host encoder writes to host buffers, OpenCL outputs are copied from them as well
+    if(_mem_type != RocalMemType::HIP)
     {
-        if(dev_ocl->cmd_queue == nullptr || dev_ocl->device_id == nullptr || dev_ocl->context == nullptr)
-            THROW("Error ocl structure needed since memory type is OCL");
-
-       cl_int err = CL_SUCCESS;
-       for(size_t buffIdx = 0; buffIdx < BUFF_DEPTH; buffIdx++)
+        for(size_t buffIdx = 0; buffIdx < BUFF_DEPTH; buffIdx++)
         {
-            _dev_bbox_buffer[buffIdx] =  clCreateBuffer(dev_ocl->context, CL_MEM_READ_WRITE, encoded_bbox_size, NULL, &err);
-            if(err)
-            {
-                _dev_bbox_buffer.clear();
-                THROW("clCreateBuffer of size " + TOSTR(encoded_bbox_size) +" failed " + TOSTR(err));
-            }
-            _dev_labels_buffer[buffIdx] =  clCreateBuffer(dev_ocl->context, CL_MEM_READ_WRITE, encoded_labels_size, NULL, &err);
-            if(err)
-            {
-                _dev_labels_buffer.clear();
-                THROW("clCreateBuffer of size " + TOSTR(encoded_labels_size) +" failed " + TOSTR(err));
-            }
+            _host_bbox_buffer[buffIdx] = aligned_alloc(MEM_ALIGNMENT, MEM_ALIGNMENT * (encoded_bbox_size / MEM_ALIGNMENT + 1));
+            _host_labels_buffer[buffIdx] = aligned_alloc(MEM_ALIGNMENT, MEM_ALIGNMENT * (encoded_labels_size / MEM_ALIGNMENT + 1));
+            if(!_host_bbox_buffer[buffIdx] || !_host_labels_buffer[buffIdx])
+                THROW("Allocating the host box encoder buffers of size " + TOSTR(encoded_bbox_size) + " failed")
         }
     }
-#else    
+}
+
+void RingBuffer::initHeatmapMetaData(size_t heatmaps_size, size_t target_weights_size)
+{
+    // Rendered on the host whatever the output memory type
+    for(size_t buffIdx = 0; buffIdx < BUFF_DEPTH; buffIdx++)
     {
-        //todo:: for host
+        _host_heatmap_buffer[buffIdx] = aligned_alloc(MEM_ALIGNMENT, MEM_ALIGNMENT * (heatmaps_size / MEM_ALIGNMENT + 1));
+        _host_target_weight_buffer[buffIdx] = aligned_alloc(MEM_ALIGNMENT, MEM_ALIGNMENT * (target_weights_size / MEM_ALIGNMENT + 1));
+        if(!_host_heatmap_buffer[buffIdx] || !_host_target_weight_buffer[buffIdx])
+            THROW("Allocating the host heatmap buffers of size " + TOSTR(heatmaps_size) + " failed")
+    }
+}
+
+void RingBuffer::initLabelEncoderMetaData(size_t targets_size, size_t mix_params_size)
+{
+    // Encoded on the host whatever the output memory type
+    for(size_t buffIdx = 0; buffIdx < BUFF_DEPTH; buffIdx++)
+    {
+        _host_label_targets_buffer[buffIdx] = aligned_alloc(MEM_ALIGNMENT, MEM_ALIGNMENT * (targets_size / MEM_ALIGNMENT + 1));
+        _host_mix_params_buffer[buffIdx] = aligned_alloc(MEM_ALIGNMENT, MEM_ALIGNMENT * (mix_params_size / MEM_ALIGNMENT + 1));
+        if(!_host_label_targets_buffer[buffIdx] || !_host_mix_params_buffer[buffIdx])
+            THROW("Allocating the host label encoder buffers of size " + TOSTR(targets_size) + " failed")
     }
-#endif
 }
 
 void RingBuffer::push()
@@ -266,9 +357,25 @@ void RingBuffer::push()
     // pushing and popping to and from image and metadata buffer should be atomic so that their level stays the same at all times
     std::unique_lock<std::mutex> lock(_names_buff_lock);
     _meta_ring_buffer.push(_last_image_meta_data);
+    _roi_ring_buffer.push(OutputRoiBatch());
     increment_write_ptr();
 }
 
+void RingBuffer::push_reserved(ImageNameBatch names, pMetaDataBatch meta_data, OutputRoiBatch output_roi)
+{
+    std::unique_lock<std::mutex> names_lock(_names_buff_lock);
+    _meta_ring_buffer.push(std::make_pair(std::move(names), meta_data));
+    _roi_ring_buffer.push(std::move(output_roi));
+    std::unique_lock<std::mutex> lock(_lock);
+    // The write pointer moves and the reservation is released at once so a concurrent reserve_write_slot() never returns a slot in use
+    _write_ptr = (_write_ptr+1)%BUFF_DEPTH;
+    _level++;
+    if(_reserved > 0)
+        _reserved--;
+    lock.unlock();
+    _wait_for_load.notify_all();
+}
+
 void RingBuffer::pop()
 {
     if(empty())
@@ -277,6 +384,7 @@ void RingBuffer::pop()
     std::unique_lock<std::mutex> lock(_names_buff_lock);
     increment_read_ptr();
     _meta_ring_buffer.pop();
+    _roi_ring_buffer.pop();
 }
 
 void RingBuffer::reset()
@@ -284,9 +392,13 @@ void RingBuffer::reset()
     _write_ptr = 0;
     _read_ptr = 0;
     _level = 0;
+    _reserved = 0;
     _dont_block = false;
+    _writer_released = false;
     while(!_meta_ring_buffer.empty())
         _meta_ring_buffer.pop();
+    while(!_roi_ring_buffer.empty())
+        _roi_ring_buffer.pop();
 }
 
 void RingBuffer::release_gpu_res()
@@ -327,6 +439,15 @@ RingBuffer::~RingBuffer()
         _host_master_buffers.clear();
         _host_sub_buffers.clear();
     }
+    for (unsigned idx = 0; idx < _host_bbox_buffer.size(); idx++)
+    {
+        free(_host_bbox_buffer[idx]);
+        free(_host_labels_buffer[idx]);
+        free(_host_heatmap_buffer[idx]);
+        free(_host_target_weight_buffer[idx]);
+        free(_host_label_targets_buffer[idx]);
+        free(_host_mix_params_buffer[idx]);
+    }
 }
 
 bool RingBuffer::empty()
@@ -336,7 +457,33 @@ bool RingBuffer::empty()
 
 bool RingBuffer::full()
 {
-    return (_level >= BUFF_DEPTH - 1);
+    return (_level >= _active_depth - 1);
+}
+
+void RingBuffer::set_capacity(unsigned buffer_depth)
+{
+    BUFF_DEPTH = buffer_depth;
+    _dev_sub_buffer.resize(buffer_depth);
+    _host_master_buffers.resize(buffer_depth);
+    _dev_bbox_buffer.resize(buffer_depth);
+    _dev_labels_buffer.resize(buffer_depth);
+    _host_bbox_buffer.resize(buffer_depth);
+    _host_labels_buffer.resize(buffer_depth);
+    _host_heatmap_buffer.resize(buffer_depth);
+    _host_target_weight_buffer.resize(buffer_depth);
+    _host_label_targets_buffer.resize(buffer_depth);
+    _host_mix_params_buffer.resize(buffer_depth);
+    _leases.resize(buffer_depth, 0);
+}
+
+void RingBuffer::set_active_depth(unsigned buffer_depth)
+{
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _active_depth = std::min(std::max(buffer_depth, 2u), BUFF_DEPTH);
+    }
+    // A writer waiting on a full buffer may have room now
+    _wait_for_unload.notify_all();
 }
 
 size_t RingBuffer::level()
@@ -378,3 +525,38 @@ MetaDataNamePair& RingBuffer::get_meta_data()
     return  _meta_ring_buffer.front();
 }
 
+const OutputRoiBatch& RingBuffer::get_output_roi()
+{
+    block_if_empty();
+    std::unique_lock<std::mutex> lock(_names_buff_lock);
+    if(_level != _roi_ring_buffer.size())
+        THROW("ring buffer internals error, image and roi sizes not the same "+TOSTR(_level) + " != "+TOSTR(_roi_ring_buffer.size()))
+    return _roi_ring_buffer.front();
+}
+
+size_t RingBuffer::lease_read_slot()
+{
+    block_if_empty();
+    std::unique_lock<std::mutex> lock(_lock);
+    _leases[_read_ptr]++;
+    return _read_ptr;
+}
+
+void RingBuffer::release_lease(size_t slot)
+{
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        if(slot >= BUFF_DEPTH || !_leases[slot])
+            THROW("Releasing a ring buffer slot that is not leased " + TOSTR(slot))
+        _leases[slot]--;
+    }
+    // Wake up the writer thread in case it's waiting for this slot
+    _wait_for_unload.notify_all();
+}
+
+void* RingBuffer::get_host_master_buffer(size_t slot)
+{
+    if((_mem_type == RocalMemType::OCL) || (_mem_type == RocalMemType::HIP))
+        return nullptr;
+    return _host_master_buffers[slot];
+}
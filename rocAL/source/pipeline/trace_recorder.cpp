@@ -0,0 +1,216 @@
+/*
+Copyright (c) 2019 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "trace_recorder.h"
+#include "commons.h"
+
+thread_local TraceRecorder::ThreadBufferOwner TraceRecorder::_thread_buffer;
+thread_local int64_t TraceRecorder::_thread_batch = -1;
+
+namespace
+{
+int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::string json_escape(const char *str)
+{
+    std::string escaped;
+    for (; *str; str++)
+    {
+        if (*str == '"' || *str == '\\')
+            escaped += '\\';
+        escaped += *str;
+    }
+    return escaped;
+}
+}
+
+TraceRecorder* TraceRecorder::instance()
+{
+    // Never destroyed, the events of the threads still running at exit are recorded into it
+    static TraceRecorder* recorder = new TraceRecorder();
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder()
+{
+    _start_ns = now_ns();
+    // Tracing can be turned on for an existing application without changing it
+    const char *trace_file = std::getenv("ROCAL_TRACE_FILE");
+    if (trace_file && *trace_file)
+        enable(trace_file);
+}
+
+TraceRecorder::ThreadBuffer::~ThreadBuffer()
+{
+    for (auto &chunk : chunks)
+        delete[] chunk.load();
+}
+
+TraceRecorder::ThreadBufferOwner::~ThreadBufferOwner()
+{
+    if (buffer)
+        buffer->exited.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::enable(const std::string &trace_file)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _trace_file = trace_file;
+    _enabled.store(!trace_file.empty(), std::memory_order_relaxed);
+    if (!trace_file.empty())
+    {
+        INFO("Recording the pipeline trace to " + trace_file)
+    }
+}
+
+const char* TraceRecorder::intern(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _names.insert(name).first->c_str();
+}
+
+void TraceRecorder::set_thread_batch(int64_t batch)
+{
+    _thread_batch = batch;
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::thread_buffer()
+{
+    if (!_thread_buffer.buffer)
+    {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->tid = syscall(SYS_gettid);
+        std::lock_guard<std::mutex> lock(_lock);
+        // Buffers of the exited threads which have no events to write are freed right away
+        _buffers.erase(std::remove_if(_buffers.begin(), _buffers.end(), [](const std::shared_ptr<ThreadBuffer> &b)
+                       { return b->exited.load(std::memory_order_acquire) && b->count.load(std::memory_order_acquire) == 0; }),
+                       _buffers.end());
+        _buffers.push_back(buffer);
+        _thread_buffer.buffer = buffer.get();
+    }
+    return _thread_buffer.buffer;
+}
+
+void TraceRecorder::set_thread_name(const std::string &name)
+{
+    auto buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock(_lock);
+    buffer->thread_name = name;
+}
+
+void TraceRecorder::record(const char *name, char phase, int64_t batch, int64_t sample)
+{
+    auto buffer = thread_buffer();
+    // Only the owner thread writes to the buffer, the events are published to dump() by the count
+    size_t idx = buffer->count.load(std::memory_order_relaxed);
+    size_t chunk = idx / ThreadBuffer::CHUNK_SIZE;
+    if (chunk >= ThreadBuffer::MAX_CHUNKS)
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Event *events = buffer->chunks[chunk].load(std::memory_order_relaxed);
+    if (!events)
+    {
+        events = new Event[ThreadBuffer::CHUNK_SIZE];
+        buffer->chunks[chunk].store(events, std::memory_order_release);
+    }
+    events[idx % ThreadBuffer::CHUNK_SIZE] = {name, now_ns() - _start_ns, (batch < 0) ? _thread_batch : batch, sample, phase};
+    buffer->count.store(idx + 1, std::memory_order_release);
+}
+
+void TraceRecorder::dump(const std::string &trace_file)
+{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<std::string> thread_names;
+    std::vector<unsigned char> exited; //!< Buffers whose thread ended before the events were read, they get no more events
+    std::string file_name;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        file_name = trace_file.empty() ? _trace_file : trace_file;
+        buffers = _buffers;
+        for (auto &buffer : buffers)
+        {
+            thread_names.push_back(buffer->thread_name);
+            exited.push_back(buffer->exited.load(std::memory_order_acquire));
+        }
+    }
+    if (file_name.empty())
+        THROW("No file given to write the trace to")
+    std::ofstream out(file_name);
+    if (!out)
+        THROW("Could not open the trace file " + file_name)
+
+    const auto pid = getpid();
+    bool first = true;
+    auto separator = [&]() -> std::ofstream& { out << (first ? "\n" : ",\n"); first = false; return out; };
+    out << "{\"traceEvents\":[";
+    for (size_t b = 0; b < buffers.size(); b++)
+    {
+        auto &buffer = buffers[b];
+        if (!thread_names[b].empty())
+            separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+                        << ",\"args\":{\"name\":\"" << json_escape(thread_names[b].c_str()) << "\"}}";
+        size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++)
+        {
+            const Event &e = buffer->chunks[i / ThreadBuffer::CHUNK_SIZE].load(std::memory_order_acquire)[i % ThreadBuffer::CHUNK_SIZE];
+            auto &event_out = separator();
+            event_out << "{\"name\":\"" << json_escape(e.name) << "\",\"ph\":\"" << e.phase << "\",\"ts\":" << e.ts_ns / 1000 << "."
+                      << std::to_string(1000 + e.ts_ns % 1000).substr(1) << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid;
+            if (e.phase == 'i')
+                event_out << ",\"s\":\"t\"";
+            if (e.batch >= 0 || e.sample >= 0)
+            {
+                event_out << ",\"args\":{";
+                if (e.batch >= 0)
+                    event_out << "\"batch\":" << e.batch << ((e.sample >= 0) ? "," : "");
+                if (e.sample >= 0)
+                    event_out << "\"sample\":" << e.sample;
+                event_out << "}";
+            }
+            event_out << "}";
+        }
+        size_t dropped = buffer->dropped.load();
+        if (dropped > 0)
+        {
+            WRN("Trace buffer of thread " + TOSTR(buffer->tid) + " is full, " + TOSTR(dropped) + " events were dropped")
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    INFO("Pipeline trace written to " + file_name)
+
+    // All the events of the exited threads are written now, their buffers are freed
+    std::lock_guard<std::mutex> lock(_lock);
+    for (size_t b = 0; b < buffers.size(); b++)
+        if (exited[b])
+            _buffers.erase(std::remove(_buffers.begin(), _buffers.end(), buffers[b]), _buffers.end());
+}
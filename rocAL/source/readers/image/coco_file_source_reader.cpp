@@ -101,6 +101,7 @@ size_t COCOFileSourceReader::open()
     auto file_path = _file_names[_curr_file_idx]; // Get next file name
     incremenet_read_ptr();
     _last_id = file_path;
+    _last_file_path = file_path;
     auto last_slash_idx = _last_id.find_last_of("\\/");
     if (std::string::npos != last_slash_idx)
     {
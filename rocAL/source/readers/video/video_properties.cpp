@@ -22,9 +22,17 @@ THE SOFTWARE.
 
 #include "video_properties.h"
 #include <cmath>
-#include <cassert>
 #include <algorithm>
+#include <map>
+#include <set>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "filesystem.h"
+#include "video_keyframe_index.h"
 
 #ifdef ROCAL_VIDEO
 void substring_extraction(std::string const &str, const char delim, std::vector<std::string> &out)
@@ -38,7 +46,7 @@ void substring_extraction(std::string const &str, const char delim, std::vector<
     }
 }
 
-// Opens the context of the Video file to obtain the width, heigh and frame rate info.
+// Opens the context of the Video file to obtain the width, heigh, frame rate and key frames info.
 void open_video_context(const char *video_file_path, Properties &props)
 {
     AVFormatContext *pFormatCtx = NULL;
@@ -49,14 +57,15 @@ void open_video_context(const char *video_file_path, Properties &props)
     // open video file
     int ret = avformat_open_input(&pFormatCtx, video_file_path, NULL, NULL);
     if (ret != 0)
-    {
-        WRN("Unable to open video file: " + STR(video_file_path))
-        exit(0);
-    }
+        THROW("Unable to open video file: " + STR(video_file_path))
 
     // Retrieve stream information
     ret = avformat_find_stream_info(pFormatCtx, NULL);
-    assert(ret >= 0);
+    if (ret < 0)
+    {
+        avformat_close_input(&pFormatCtx);
+        THROW("Unable to find the stream information of the video file: " + STR(video_file_path))
+    }
     for (i = 0; i < pFormatCtx->nb_streams; i++)
     {
         if (pFormatCtx->streams[i]->codec->codec_type == AVMEDIA_TYPE_VIDEO && videoStream < 0)
@@ -64,20 +73,242 @@ void open_video_context(const char *video_file_path, Properties &props)
             videoStream = i;
         }
     }
-    assert(videoStream != -1);
+    if (videoStream == -1)
+    {
+        avformat_close_input(&pFormatCtx);
+        THROW("No video stream found in the video file: " + STR(video_file_path))
+    }
 
     // Get a pointer to the codec context for the video stream
-    pCodecCtx = pFormatCtx->streams[videoStream]->codec;
-    assert(pCodecCtx != NULL);
+    AVStream *stream = pFormatCtx->streams[videoStream];
+    pCodecCtx = stream->codec;
+    if (pCodecCtx == NULL)
+    {
+        avformat_close_input(&pFormatCtx);
+        THROW("No codec context for the video stream of the video file: " + STR(video_file_path))
+    }
     props.width = pCodecCtx->width;
     props.height = pCodecCtx->height;
-    props.frames_count = pFormatCtx->streams[videoStream]->nb_frames;
-    props.avg_frame_rate_num = pFormatCtx->streams[videoStream]->avg_frame_rate.num;
-    props.avg_frame_rate_den = pFormatCtx->streams[videoStream]->avg_frame_rate.den;
+    props.frames_count = stream->nb_frames;
+    props.avg_frame_rate_num = stream->avg_frame_rate.num;
+    props.avg_frame_rate_den = stream->avg_frame_rate.den;
+    // The key frames are in the index the demuxer read from the container, such as the sync samples of mp4
+    props.keyframes.clear();
+    int64_t start_time = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    double frames_per_tick = av_q2d(stream->time_base) * av_q2d(stream->avg_frame_rate);
+    for (int entry = 0; entry < stream->nb_index_entries; entry++)
+        if (stream->index_entries[entry].flags & AVINDEX_KEYFRAME)
+            props.keyframes.push_back(static_cast<unsigned>(std::llround((stream->index_entries[entry].timestamp - start_time) * frames_per_tick)));
     avcodec_close(pCodecCtx);
     avformat_close_input(&pFormatCtx);
 }
 
+namespace
+{
+struct ProbedVideo
+{
+    int64_t size = -1, mtime = -1;
+    Properties props;
+};
+
+/// Properties of the videos probed by the process, shared by the loaders and the label readers
+struct VideoPropertiesCache
+{
+    std::mutex lock;
+    std::map<std::string, ProbedVideo> videos;
+    std::set<std::string> loaded_manifests;
+};
+
+VideoPropertiesCache &video_properties_cache()
+{
+    static VideoPropertiesCache cache;
+    return cache;
+}
+
+bool file_stamp(const std::string &path, int64_t &size, int64_t &mtime)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        return false;
+    size = st.st_size;
+    mtime = st.st_mtime;
+    return true;
+}
+
+bool is_up_to_date(const ProbedVideo &video, const std::string &path)
+{
+    int64_t size, mtime;
+    return file_stamp(path, size, mtime) && size == video.size && mtime == video.mtime;
+}
+
+const char *MANIFEST_HEADER = "rocal_video_manifest 1";
+
+// One video per line: path, then size, modification time, width, height, frame count, frame rate, key frame count and key frames
+void load_manifest(const std::string &manifest_path, std::map<std::string, ProbedVideo> &videos)
+{
+    std::ifstream manifest(manifest_path);
+    std::string line;
+    if (!manifest.good() || !std::getline(manifest, line) || line != MANIFEST_HEADER)
+        return;
+    while (std::getline(manifest, line))
+    {
+        std::istringstream line_ss(line);
+        std::string path;
+        ProbedVideo video;
+        size_t keyframe_count = 0;
+        if (!std::getline(line_ss, path, '\t'))
+            continue;
+        Properties &props = video.props;
+        if (!(line_ss >> video.size >> video.mtime >> props.width >> props.height >> props.frames_count >> props.avg_frame_rate_num >> props.avg_frame_rate_den >> keyframe_count))
+            continue;
+        props.keyframes.resize(keyframe_count);
+        for (auto &keyframe : props.keyframes)
+            line_ss >> keyframe;
+        if (line_ss)
+            videos[path] = std::move(video);
+    }
+}
+
+void save_manifest(const std::string &manifest_path, const std::vector<std::string> &video_file_paths, const std::map<std::string, ProbedVideo> &videos)
+{
+    // The videos of the list are merged into the ones already in the manifest, which another list sharing it may have written
+    std::map<std::string, ProbedVideo> merged;
+    load_manifest(manifest_path, merged);
+    for (auto &path : video_file_paths)
+    {
+        auto it = videos.find(path);
+        if (it != videos.end())
+            merged[path] = it->second;
+    }
+    // Written aside then renamed, so the ranks starting together never read a partial manifest
+    std::string temp_path = manifest_path + ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream manifest(temp_path);
+        manifest << MANIFEST_HEADER << "\n";
+        for (auto &video : merged)
+        {
+            const Properties &props = video.second.props;
+            manifest << video.first << "\t" << video.second.size << " " << video.second.mtime << " " << props.width << " " << props.height << " " << props.frames_count
+                     << " " << props.avg_frame_rate_num << " " << props.avg_frame_rate_den << " " << props.keyframes.size();
+            for (auto keyframe : props.keyframes)
+                manifest << " " << keyframe;
+            manifest << "\n";
+        }
+        if (!manifest.good())
+        {
+            manifest.close();
+            std::remove(temp_path.c_str());
+            WRN("Could not write the video manifest " + manifest_path)
+            return;
+        }
+    }
+    if (std::rename(temp_path.c_str(), manifest_path.c_str()) != 0)
+    {
+        std::remove(temp_path.c_str());
+        WRN("Could not write the video manifest " + manifest_path)
+    }
+}
+}
+
+std::string video_manifest_path(const char *source_path)
+{
+    if (const char *manifest_path = std::getenv("ROCAL_VIDEO_MANIFEST"))
+        return manifest_path;
+    // Next to the directory or file rather than in it, where it would be listed as a video
+    std::string path = source_path;
+    while (path.size() > 1 && path.back() == '/')
+        path.pop_back();
+    return path + ".rocal_video_manifest";
+}
+
+void prefetch_video_properties(const std::vector<std::string> &video_file_paths, const char *source_path)
+{
+    auto &cache = video_properties_cache();
+    std::string manifest_path = video_manifest_path(source_path);
+    std::vector<std::string> missing;
+    {
+        std::unique_lock<std::mutex> lock(cache.lock);
+        if (!manifest_path.empty() && cache.loaded_manifests.insert(manifest_path).second)
+            load_manifest(manifest_path, cache.videos);
+        std::set<std::string> listed;
+        for (auto &path : video_file_paths)
+        {
+            auto it = cache.videos.find(path);
+            if ((it == cache.videos.end() || !is_up_to_date(it->second, path)) && listed.insert(path).second)
+                missing.push_back(path);
+        }
+    }
+    if (missing.empty())
+        return;
+
+    // Opening a video is mostly waiting for the storage, the videos are probed by several threads
+    std::vector<ProbedVideo> probed(missing.size());
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex error_lock;
+    auto probe = [&]()
+    {
+        for (size_t i = next++; i < missing.size(); i = next++)
+        {
+            try
+            {
+                if (!file_stamp(missing[i], probed[i].size, probed[i].mtime))
+                    THROW("Unable to open video file: " + missing[i])
+                open_video_context(missing[i].c_str(), probed[i].props);
+            }
+            catch (...)
+            {
+                std::unique_lock<std::mutex> lock(error_lock);
+                if (!error)
+                    error = std::current_exception();
+                next = missing.size();
+            }
+        }
+    };
+    size_t thread_count = std::min<size_t>(missing.size(), std::max(4u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < thread_count; t++)
+        threads.emplace_back(probe);
+    probe();
+    for (auto &thread : threads)
+        thread.join();
+    if (error)
+        std::rethrow_exception(error);
+
+    std::unique_lock<std::mutex> lock(cache.lock);
+    for (size_t i = 0; i < missing.size(); i++)
+        cache.videos[missing[i]] = std::move(probed[i]);
+    if (!manifest_path.empty())
+        save_manifest(manifest_path, video_file_paths, cache.videos);
+}
+
+void get_video_properties(const std::string &video_file_path, Properties &props)
+{
+    auto &cache = video_properties_cache();
+    bool probed = false;
+    {
+        std::unique_lock<std::mutex> lock(cache.lock);
+        auto it = cache.videos.find(video_file_path);
+        if (it != cache.videos.end() && is_up_to_date(it->second, video_file_path))
+        {
+            props = it->second.props;
+            probed = true;
+        }
+    }
+    if (!probed)
+    {
+        ProbedVideo video;
+        file_stamp(video_file_path, video.size, video.mtime);
+        open_video_context(video_file_path.c_str(), video.props);
+        props = video.props;
+        std::unique_lock<std::mutex> lock(cache.lock);
+        cache.videos[video_file_path] = std::move(video);
+    }
+    // The decoders opening the video later take its key frames from here instead of building their own index
+    if (!props.keyframes.empty())
+        VideoKeyframeIndex::instance()->set(video_file_path, props.keyframes);
+}
+
 void get_video_properties_from_txt_file(VideoProperties &video_props, const char *file_path, bool file_list_frame_num)
 {
     std::ifstream text_file(file_path);
@@ -89,7 +320,18 @@ void get_video_properties_from_txt_file(VideoProperties &video_props, const char
         unsigned max_width = 0;
         unsigned max_height = 0;
         unsigned video_count = 0;
+        std::vector<std::string> lines, video_file_names;
         while (std::getline(text_file, line))
+        {
+            std::string video_file_name;
+            std::istringstream line_ss(line);
+            if (!(line_ss >> video_file_name))
+                continue;
+            lines.push_back(line);
+            video_file_names.push_back(video_file_name);
+        }
+        prefetch_video_properties(video_file_names, file_path);
+        for (auto &video_line : lines)
         {
             int label;
             std::string video_file_name;
@@ -97,10 +339,10 @@ void get_video_properties_from_txt_file(VideoProperties &video_props, const char
             unsigned end_frame_number = 0;
             float start_time = 0.0;
             float end_time = 0.0;
-            std::istringstream line_ss(line);
+            std::istringstream line_ss(video_line);
             if (!(line_ss >> video_file_name >> label))
                 continue;
-            open_video_context(video_file_name.c_str(), props);
+            get_video_properties(video_file_name, props);
             if(max_width == props.width || max_width == 0)
                 max_width = props.width;
             else
@@ -164,7 +406,8 @@ void find_video_properties(VideoProperties &video_props, const char *source_path
         else
         {
             // Single Video File Input
-            open_video_context(source_path, props);
+            prefetch_video_properties({_full_path}, source_path);
+            get_video_properties(_full_path, props);
             video_props.width = props.width;
             video_props.height = props.height;
             video_props.videos_count = 1;
@@ -180,8 +423,7 @@ void find_video_properties(VideoProperties &video_props, const char *source_path
     }
     else if (filesys::exists(pathObj) && filesys::is_directory(pathObj))
     {
-        std::vector<std::string> video_files;
-        unsigned video_count = 0;
+        std::vector<std::string> video_file_paths;
         std::vector<std::string> entry_name_list;
         std::string _folder_path = source_path;
         if ((_sub_dir = opendir(_folder_path.c_str())) == nullptr)
@@ -196,35 +438,19 @@ void find_video_properties(VideoProperties &video_props, const char *source_path
         closedir(_sub_dir);
         std::sort(entry_name_list.begin(), entry_name_list.end());
 
+        // The videos of the directory and of its sub directories, listed first so they can be probed together
         for (unsigned dir_count = 0; dir_count < entry_name_list.size(); ++dir_count)
         {
             std::string subfolder_path = _folder_path + "/" + entry_name_list[dir_count];
             filesys::path pathObj(subfolder_path);
             if (filesys::exists(pathObj) && filesys::is_regular_file(pathObj))
             {
-                open_video_context(subfolder_path.c_str(), props);
-                if(max_width == props.width || max_width == 0)
-                    max_width = props.width;
-                else
-                    THROW("The given video files are of different resolution\n")
-                if(max_height == props.height || max_height == 0)
-                    max_height = props.height;
-                else
-                    THROW("The given video files are of different resolution\n")
-                video_props.frames_count.push_back(props.frames_count);
-                float video_frame_rate = std::floor(props.avg_frame_rate_num / props.avg_frame_rate_den);
-                if (video_props.frame_rate != 0 && video_frame_rate != video_props.frame_rate)
-                    THROW("Variable frame rate videos cannot be processed")
-                video_props.frame_rate = video_frame_rate;
-                video_file_path = std::to_string(video_count) + "#" + subfolder_path; // Video index is added to each video file name to identify repeated videos files.
-                video_props.video_file_names.push_back(video_file_path);
-                video_props.start_end_frame_num.push_back(std::make_tuple(0, (int)props.frames_count));
-                video_count++;
+                video_file_paths.push_back(subfolder_path);
             }
             else if (filesys::exists(pathObj) && filesys::is_directory(pathObj))
             {
-                std::string _full_path = subfolder_path;
-                if ((_sub_dir = opendir(_full_path.c_str())) == nullptr)
+                std::vector<std::string> video_files;
+                if ((_sub_dir = opendir(subfolder_path.c_str())) == nullptr)
                     THROW("VideoReader ERROR: Failed opening the directory at " + source_path);
                 while ((_entity = readdir(_sub_dir)) != nullptr)
                 {
@@ -235,36 +461,34 @@ void find_video_properties(VideoProperties &video_props, const char *source_path
                 }
                 closedir(_sub_dir);
                 std::sort(video_files.begin(), video_files.end());
-                for (unsigned i = 0; i < video_files.size(); i++)
-                {
-                    std::string file_path = _full_path;
-                    file_path.append("/");
-                    file_path.append(video_files[i]);
-                    _full_path = file_path;
-
-                    open_video_context(_full_path.c_str(), props);
-                    if(max_width == props.width || max_width == 0)
-                        max_width = props.width;
-                    else
-                        THROW("The given video files are of different resolution\n")
-                    if(max_height == props.height || max_height == 0)
-                        max_height = props.height;
-                    else
-                        THROW("The given video files are of different resolution\n")
-                    video_file_path = std::to_string(video_count) + "#" + _full_path; // Video index is added to each video file name to identify repeated videos files.
-                    video_props.video_file_names.push_back(video_file_path);
-                    video_props.frames_count.push_back(props.frames_count);
-                    float video_frame_rate = std::floor(props.avg_frame_rate_num / props.avg_frame_rate_den);
-                    if (video_props.frame_rate != 0 && video_frame_rate != video_props.frame_rate)
-                        THROW("Variable frame rate videos cannot be processed")
-                    video_props.frame_rate = video_frame_rate;
-                    video_props.start_end_frame_num.push_back(std::make_tuple(0, (int)props.frames_count));
-                    video_count++;
-                    _full_path = subfolder_path;
-                }
-                video_files.clear();
+                for (auto &video_file : video_files)
+                    video_file_paths.push_back(subfolder_path + "/" + video_file);
             }
         }
+        prefetch_video_properties(video_file_paths, source_path);
+
+        unsigned video_count = 0;
+        for (auto &path : video_file_paths)
+        {
+            get_video_properties(path, props);
+            if(max_width == props.width || max_width == 0)
+                max_width = props.width;
+            else
+                THROW("The given video files are of different resolution\n")
+            if(max_height == props.height || max_height == 0)
+                max_height = props.height;
+            else
+                THROW("The given video files are of different resolution\n")
+            video_props.frames_count.push_back(props.frames_count);
+            float video_frame_rate = std::floor(props.avg_frame_rate_num / props.avg_frame_rate_den);
+            if (video_props.frame_rate != 0 && video_frame_rate != video_props.frame_rate)
+                THROW("Variable frame rate videos cannot be processed")
+            video_props.frame_rate = video_frame_rate;
+            video_file_path = std::to_string(video_count) + "#" + path; // Video index is added to each video file name to identify repeated videos files.
+            video_props.video_file_names.push_back(video_file_path);
+            video_props.start_end_frame_num.push_back(std::make_tuple(0, (int)props.frames_count));
+            video_count++;
+        }
         video_props.videos_count = video_count;
         video_props.width = max_width;
         video_props.height = max_height;
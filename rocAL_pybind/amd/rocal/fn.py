@@ -544,9 +544,17 @@ def bb_flip(*inputs, bytes_per_sample_hint = 0, horizontal = 1, ltrb = False, pr
     return []
 
 def one_hot(*inputs, bytes_per_sample_hint=0, dtype=types.FLOAT, num_classes=0, off_value=0.0,
-            on_value=1.0, preserve=False, seed=-1,  device=None):
+            on_value=1.0, preserve=False, seed=-1, label_smoothing=0.0, mixup_alpha=0.0, cutmix_alpha=0.0,
+            mix_probability=1.0, device=None):
+    # The targets are encoded, smoothed and mixed in the pipeline, mixup and cutmix mix the output images as well
+    smoothing = label_smoothing * (on_value - off_value) / num_classes if num_classes else 0.0
+    kwargs_pybind = {"num_classes":num_classes, "on_value":on_value - smoothing * (num_classes - 1),
+                     "off_value":off_value + smoothing, "mixup_alpha":mixup_alpha, "cutmix_alpha":cutmix_alpha,
+                     "mix_probability":mix_probability}
+    b.LabelEncoder(Pipeline._current_pipeline._handle, *(kwargs_pybind.values()))
     Pipeline._current_pipeline._numOfClasses = num_classes
     Pipeline._current_pipeline._oneHotEncoding = True
+    Pipeline._current_pipeline._softLabels = label_smoothing > 0 or mixup_alpha > 0 or cutmix_alpha > 0
     return ([])
 
 def box_encoder(*inputs, anchors, bytes_per_sample_hint=0, criteria=0.5, means=None, offset=False, preserve=False, scale=1.0, seed=-1, stds=None ,device = None):
@@ -557,6 +565,13 @@ def box_encoder(*inputs, anchors, bytes_per_sample_hint=0, criteria=0.5, means=N
     Pipeline._current_pipeline._BoxEncoder = True
     return (box_encoder , [])
 
+def heatmap_targets(*inputs, heatmap_size, sigma=0.0, device=None):
+    # heatmap_size is [width, height], sigma 0 keeps the one given to the keypoints reader
+    kwargs_pybind = {"heatmap_width":heatmap_size[0], "heatmap_height":heatmap_size[1], "sigma":sigma}
+    b.HeatmapTargets(Pipeline._current_pipeline._handle, *(kwargs_pybind.values()))
+    Pipeline._current_pipeline._heatmap_size = list(heatmap_size)
+    return []
+
 def color_temp(*inputs, adjustment_value=50, device=None, preserve = False):
     # pybind call arguments
     adjustment_value = b.CreateIntParameter(adjustment_value) if isinstance(adjustment_value, int) else adjustment_value
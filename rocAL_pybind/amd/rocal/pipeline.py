@@ -85,6 +85,9 @@ class Pipeline(object):
         unrestricted number of streams is assumed).
     `default_cuda_stream_priority` : int, optional, default = 0
         CUDA stream priority used by ROCAL. See `cudaStreamCreateWithPriority` in CUDA documentation
+    `cpu_placement` : types.CPU_PLACEMENT_NONE or types.CPU_PLACEMENT_NUMA, optional, default = types.CPU_PLACEMENT_NONE
+        With CPU_PLACEMENT_NUMA each internal shard's loader and decode threads and buffers are pinned to a NUMA node,
+        shards are spread round robin over the nodes and the processing threads run on the nodes of the shards.
     """
     '''.
     Args: batch_size
@@ -98,13 +101,13 @@ class Pipeline(object):
     def __init__(self, batch_size=-1, num_threads=0, device_id=-1, seed=1,
                  exec_pipelined=True, prefetch_queue_depth=2,
                  exec_async=True, bytes_per_sample=0,
-                 rocal_cpu=False, max_streams=-1, default_cuda_stream_priority=0, tensor_layout = types.NCHW, reverse_channels = False, mean = None, std = None, tensor_dtype=types.FLOAT, output_memory_type = types.CPU_MEMORY):
+                 rocal_cpu=False, max_streams=-1, default_cuda_stream_priority=0, tensor_layout = types.NCHW, reverse_channels = False, mean = None, std = None, tensor_dtype=types.FLOAT, output_memory_type = types.CPU_MEMORY, cpu_placement = types.CPU_PLACEMENT_NONE):
         if(rocal_cpu):
             self._handle = b.rocalCreate(
-                batch_size, types.CPU, device_id, num_threads,prefetch_queue_depth,types.FLOAT)
+                batch_size, types.CPU, device_id, num_threads,prefetch_queue_depth,types.FLOAT, cpu_placement)
         else:
             self._handle = b.rocalCreate(
-                batch_size, types.GPU, device_id, num_threads,prefetch_queue_depth,types.FLOAT)
+                batch_size, types.GPU, device_id, num_threads,prefetch_queue_depth,types.FLOAT, cpu_placement)
 
         if(b.getStatus(self._handle) == types.OK):
             print("Pipeline has been created succesfully")
@@ -139,8 +142,10 @@ class Pipeline(object):
         self._anchors = None
         self._BoxEncoder = None
         self._encode_tensor = None
+        self._heatmap_size = None
         self._numOfClasses = None
         self._oneHotEncoding = False
+        self._softLabels = False
         self._castLabels = False
         self._current_pipeline = None
         self._reader = None
@@ -179,6 +184,17 @@ class Pipeline(object):
         b.rocalCopyToOutput(
             self._handle, np.ascontiguousarray(out, dtype=array.dtype))
 
+    def copyImageRagged(self):
+        """Returns the output images of the batch as a list of HWC numpy views, one per sample, without the padding to the max output size"""
+        return b.rocalCopyToOutputRagged(self._handle, self._batch_size)
+
+    def leaseOutput(self, shape):
+        """Returns the output images of the batch as a uint8 numpy array viewing the internal buffer, without copying.
+        The buffer is handed back to the pipeline when the array and every array or tensor created from it
+        (torch.from_numpy, or DLPack through numpy's __dlpack__) are dropped. Only supported on CPU.
+        The arrays must not be read once the pipeline is released, dropping them afterwards is safe."""
+        return b.rocalLeaseOutput(self._handle, list(shape))
+
     def copyToExternalTensor(self, array,  multiplier, offset, reverse_channels, tensor_format, tensor_dtype):
 
         b.rocalToTensor(self._handle, ctypes.c_void_p(array.data_ptr()), tensor_format, tensor_dtype,
@@ -217,16 +233,22 @@ class Pipeline(object):
                 b.rocalCupyToTensor16(self._handle, ctypes.c_void_p(array.ctypes.data), types.NCHW,
                                         multiplier[0], multiplier[1], multiplier[2], offset[0], offset[1], offset[2], (1 if reverse_channels else 0), self._output_memory_type)
     def GetOneHotEncodedLabels(self, array, device):
+        # Copies the float32 targets encoded by fn.one_hot in the pipeline
         if device=="cpu":
             if (isinstance(array,np.ndarray)):
-                b.getOneHotEncodedLabels(self._handle, array.ctypes.data_as(ctypes.c_void_p), self._numOfClasses, 0)
+                b.getEncodedLabels(self._handle, array.ctypes.data_as(ctypes.c_void_p), 0)
             else: #torch tensor
-                return b.getOneHotEncodedLabels(self._handle, ctypes.c_void_p(array.data_ptr()), self._numOfClasses, 0)
+                return b.getEncodedLabels(self._handle, ctypes.c_void_p(array.data_ptr()), 0)
         else:
             if (isinstance(array,cp.ndarray)):
-                b.getCupyOneHotEncodedLabels(self._handle, array.data.ptr, self._numOfClasses, 1)
+                b.getCupyEncodedLabels(self._handle, array.data.ptr, 1)
             else: #torch tensor
-                return b.getOneHotEncodedLabels(self._handle, ctypes.c_void_p(array.data_ptr()), self._numOfClasses, 1)
+                return b.getEncodedLabels(self._handle, ctypes.c_void_p(array.data_ptr()), 1)
+
+    def GetEncodedLabels(self):
+        """Returns (targets [bs, num_classes] float32, mix parameters [bs, 6] float32) of fn.one_hot viewing the output batch without a copy,
+        the mix parameters of a sample are the sample mixed in, the sample's own weight and the normalized cutmix box x0, y0, x1, y1"""
+        return b.rocalGetEncodedLabels(self._handle, self._batch_size, self._numOfClasses)
 
     def set_outputs(self, *output_list):
         self._output_list_length = len(output_list)
@@ -242,6 +264,15 @@ class Pipeline(object):
     def set_seed(self,seed=0):
         return b.setSeed(seed)
 
+    def set_sample_info_cache_dir(self,cache_dir):
+        return b.setSampleInfoCacheDir(cache_dir)
+
+    def set_decode_thread_budget(self,thread_count):
+        return b.setDecodeThreadBudget(thread_count)
+
+    def set_decode_share(self,share=1):
+        return b.setDecodeShare(self._handle, share)
+
     @classmethod
     def create_int_param(self,value=1):
         return b.CreateIntParameter(value)
@@ -299,9 +330,42 @@ class Pipeline(object):
     def getEncodedBoxesAndLables(self, batch_size, num_anchors):
         return b.rocalGetEncodedBoxesAndLables(self._handle, batch_size, num_anchors)
 
+    def copyHeatmapTargets(self, heatmaps_array, target_weights_array):
+        b.rocalCopyHeatmapTargets(self._handle, heatmaps_array, target_weights_array)
+
+    def getHeatmapTargets(self, num_joints=17):
+        """Returns (heatmaps [bs, joints, h, w] float32, target_weights [bs, joints, 1] float32) viewing the output batch without a copy"""
+        heatmap_width, heatmap_height = self._heatmap_size
+        return b.rocalGetHeatmapTargets(self._handle, self._batch_size, num_joints, heatmap_height, heatmap_width)
+
     def GetImgSizes(self, array):
         return b.getImgSizes(self._handle, array)
 
+    def GetBatchBoundingBoxes(self):
+        """Returns (bboxes [bs, max_count, 4] float32, labels [bs, max_count] int32, counts [bs] int32), zero padded past each sample's count"""
+        return b.getBatchBoundingBoxes(self._handle, self._batch_size)
+
+    def GetBatchMaskPolygons(self):
+        """Returns (polygon counts [boxes] int32, vertex counts [polygons] int32, coordinates [vertices, 2] float32) of the masks read with masks=True, normalized to the output images"""
+        return b.getBatchMaskPolygons(self._handle, self._batch_size)
+
+    def GetBatchMasks(self, width, height):
+        """Returns the masks read with masks=True drawn at width x height, as a uint8 [boxes, height, width] array in the order of the boxes"""
+        return b.getBatchMasks(self._handle, self._batch_size, width, height)
+
+    def GetMetaDataFields(self):
+        """Returns a dict of the extra meta data fields of the batch by name, a [bs, width] array when every sample has
+        width values, otherwise a (values, counts) tuple"""
+        return b.getMetaDataFields(self._handle, self._batch_size)
+
+    def GetBatchImageSizes(self):
+        """Returns the original (width, height) of every image of the batch as an int32 [bs, 2] array"""
+        return b.getBatchImageSizes(self._handle, self._batch_size)
+
+    def GetBatchImageNames(self):
+        """Returns the file names of the batch as a list of str"""
+        return b.getBatchImageNames(self._handle, self._batch_size)
+
     def GetBoundingBox(self,array):
         return array
 
@@ -332,6 +396,27 @@ class Pipeline(object):
     def Timing_Info(self):
         return b.getTimingInfo(self._handle)
 
+    def enable_stats(self, enable=True):
+        return b.enableStats(self._handle, enable)
+
+    def get_stats(self):
+        """Returns the per stage latency percentiles (us), bytes read and buffer occupancy recorded since enable_stats(), without resetting them."""
+        return b.getPipelineStats(self._handle)
+
+    def enable_auto_tune(self, memory_budget, tuning_batch_count):
+        """Tunes the prefetch depth and decode threads during the first tuning_batch_count batches, must be called before the readers are added."""
+        return b.enableAutoTune(self._handle, memory_budget, tuning_batch_count)
+
+    def get_auto_tune_config(self):
+        return b.getAutoTuneConfig(self._handle)
+
+    def enable_tracing(self, trace_file):
+        """Records the events of the pipeline threads, the Chrome trace is written to trace_file when the pipeline is released or by dump_trace()."""
+        return b.enableTracing(trace_file)
+
+    def dump_trace(self, trace_file=None):
+        return b.dumpTrace(trace_file)
+
 def _discriminate_args(func, **func_kwargs):
     """Split args on those applicable to Pipeline constructor and the decorated function."""
     func_argspec = inspect.getfullargspec(func)
@@ -77,6 +77,8 @@ class ROCALGenericIterator(object):
         color_format = b.getOutputColorFormat(self.loader._handle)
         self.p = (1 if (color_format == int(types.GRAY)) else 3)
         self.labels_size = ((self.bs*self.loader._numOfClasses) if (self.loader._oneHotEncoding == True) else self.bs)
+        # The one-hot targets are encoded as float32 by the pipeline
+        self.labels_dtype = (np.float32 if (self.loader._oneHotEncoding == True) else np.int32)
         if tensor_layout == types.NCHW:
             if self.device == "cpu":
                 if self.tensor_dtype == types.FLOAT:
@@ -85,7 +87,7 @@ class ROCALGenericIterator(object):
                     self.out = np.empty((self.bs*self.n, self.p, int(self.h/self.bs), self.w,), dtype=np.float16)
                 elif self.tensor_dtype == types.UINT8:
                     self.out = np.empty((self.bs*self.n, self.p, int(self.h/self.bs), self.w,), dtype=np.uint8)
-                self.labels = np.empty(self.labels_size, dtype = np.int32)
+                self.labels = np.empty(self.labels_size, dtype = self.labels_dtype)
 
             else:
                 with cp.cuda.Device(device=self.device_id):
@@ -95,7 +97,7 @@ class ROCALGenericIterator(object):
                         self.out = cp.empty((self.bs*self.n, self.p, int(self.h/self.bs), self.w,), dtype=cp.float16)
                     elif self.tensor_dtype == types.UINT8:
                         self.out = cp.empty((self.bs*self.n, self.p, int(self.h/self.bs), self.w,), dtype=cp.uint8)
-                    self.labels = cp.empty(self.labels_size, dtype = cp.int32)
+                    self.labels = cp.empty(self.labels_size, dtype = self.labels_dtype)
 
         else: #NHWC
             if self.device == "cpu":
@@ -105,7 +107,7 @@ class ROCALGenericIterator(object):
                     self.out = np.empty((self.bs*self.n, int(self.h/self.bs), self.w, self.p), dtype=np.float16)
                 elif self.tensor_dtype == types.UINT8:
                     self.out = np.empty((self.bs*self.n, int(self.h/self.bs), self.w, self.p), dtype=np.uint8)
-                self.labels = np.empty(self.labels_size, dtype = np.int32)
+                self.labels = np.empty(self.labels_size, dtype = self.labels_dtype)
 
             else:
                 with cp.cuda.Device(device=self.device_id):
@@ -115,7 +117,7 @@ class ROCALGenericIterator(object):
                         self.out = cp.empty((self.bs*self.n, int(self.h/self.bs), self.w, self.p), dtype=cp.float16)
                     elif self.tensor_dtype == types.UINT8:
                         self.out = cp.empty((self.bs*self.n, int(self.h/self.bs), self.w, self.p), dtype=cp.uint8)
-                    self.labels = cp.empty(self.labels_size, dtype = cp.int32)
+                    self.labels = cp.empty(self.labels_size, dtype = self.labels_dtype)
 
 
         if self.bs != 0:
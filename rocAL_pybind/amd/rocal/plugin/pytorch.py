@@ -24,8 +24,10 @@ import rocal_pybind as b
 import amd.rocal.types as types
 
 class ROCALGenericImageIterator(object):
-    def __init__(self, pipeline):
+    def __init__(self, pipeline, zero_copy=False):
         self.loader = pipeline
+        # With zero_copy the returned images view the pipeline's output buffer instead of a copy, only possible on CPU
+        self.zero_copy = zero_copy and self.loader._rocal_cpu
         self.w = b.getOutputWidth(self.loader._handle)
         self.h = b.getOutputHeight(self.loader._handle)
         self.n = b.getOutputImageCount(self.loader._handle)
@@ -47,7 +49,10 @@ class ROCALGenericImageIterator(object):
         if self.loader.run() != 0:
             raise StopIteration
 
-        self.loader.copyImage(self.out_image)
+        if self.zero_copy:
+            self.out_image = self.loader.leaseOutput(self.out_image.shape)
+        else:
+            self.loader.copyImage(self.out_image)
         if((self.loader._name == "Caffe2ReaderDetection") or (self.loader._name == "CaffeReaderDetection")):
 
             for i in range(self.bs):
@@ -69,7 +74,7 @@ class ROCALGenericImageIterator(object):
 
 
 class ROCALGenericIterator(object):
-    def __init__(self, pipeline, tensor_layout = types.NCHW, reverse_channels = False, multiplier = [1.0,1.0,1.0], offset = [0.0, 0.0, 0.0], tensor_dtype=types.FLOAT, display=False, device="cpu", device_id =0):
+    def __init__(self, pipeline, tensor_layout = types.NCHW, reverse_channels = False, multiplier = [1.0,1.0,1.0], offset = [0.0, 0.0, 0.0], tensor_dtype=types.FLOAT, display=False, device="cpu", device_id =0, zero_copy=False):
         self.loader = pipeline
         self.tensor_format =tensor_layout
         self.multiplier = multiplier
@@ -88,6 +93,8 @@ class ROCALGenericIterator(object):
         color_format = b.getOutputColorFormat(self.loader._handle)
         self.p = (1 if (color_format == int(types.GRAY)) else 3)
         self.labels_size = ((self.bs*self.loader._numOfClasses) if (self.loader._oneHotEncoding == True) else self.bs)
+        # The one-hot targets are encoded as float32 by the pipeline
+        self.labels_dtype = (torch.float32 if (self.loader._oneHotEncoding == True) else torch.int32)
         if self.tensor_format == types.NCHW:
             if self.device == "cpu":
                 if self.tensor_dtype == types.FLOAT:
@@ -96,7 +103,7 @@ class ROCALGenericIterator(object):
                     self.out = torch.empty((self.bs*self.n, self.p, int(self.h/self.bs), self.w,), dtype=torch.float16)
                 elif self.tensor_dtype == types.UINT8:
                     self.out = torch.empty((self.bs*self.n, self.p, int(self.h/self.bs), self.w,), dtype=torch.uint8)
-                self.labels = torch.empty(self.labels_size, dtype = torch.int32)
+                self.labels = torch.empty(self.labels_size, dtype = self.labels_dtype)
 
             else:
                 torch_gpu_device = torch.device('cuda', self.device_id)
@@ -106,7 +113,7 @@ class ROCALGenericIterator(object):
                     self.out = torch.empty((self.bs*self.n, self.p, int(self.h/self.bs), self.w,), dtype=torch.float16, device = torch_gpu_device)
                 elif self.tensor_dtype ==types.UINT8:
                     self.out = torch.empty((self.bs*self.n, self.p, int(self.h/self.bs), self.w,), dtype=torch.uint8, device = torch_gpu_device)
-                self.labels = torch.empty(self.labels_size, dtype = torch.int32, device = torch_gpu_device)
+                self.labels = torch.empty(self.labels_size, dtype = self.labels_dtype, device = torch_gpu_device)
 
         else: #NHWC
             if self.device == "cpu":
@@ -116,7 +123,7 @@ class ROCALGenericIterator(object):
                     self.out = torch.empty((self.bs*self.n, int(self.h/self.bs), self.w, self.p), dtype=torch.float16)
                 elif self.tensor_dtype == types.UINT8:
                     self.out = torch.empty((self.bs*self.n, int(self.h/self.bs), self.w, self.p), dtype=torch.uint8)
-                self.labels = torch.empty(self.labels_size, dtype = torch.int32)
+                self.labels = torch.empty(self.labels_size, dtype = self.labels_dtype)
 
             else:
                 torch_gpu_device = torch.device('cuda', self.device_id)
@@ -126,7 +133,14 @@ class ROCALGenericIterator(object):
                     self.out = torch.empty((self.bs*self.n, int(self.h/self.bs), self.w, self.p), dtype=torch.float16, device=torch_gpu_device)
                 elif self.tensor_dtype == types.UINT8:
                     self.out = torch.empty((self.bs*self.n, int(self.h/self.bs), self.w, self.p), dtype=torch.uint8, device=torch_gpu_device)
-                self.labels = torch.empty(self.labels_size, dtype = torch.int32, device = torch_gpu_device)
+                self.labels = torch.empty(self.labels_size, dtype = self.labels_dtype, device = torch_gpu_device)
+
+        # The output buffer can only be handed over as is if no conversion is requested
+        self.zero_copy = zero_copy and self.device == "cpu" and self.loader._rocal_cpu and self.tensor_format == types.NHWC and \
+                         self.tensor_dtype == types.UINT8 and list(self.multiplier) == [1.0, 1.0, 1.0] and \
+                         list(self.offset) == [0.0, 0.0, 0.0] and not self.reverse_channels
+        if zero_copy and not self.zero_copy:
+            print("zero_copy needs a CPU pipeline with NHWC UINT8 output and no normalization, the outputs are copied")
 
         if self.bs != 0:
             self.len = b.getRemainingImages(self.loader._handle)//self.bs
@@ -143,65 +157,35 @@ class ROCALGenericIterator(object):
         if self.loader.run() != 0:
             raise StopIteration
 
-        self.loader.copyToExternalTensor(
-            self.out, self.multiplier, self.offset, self.reverse_channels, self.tensor_format, self.tensor_dtype)
+        if self.zero_copy:
+            # The tensor views the pipeline's output buffer, which is handed back to the pipeline once the tensor is dropped
+            self.out = torch.from_numpy(self.loader.leaseOutput(self.out.shape))
+        else:
+            self.loader.copyToExternalTensor(
+                self.out, self.multiplier, self.offset, self.reverse_channels, self.tensor_format, self.tensor_dtype)
 
         if((self.loader._name == "Caffe2ReaderDetection") or (self.loader._name == "CaffeReaderDetection")):
-            self.lis = []  # Empty list for bboxes
-            self.lis_lab = []  # Empty list of labels
-
-            # Count of labels/ bboxes in a batch
-            self.bboxes_label_count = np.zeros(self.bs, dtype="int32")
-            self.count_batch = self.loader.GetBoundingBoxCount(self.bboxes_label_count)
-            # 1D labels array in a batch
-            self.labels = np.zeros(self.count_batch, dtype="int32")
-            self.loader.GetBBLabels(self.labels)
-            # 1D bboxes array in a batch
-            self.bboxes = np.zeros((self.count_batch*4), dtype="float32")
-            self.loader.GetBBCords(self.bboxes)
+            # Boxes and labels of the batch, zero padded to the largest per image count in a single native call
+            self.bboxes, self.labels, self.bboxes_label_count = self.loader.GetBatchBoundingBoxes()
             #Image sizes of a batch
-            self.img_size = np.zeros((self.bs * 2),dtype = "int32")
-            self.loader.GetImgSizes(self.img_size)
-
-            count =0
-            sum_count=0
-            for i in range(self.bs):
-                count = self.bboxes_label_count[i]
-
-                self.label_2d_numpy = (self.labels[sum_count : sum_count+count])
-                self.label_2d_numpy = np.reshape(self.label_2d_numpy, (-1, 1)).tolist()
-                self.bb_2d_numpy = (self.bboxes[sum_count*4 : (sum_count+count)*4])
-                self.bb_2d_numpy = np.reshape(self.bb_2d_numpy, (-1, 4)).tolist()
+            self.img_size = self.loader.GetBatchImageSizes()
 
-                self.lis_lab.append(self.label_2d_numpy)
-                self.lis.append(self.bb_2d_numpy)
-
-                if self.display:
+            if self.display:
+                for i in range(self.bs):
                     img = (self.out)
-                    draw_patches(img[i], i, self.bb_2d_numpy)
-
-                sum_count = sum_count + count
+                    draw_patches(img[i], i, self.bboxes[i][:self.bboxes_label_count[i]].tolist())
 
-            self.target = self.lis
-            self.target1 = self.lis_lab
-            max_cols = max([len(row) for batch in self.target for row in batch])
-            max_rows = max([len(batch) for batch in self.target])
-            self.bb_padded = [batch + [[0] * (max_cols)] * (max_rows - len(batch)) for batch in self.target]
-            self.bb_padded = torch.FloatTensor([row + [0] * (max_cols - len(row)) for batch in self.bb_padded for row in batch])
-            self.bb_padded = self.bb_padded.view(-1, max_rows, max_cols)
-
-            max_cols1 = max([len(row) for batch in self.target1 for row in batch])
-            max_rows1 = max([len(batch) for batch in self.target1])
-            self.labels_padded = [batch + [[0] * (max_cols1)] * (max_rows1 - len(batch)) for batch in self.target1]
-            self.labels_padded = torch.LongTensor([row + [0] * (max_cols1 - len(row)) for batch in self.labels_padded for row in batch])
-            self.labels_padded = self.labels_padded.view(-1, max_rows1, max_cols1)
+            self.bb_padded = torch.from_numpy(self.bboxes)
+            self.labels_padded = torch.from_numpy(self.labels).long().unsqueeze(-1)
 
             return self.out,self.bb_padded, self.labels_padded
 
         else:
             if(self.loader._oneHotEncoding == True):
                 self.loader.GetOneHotEncodedLabels(self.labels, self.device)
-                self.labels_tensor = self.labels.view(-1, self.bs, self.loader._numOfClasses).long()
+                self.labels_tensor = self.labels.view(-1, self.bs, self.loader._numOfClasses)
+                if not self.loader._softLabels:
+                    self.labels_tensor = self.labels_tensor.long()
             else:
                 if self.display:
                     for i in range(self.bs):
@@ -292,10 +276,12 @@ class ROCALClassificationIterator(ROCALGenericIterator):
                  last_batch_padded=False,
                  display=False,
                  device="cpu",
-                 device_id =0):
+                 device_id =0,
+                 zero_copy=False):
         pipe = pipelines
         super(ROCALClassificationIterator, self).__init__(pipe, tensor_layout = pipe._tensor_layout, tensor_dtype = pipe._tensor_dtype,
-                                                            multiplier=pipe._multiplier, offset=pipe._offset,display=display, device=device, device_id = device_id)
+                                                            multiplier=pipe._multiplier, offset=pipe._offset,display=display, device=device, device_id = device_id,
+                                                            zero_copy=zero_copy)
 
 
 class ROCAL_iterator(ROCALGenericImageIterator):
@@ -310,9 +296,10 @@ class ROCAL_iterator(ROCALGenericImageIterator):
                  auto_reset=False,
                  fill_last_batch=True,
                  dynamic_shape=False,
-                 last_batch_padded=False):
+                 last_batch_padded=False,
+                 zero_copy=False):
         pipe = pipelines
-        super(ROCAL_iterator, self).__init__(pipe)
+        super(ROCAL_iterator, self).__init__(pipe, zero_copy=zero_copy)
 
 
 def draw_patches(img,idx, bboxes):
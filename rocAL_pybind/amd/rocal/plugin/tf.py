@@ -23,8 +23,10 @@ import cupy as cp
 import rocal_pybind as b
 import amd.rocal.types as types
 class ROCALGenericImageIterator(object):
-    def __init__(self, pipeline):
+    def __init__(self, pipeline, zero_copy=False):
         self.loader = pipeline
+        # With zero_copy the returned images view the pipeline's output buffer instead of a copy, only possible on CPU
+        self.zero_copy = zero_copy and self.loader._rocal_cpu
         self.w = b.getOutputWidth(self.loader._handle)
         self.h = b.getOutputHeight(self.loader._handle)
         self.n = b.getOutputImageCount(self.loader._handle)
@@ -45,7 +47,10 @@ class ROCALGenericImageIterator(object):
         if self.loader.run() != 0:
             raise StopIteration
 
-        self.loader.copyImage(self.out_image)
+        if self.zero_copy:
+            self.out_image = self.loader.leaseOutput(self.out_image.shape)
+        else:
+            self.loader.copyImage(self.out_image)
         return self.out_image , self.out_tensor
 
     def reset(self):
@@ -113,51 +118,17 @@ class ROCALGenericIteratorDetection(object):
             self.loader.copyToExternalTensorNHWC(self.out, self.multiplier, self.offset, self.reverse_channels, int(self.tensor_dtype))
 
         if(self.loader._name == "TFRecordReaderDetection"):
-            self.bbox_list =[]
-            self.label_list=[]
-            self.num_bboxes_list=[]
-            #Count of labels/ bboxes in a batch
-            self.bboxes_label_count = np.zeros(self.bs, dtype="int32")
-            self.count_batch = self.loader.GetBoundingBoxCount(self.bboxes_label_count)
-            self.num_bboxes_list = self.bboxes_label_count.tolist()
-            # 1D labels array in a batch
-            self.labels = np.zeros(self.count_batch, dtype="int32")
-            self.loader.GetBBLabels(self.labels)
-            # 1D bboxes array in a batch
-            self.bboxes = np.zeros((self.count_batch*4), dtype="float32")
-            self.loader.GetBBCords(self.bboxes)
-            #1D Image sizes array of image in a batch
-            self.img_size = np.zeros((self.bs * 2),dtype = "int32")
-            self.loader.GetImgSizes(self.img_size)
-            count =0 # number of bboxes per image
-            sum_count=0 # sum of the no. of the bboxes
-            for i in range(self.bs):
-                count = self.bboxes_label_count[i]
-                self.label_2d_numpy = (self.labels[sum_count : sum_count+count])
-                self.label_2d_numpy = np.reshape(self.label_2d_numpy, (-1, 1)).tolist()
-                self.bb_2d_numpy = (self.bboxes[sum_count*4 : (sum_count+count)*4])
-                self.bb_2d_numpy = np.reshape(self.bb_2d_numpy, (-1, 4)).tolist()
-                self.label_list.append(self.label_2d_numpy)
-                self.bbox_list.append(self.bb_2d_numpy)
-                sum_count = sum_count +count
-
-            self.target = self.bbox_list
-            self.target1 = self.label_list
-            max_cols = max([len(row) for batch in self.target for row in batch])
-            # max_rows = max([len(batch) for batch in self.target])
-            max_rows = 100
-            bb_padded = [batch + [[0] * (max_cols)] * (max_rows - len(batch)) for batch in self.target]
-            bb_padded_1=[row + [0] * (max_cols - len(row)) for batch in bb_padded for row in batch]
-            arr = np.asarray(bb_padded_1)
-            self.res = np.reshape(arr, (-1, max_rows, max_cols))
-            max_cols = max([len(row) for batch in self.target1 for row in batch])
-            # max_rows = max([len(batch) for batch in self.target1])
+            # Boxes and labels of the batch, zero padded to the largest per image count in a single native call
+            bboxes, labels, self.num_bboxes_arr = self.loader.GetBatchBoundingBoxes()
+            #Image sizes of a batch
+            self.img_size = self.loader.GetBatchImageSizes()
+            # The detection models expect a fixed number of 100 boxes per image
             max_rows = 100
-            lab_padded = [batch + [[0] * (max_cols)] * (max_rows - len(batch)) for batch in self.target1]
-            lab_padded_1=[row + [0] * (max_cols - len(row)) for batch in lab_padded for row in batch]
-            labarr = np.asarray(lab_padded_1)
-            self.l = np.reshape(labarr, (-1, max_rows, max_cols))
-            self.num_bboxes_arr = np.array(self.num_bboxes_list)
+            self.res = np.zeros((self.bs, max_rows, 4), dtype="float64")
+            self.l = np.zeros((self.bs, max_rows, 1), dtype="int64")
+            rows = min(max_rows, bboxes.shape[1])
+            self.res[:, :rows] = bboxes[:, :rows]
+            self.l[:, :rows, 0] = labels[:, :rows]
 
             if self.tensor_dtype == types.FLOAT:
                 return self.out.astype(np.float32), self.res, self.l, self.num_bboxes_arr
@@ -165,7 +136,7 @@ class ROCALGenericIteratorDetection(object):
                 return self.out.astype(np.float16), self.res, self.l, self.num_bboxes_arr
         elif (self.loader._name == "TFRecordReaderClassification"):
             if(self.loader._oneHotEncoding == True):
-                self.labels = np.zeros((self.bs)*(self.loader._numOfClasses),dtype = "int32")
+                self.labels = np.zeros((self.bs)*(self.loader._numOfClasses),dtype = "float32")
                 self.loader.GetOneHotEncodedLabels(self.labels, device="cpu")
                 self.labels = np.reshape(self.labels, (-1, self.bs, self.loader._numOfClasses))
             else:
@@ -224,6 +195,7 @@ class ROCAL_iterator(ROCALGenericImageIterator):
                  auto_reset=False,
                  fill_last_batch=True,
                  dynamic_shape=False,
-                 last_batch_padded=False):
+                 last_batch_padded=False,
+                 zero_copy=False):
         pipe = pipelines
-        super(ROCAL_iterator, self).__init__(pipe)
+        super(ROCAL_iterator, self).__init__(pipe, zero_copy=zero_copy)
@@ -33,10 +33,19 @@ def coco(*inputs, file_root, annotations_file='', bytes_per_sample_hint=0, dump_
     #Output
     labels = []
     bboxes = []
-    kwargs_pybind = {"source_path": annotations_file, "is_output":True}
+    kwargs_pybind = {"source_path": annotations_file, "is_output":True, "mask":masks}
     meta_data = b.COCOReader(Pipeline._current_pipeline._handle ,*(kwargs_pybind.values()))
     return (meta_data, labels, bboxes)
 
+def coco_keypoints(*inputs, file_root, annotations_file='', sigma=2.0, pose_output_size=None):
+    # pose_output_size is the [width, height] of the images given to the pose model
+    Pipeline._current_pipeline._reader = "COCOReaderKeyPoints"
+    pose_output_size = pose_output_size if pose_output_size else [192, 256]
+    kwargs_pybind = {"source_path": annotations_file, "is_output":True, "sigma":sigma,
+                     "pose_output_width":pose_output_size[0], "pose_output_height":pose_output_size[1]}
+    meta_data = b.COCOReaderKeyPoints(Pipeline._current_pipeline._handle ,*(kwargs_pybind.values()))
+    return meta_data
+
 def file(*inputs, file_root, bytes_per_sample_hint=0, file_list='', initial_fill='', lazy_init='',
          num_shards=1, pad_last_batch=False, prefetch_queue_depth=1, preserve=False, random_shuffle=False,
          read_ahead=False, seed=-1, shard_id=0, shuffle_after_epoch=False, skip_cached_images=False,
@@ -52,8 +61,8 @@ def file(*inputs, file_root, bytes_per_sample_hint=0, file_list='', initial_fill
 def tfrecord(*inputs, path, user_feature_key_map, features, index_path="", reader_type=0,
              bytes_per_sample_hint=0, initial_fill=1024, lazy_init=False, num_shards=1, pad_last_batch=False,
              prefetch_queue_depth=1, preserve=False, random_shuffle=False, read_ahead=False, seed=-1, shard_id=0,
-             skip_cached_images=False, stick_to_shard=False, tensor_init_bytes=1048576,  device=None):
-
+             skip_cached_images=False, stick_to_shard=False, tensor_init_bytes=1048576,  device=None, fields=None):
+    # fields: feature keys of the records returned as extra meta data by Pipeline.GetMetaDataFields(), classification only
     labels=[]
     if reader_type == 1:
         Pipeline._current_pipeline._reader = "TFRecordReaderDetection"
@@ -69,7 +78,8 @@ def tfrecord(*inputs, path, user_feature_key_map, features, index_path="", reade
     else:
         Pipeline._current_pipeline._reader = "TFRecordReaderClassification"
         kwargs_pybind = {"path": path, "is_output": True, "user_key_for_label": user_feature_key_map[
-            "image/class/label"], "user_key_for_filename": user_feature_key_map["image/filename"]}
+            "image/class/label"], "user_key_for_filename": user_feature_key_map["image/filename"],
+            "user_keys_for_fields": ",".join(fields) if fields else None}
         for key in features.keys():
                 if key not in user_feature_key_map.keys():
                     print(
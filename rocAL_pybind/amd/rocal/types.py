@@ -36,6 +36,10 @@ from rocal_pybind.types import UINT8
 from rocal_pybind.types import FLOAT
 from rocal_pybind.types import FLOAT16
 
+#  RocalCpuPlacement
+from rocal_pybind.types import CPU_PLACEMENT_NONE
+from rocal_pybind.types import CPU_PLACEMENT_NUMA
+
 #  RocalOutputMemType
 from rocal_pybind.types import CPU_MEMORY
 from rocal_pybind.types import GPU_MEMORY
@@ -96,6 +100,8 @@ _known_types = {
     UINT8: ("UINT8", UINT8),
     FLOAT: ("FLOAT", FLOAT),
     FLOAT16: ("FLOAT16", FLOAT16),
+    CPU_PLACEMENT_NONE: ("CPU_PLACEMENT_NONE", CPU_PLACEMENT_NONE),
+    CPU_PLACEMENT_NUMA: ("CPU_PLACEMENT_NUMA", CPU_PLACEMENT_NUMA),
     CPU_MEMORY: ("CPU_MEMORY", CPU_MEMORY),
     GPU_MEMORY: ("GPU_MEMORY", GPU_MEMORY),
     PINNED_MEMORY: ("PINNED_MEMORY", PINNED_MEMORY),
@@ -0,0 +1,104 @@
+# Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+from amd.rocal.pipeline import Pipeline
+import amd.rocal.fn as fn
+import amd.rocal.types as types
+import numpy as np
+import torch
+import sys
+import time
+
+def DetectionPipe(batch_size, num_threads, device_id, data_dir, rocal_cpu = True):
+    pipe = Pipeline(batch_size = batch_size, num_threads = num_threads, device_id = device_id, rocal_cpu = rocal_cpu)
+    with pipe:
+        jpegs, labels, bboxes = fn.readers.caffe(path = data_dir, bbox = True, random_shuffle = False)
+        images = fn.decoders.image(jpegs, path = data_dir, output_type = types.RGB, random_shuffle = False)
+        images = fn.resize(images, resize_x = 300, resize_y = 300)
+        pipe.set_outputs(images)
+    return pipe
+
+def python_padding(pipe, bs):
+    # Per sample extraction and list based padding, as the iterators used to do
+    counts = np.zeros(bs, dtype = "int32")
+    total = pipe.GetBoundingBoxCount(counts)
+    labels = np.zeros(total, dtype = "int32")
+    pipe.GetBBLabels(labels)
+    bboxes = np.zeros(total * 4, dtype = "float32")
+    pipe.GetBBCords(bboxes)
+    img_size = np.zeros(bs * 2, dtype = "int32")
+    pipe.GetImgSizes(img_size)
+    bb_list, label_list = [], []
+    sum_count = 0
+    for i in range(bs):
+        count = counts[i]
+        label_list.append(np.reshape(labels[sum_count : sum_count + count], (-1, 1)).tolist())
+        bb_list.append(np.reshape(bboxes[sum_count * 4 : (sum_count + count) * 4], (-1, 4)).tolist())
+        sum_count += count
+    max_rows = max([len(batch) for batch in bb_list])
+    bb_padded = [batch + [[0] * 4] * (max_rows - len(batch)) for batch in bb_list]
+    bb_padded = torch.FloatTensor([row for batch in bb_padded for row in batch]).view(-1, max_rows, 4)
+    labels_padded = [batch + [[0]] * (max_rows - len(batch)) for batch in label_list]
+    labels_padded = torch.LongTensor([row for batch in labels_padded for row in batch]).view(-1, max_rows, 1)
+    return bb_padded, labels_padded
+
+def native_padding(pipe, bs):
+    bboxes, labels, _ = pipe.GetBatchBoundingBoxes()
+    pipe.GetBatchImageSizes()
+    return torch.from_numpy(bboxes), torch.from_numpy(labels).long().unsqueeze(-1)
+
+def main():
+    if len(sys.argv) < 4:
+        print ('Please pass caffe_lmdb_detection_folder cpu/gpu batch_size')
+        exit(0)
+    data_dir = sys.argv[1]
+    rocal_cpu = sys.argv[2] == "cpu"
+    bs = int(sys.argv[3])
+    pipe = DetectionPipe(batch_size = bs, num_threads = 4, device_id = 0, data_dir = data_dir, rocal_cpu = rocal_cpu)
+    pipe.build()
+    out = np.empty(pipe.getOutputImageCount() * pipe.getOutputHeight() * pipe.getOutputWidth() * 3, dtype = "uint8")
+    batches = 0
+    copy_time = python_time = native_time = 0.0
+    while not pipe.isEmpty():
+        if pipe.run() != 0:
+            break
+        start = time.perf_counter()
+        pipe.copyImage(out)
+        copy_time += time.perf_counter() - start
+        start = time.perf_counter()
+        bb_python, labels_python = python_padding(pipe, bs)
+        python_time += time.perf_counter() - start
+        start = time.perf_counter()
+        bb_native, labels_native = native_padding(pipe, bs)
+        native_time += time.perf_counter() - start
+        if not (torch.equal(bb_python, bb_native) and torch.equal(labels_python, labels_native)):
+            print("Mismatch between the python and native padded boxes at batch", batches)
+            exit(1)
+        batches += 1
+    if batches == 0:
+        print("No batch was produced")
+        exit(1)
+    print("Batches                                 ", batches)
+    print("Image copy per batch              (ms)  ", copy_time * 1000 / batches)
+    print("Python metadata padding per batch (ms)  ", python_time * 1000 / batches)
+    print("Native metadata padding per batch (ms)  ", native_time * 1000 / batches)
+
+if __name__ == '__main__':
+    main()
@@ -131,11 +131,10 @@ class ROCALCOCOIterator(object):
             self.bboxes_label_count)
         # 1D labels & bboxes array
         if self.device == "cpu":
-          self.encoded_bboxes = np.zeros((self.count_batch*4), dtype="float32")
-          self.encoded_labels = np.zeros(self.count_batch, dtype="int32")
-          self.loader.copyEncodedBoxesAndLables(self.encoded_bboxes, self.encoded_labels)
-          encoded_bboxes_tensor = torch.tensor(self.encoded_bboxes).view(self.bs, -1, 4).contiguous()
-          encodded_labels_tensor = torch.tensor(self.encoded_labels).long().view(self.bs, -1)
+          # The encoded boxes and labels are read from the output buffers, torch.tensor() copies them before the next batch reuses them
+          boxes_array, labels_array = self.loader.getEncodedBoxesAndLables(self.bs, int(self.num_anchors))
+          encoded_bboxes_tensor = torch.tensor(boxes_array)
+          encodded_labels_tensor = torch.tensor(labels_array).long()
         else:
           torch_gpu_device = torch.device('cuda', self.device_id)
           boxes_array, labels_array = self.loader.getEncodedBoxesAndLables(self.bs, int(self.num_anchors))
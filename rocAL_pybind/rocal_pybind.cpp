@@ -24,6 +24,9 @@ THE SOFTWARE.
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 #include <iostream>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
 #include <pybind11/embed.h>
 #include <pybind11/eval.h>
 #include "rocal_api_types.h"
@@ -73,10 +76,90 @@ namespace rocal{
         auto buf = array.request();
         unsigned char* ptr = (unsigned char*) buf.ptr;
         // call pure C++ function
-        int status = rocalCopyToOutput(context, ptr, buf.size);
+        {
+            py::gil_scoped_release release;
+            rocalCopyToOutput(context, ptr, buf.size);
+        }
         return py::cast<py::none>(Py_None);
     }
 
+    py::object wrapper_copy_to_output_ragged(RocalContext context, unsigned batch_size)
+    {
+        // All the samples are packed in a single array, the returned list holds a view on it per sample
+        size_t sample_count = batch_size * rocalGetAugmentationBranchCount(context);
+        py::array_t<unsigned char> packed(rocalGetOutputRaggedSize(context));
+        std::vector<unsigned> shapes(sample_count * 3);
+        std::vector<size_t> offsets(sample_count);
+        auto buf = packed.request();
+        RocalStatus status;
+        // call pure C++ function
+        {
+            py::gil_scoped_release release;
+            status = rocalCopyToOutputRagged(context, (unsigned char *)buf.ptr, buf.size, shapes.data(), offsets.data());
+        }
+        if (status != ROCAL_OK)
+            throw std::runtime_error(rocalGetErrorMessage(context));
+        py::list samples;
+        for (size_t i = 0; i < sample_count; i++)
+        {
+            size_t height = shapes[i * 3], width = shapes[i * 3 + 1], channels = shapes[i * 3 + 2];
+            samples.append(py::array_t<unsigned char>({height, width, channels}, {width * channels, channels, (size_t)1},
+                                                      (unsigned char *)buf.ptr + offsets[i], packed));
+        }
+        return samples;
+    }
+
+    struct OutputLease
+    {
+        RocalContext context;
+        int lease_id;
+        std::shared_ptr<bool> context_alive; //!< Cleared by rocalRelease, the arrays viewing the buffer can outlive the pipeline
+    };
+
+    // Liveness flag of every context with leases, the leases and the releases are serialized by the GIL
+    static std::unordered_map<RocalContext, std::shared_ptr<bool>> leased_contexts;
+
+    RocalStatus wrapper_release(RocalContext context)
+    {
+        auto it = leased_contexts.find(context);
+        if (it != leased_contexts.end())
+        {
+            *it->second = false;
+            leased_contexts.erase(it);
+        }
+        return rocalRelease(context);
+    }
+
+    py::object wrapper_lease_output(RocalContext context, std::vector<size_t> shape)
+    {
+        void *ptr = nullptr;
+        size_t size = 0;
+        auto &context_alive = leased_contexts[context];
+        if (!context_alive)
+            context_alive = std::make_shared<bool>(true);
+        auto lease = new OutputLease{context, -1, context_alive};
+        // call pure C++ function
+        if (rocalLeaseOutput(context, &ptr, &size, &lease->lease_id) != ROCAL_OK)
+        {
+            delete lease;
+            throw std::runtime_error(rocalGetErrorMessage(context));
+        }
+        // The lease is released when the last array or tensor viewing the buffer is dropped
+        py::capsule release_lease(lease, [](void *p) {
+            auto lease = static_cast<OutputLease *>(p);
+            // The ring buffer is gone with the context, there is nothing left to release
+            if (*lease->context_alive)
+                rocalReleaseOutputLease(lease->context, lease->lease_id);
+            delete lease;
+        });
+        size_t elements = 1;
+        for (auto dim : shape)
+            elements *= dim;
+        if (elements != size)
+            throw std::runtime_error("Leased output of " + std::to_string(size) + " bytes does not match the requested shape");
+        return py::array_t<unsigned char>(shape, (unsigned char *)ptr, release_lease);
+    }
+
     py::object wrapper_image_name_length(RocalContext context, py::array_t<int> array)
     {
         auto buf = array.request();
@@ -108,10 +191,12 @@ namespace rocal{
         auto ptr = ctypes_void_ptr(p);
         // call pure C++ function
 
-        int status = rocalToTensor(context, ptr, tensor_format, tensor_output_type, multiplier0,
-                                              multiplier1, multiplier2, offset0,
-                                              offset1, offset2, reverse_channels, output_mem_type);
-        // std::cerr<<"\n Copy failed with status :: "<<status;
+        {
+            py::gil_scoped_release release;
+            rocalToTensor(context, ptr, tensor_format, tensor_output_type, multiplier0,
+                                     multiplier1, multiplier2, offset0,
+                                     offset1, offset2, reverse_channels, output_mem_type);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -124,10 +209,12 @@ namespace rocal{
         auto buf = array.request();
         float* ptr = (float*) buf.ptr;
         // call pure C++ function
-        int status = rocalToTensor32(context, ptr, tensor_format, multiplier0,
-                                              multiplier1, multiplier2, offset0,
-                                              offset1, offset2, reverse_channels, output_mem_type);
-        // std::cerr<<"\n Copy failed with status :: "<<status;
+        {
+            py::gil_scoped_release release;
+            rocalToTensor32(context, ptr, tensor_format, multiplier0,
+                                     multiplier1, multiplier2, offset0,
+                                     offset1, offset2, reverse_channels, output_mem_type);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -140,10 +227,12 @@ namespace rocal{
         auto buf = array.request();
         float16* ptr = (float16*) buf.ptr;
         // call pure C++ function
-        int status = rocalToTensor16(context, ptr, tensor_format, multiplier0,
-                                              multiplier1, multiplier2, offset0,
-                                              offset1, offset2, reverse_channels, output_mem_type);
-        // std::cerr<<"\n Copy failed with status :: "<<status;
+        {
+            py::gil_scoped_release release;
+            rocalToTensor16(context, ptr, tensor_format, multiplier0,
+                                     multiplier1, multiplier2, offset0,
+                                     offset1, offset2, reverse_channels, output_mem_type);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -155,10 +244,12 @@ namespace rocal{
     {
         float * ptr = (float*)array_ptr;
         // call pure C++ function
-        int status = rocalToTensor32(context, ptr, tensor_format, multiplier0,
-                                              multiplier1, multiplier2, offset0,
-                                              offset1, offset2, reverse_channels, output_mem_type);
-        // std::cerr<<"\n Copy failed with status :: "<<status;
+        {
+            py::gil_scoped_release release;
+            rocalToTensor32(context, ptr, tensor_format, multiplier0,
+                                     multiplier1, multiplier2, offset0,
+                                     offset1, offset2, reverse_channels, output_mem_type);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -170,10 +261,12 @@ namespace rocal{
     {
         float16 * ptr = (float16*)array_ptr;
         // call pure C++ function
-        int status = rocalToTensor16(context, ptr, tensor_format, multiplier0,
-                                              multiplier1, multiplier2, offset0,
-                                              offset1, offset2, reverse_channels, output_mem_type);
-        // std::cerr<<"\n Copy failed with status :: "<<status;
+        {
+            py::gil_scoped_release release;
+            rocalToTensor16(context, ptr, tensor_format, multiplier0,
+                                     multiplier1, multiplier2, offset0,
+                                     offset1, offset2, reverse_channels, output_mem_type);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -181,7 +274,10 @@ namespace rocal{
     {
         auto ptr = ctypes_void_ptr(p);
         // call pure C++ function
-        rocalGetImageLabels(context,ptr, output_mem_type);
+        {
+            py::gil_scoped_release release;
+            rocalGetImageLabels(context,ptr, output_mem_type);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -189,7 +285,10 @@ namespace rocal{
     {
         void * ptr = (void*)array_ptr;
         // call pure C++ function
-        rocalGetImageLabels(context,ptr, output_mem_type);
+        {
+            py::gil_scoped_release release;
+            rocalGetImageLabels(context,ptr, output_mem_type);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -198,7 +297,10 @@ namespace rocal{
         auto buf = array.request();
         int* ptr = (int*) buf.ptr;
         // call pure C++ function
-        rocalGetImageId(context,ptr);
+        {
+            py::gil_scoped_release release;
+            rocalGetImageId(context,ptr);
+        }
         return py::cast<py::none>(Py_None);
     }
     py::object wrapper_labels_BB_count_copy(RocalContext context, py::array_t<int> array)
@@ -217,7 +319,10 @@ namespace rocal{
         auto buf = array.request();
         int* ptr = (int*) buf.ptr;
         // call pure C++ function
-        rocalGetBoundingBoxLabel(context,ptr);
+        {
+            py::gil_scoped_release release;
+            rocalGetBoundingBoxLabel(context,ptr);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -228,7 +333,10 @@ namespace rocal{
         auto labels_buf = labels_array.request();
         int* labels_ptr = (int*) labels_buf.ptr;
         // call pure C++ function
-        rocalCopyEncodedBoxesAndLables(context, bboxes_ptr , labels_ptr);
+        {
+            py::gil_scoped_release release;
+            rocalCopyEncodedBoxesAndLables(context, bboxes_ptr , labels_ptr);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -254,12 +362,126 @@ namespace rocal{
     }
 
 
+    py::tuple wrapper_batch_mask_polygons(RocalContext context, unsigned batch_size)
+    {
+        // Returns the polygon count of each box, the vertex count of each polygon and the [vertices, 2] coordinates
+        std::vector<int> box_counts(batch_size);
+        int box_count = rocalGetBoundingBoxCount(context, box_counts.data());
+        py::array_t<int> polygon_counts_array(box_count);
+        int polygon_count;
+        {
+            py::gil_scoped_release release;
+            polygon_count = rocalGetMaskCount(context, polygon_counts_array.mutable_data());
+        }
+        py::array_t<int> vertex_counts_array(polygon_count);
+        int vertex_count;
+        {
+            py::gil_scoped_release release;
+            vertex_count = rocalGetMaskVertexCount(context, vertex_counts_array.mutable_data());
+        }
+        py::array_t<float> coords_array({(size_t)vertex_count, (size_t)2});
+        {
+            py::gil_scoped_release release;
+            rocalGetMaskCoordinates(context, coords_array.mutable_data());
+        }
+        return py::make_tuple(polygon_counts_array, vertex_counts_array, coords_array);
+    }
+
+    py::array_t<unsigned char> wrapper_batch_masks(RocalContext context, unsigned batch_size, unsigned width, unsigned height)
+    {
+        // Returns a [boxes, height, width] uint8 mask per box of the batch, in the order of the boxes
+        std::vector<int> box_counts(batch_size);
+        int box_count = rocalGetBoundingBoxCount(context, box_counts.data());
+        py::array_t<unsigned char> masks_array({(size_t)box_count, (size_t)height, (size_t)width});
+        unsigned char *masks_ptr = masks_array.mutable_data();
+        {
+            py::gil_scoped_release release;
+            rocalGetMasks(context, masks_ptr, width, height);
+        }
+        return masks_array;
+    }
+
+    py::dict wrapper_meta_data_fields(RocalContext context, unsigned batch_size)
+    {
+        // Returns the extra meta data fields by name, a [bs, width] array when every sample has width values,
+        // otherwise a (values, counts) tuple of the values of all the samples and the number of values of each
+        py::dict fields;
+        unsigned field_count = rocalGetMetaDataFieldCount(context);
+        for (unsigned field = 0; field < field_count; field++)
+        {
+            RocalMetaDataFieldInfo info;
+            rocalGetMetaDataFieldInfo(context, field, &info);
+            py::dtype dtype;
+            switch (info.type)
+            {
+                case ROCAL_FIELD_INT32: dtype = py::dtype::of<int>(); break;
+                case ROCAL_FIELD_INT64: dtype = py::dtype::of<int64_t>(); break;
+                case ROCAL_FIELD_FLOAT32: dtype = py::dtype::of<float>(); break;
+                default: dtype = py::dtype::of<uint8_t>(); break;
+            }
+            std::vector<size_t> shape = {info.value_count};
+            if (info.width)
+                shape = {(size_t)batch_size, (size_t)info.width};
+            py::array values_array(dtype, shape);
+            py::array_t<int> counts_array(batch_size);
+            rocalGetMetaDataField(context, field, values_array.mutable_data(), counts_array.mutable_data());
+            if (info.width)
+                fields[info.name] = values_array;
+            else
+                fields[info.name] = py::make_tuple(values_array, counts_array);
+        }
+        return fields;
+    }
+
+    py::object wrapper_copy_heatmap_targets(RocalContext context, py::array_t<float> heatmaps_array, py::array_t<float> target_weights_array)
+    {
+        auto heatmaps_buf = heatmaps_array.request();
+        auto target_weights_buf = target_weights_array.request();
+        size_t heatmaps_size, target_weights_size;
+        rocalGetHeatmapTargetsSize(context, &heatmaps_size, &target_weights_size);
+        if (static_cast<size_t>(heatmaps_buf.size) < heatmaps_size || static_cast<size_t>(target_weights_buf.size) < target_weights_size)
+            throw std::runtime_error("Heatmap targets need arrays of at least " + std::to_string(heatmaps_size) + " and " +
+                                     std::to_string(target_weights_size) + " floats");
+        // call pure C++ function
+        {
+            py::gil_scoped_release release;
+            rocalCopyHeatmapTargets(context, (float*) heatmaps_buf.ptr, (float*) target_weights_buf.ptr);
+        }
+        return py::cast<py::none>(Py_None);
+    }
+
+    std::pair<py::array_t<float>, py::array_t<float>> wrapper_get_heatmap_targets(RocalContext context, int batch_size, int num_joints, int heatmap_height, int heatmap_width)
+    {
+        float* heatmaps_ptr; float* target_weights_ptr;
+        size_t heatmaps_size, target_weights_size;
+        rocalGetHeatmapTargetsSize(context, &heatmaps_size, &target_weights_size);
+        if (static_cast<size_t>(batch_size) * num_joints * heatmap_height * heatmap_width != heatmaps_size ||
+            static_cast<size_t>(batch_size) * num_joints != target_weights_size)
+            throw std::runtime_error("Requested heatmap targets shape does not match the heatmaps of the pipeline");
+        rocalGetHeatmapTargets(context, &heatmaps_ptr, &target_weights_ptr);
+        // numpy views of the ring buffer, the memory is owned by the c++ lib
+        py::array_t<float> heatmaps_array = py::array_t<float>(
+                                                          {batch_size, num_joints, heatmap_height, heatmap_width},
+                                                          {sizeof(float)*num_joints*heatmap_height*heatmap_width, sizeof(float)*heatmap_height*heatmap_width, sizeof(float)*heatmap_width, sizeof(float)},
+                                                          heatmaps_ptr,
+                                                          py::cast<py::none>(Py_None));
+        py::array_t<float> target_weights_array = py::array_t<float>(
+                                                          {batch_size, num_joints, 1},
+                                                          {sizeof(float)*num_joints, sizeof(float), sizeof(float)},
+                                                          target_weights_ptr,
+                                                          py::cast<py::none>(Py_None));
+        return std::make_pair(heatmaps_array, target_weights_array);
+    }
+
     py::object wrapper_BB_cord_copy(RocalContext context, py::array_t<float> array)
     {
         auto buf = array.request();
         float* ptr = (float*) buf.ptr;
         // call pure C++ function
-        rocalGetBoundingBoxCords(context,ptr);
+        {
+            py::gil_scoped_release release;
+            rocalGetBoundingBoxCords(context,ptr);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -268,15 +490,105 @@ namespace rocal{
         auto buf = array.request();
         int* ptr = (int*) buf.ptr;
         // call pure C++ function
-        rocalGetImageSizes(context,ptr);
+        {
+            py::gil_scoped_release release;
+            rocalGetImageSizes(context,ptr);
+        }
         return py::cast<py::none>(Py_None);
     }
 
+    py::object wrapper_batch_BB_copy(RocalContext context, unsigned batch_size)
+    {
+        // Returns the boxes and labels of the batch padded to the largest per sample count, along with the counts
+        std::vector<int> counts(batch_size);
+        std::vector<int> labels;
+        std::vector<float> cords;
+        int total_count, max_count = 0;
+        {
+            py::gil_scoped_release release;
+            total_count = rocalGetBoundingBoxCount(context, counts.data());
+            labels.resize(total_count);
+            cords.resize(total_count * 4);
+            rocalGetBoundingBoxLabel(context, labels.data());
+            rocalGetBoundingBoxCords(context, cords.data());
+            for (auto count : counts)
+                max_count = std::max(max_count, count);
+        }
+        py::array_t<float> bboxes_array({(size_t)batch_size, (size_t)max_count, (size_t)4});
+        py::array_t<int> labels_array({(size_t)batch_size, (size_t)max_count});
+        py::array_t<int> counts_array(batch_size);
+        float *bboxes_ptr = bboxes_array.mutable_data();
+        int *labels_ptr = labels_array.mutable_data();
+        {
+            py::gil_scoped_release release;
+            std::fill_n(bboxes_ptr, (size_t)batch_size * max_count * 4, 0.f);
+            std::fill_n(labels_ptr, (size_t)batch_size * max_count, 0);
+            size_t offset = 0;
+            for (unsigned i = 0; i < batch_size; i++)
+            {
+                std::copy_n(cords.data() + offset * 4, counts[i] * 4, bboxes_ptr + (size_t)i * max_count * 4);
+                std::copy_n(labels.data() + offset, counts[i], labels_ptr + (size_t)i * max_count);
+                offset += counts[i];
+            }
+        }
+        std::copy(counts.begin(), counts.end(), counts_array.mutable_data());
+        return py::make_tuple(bboxes_array, labels_array, counts_array);
+    }
+
+    py::object wrapper_batch_img_sizes_copy(RocalContext context, unsigned batch_size)
+    {
+        py::array_t<int> sizes_array({(size_t)batch_size, (size_t)2});
+        int *ptr = sizes_array.mutable_data();
+        {
+            py::gil_scoped_release release;
+            rocalGetImageSizes(context, ptr);
+        }
+        return sizes_array;
+    }
+
+    py::object wrapper_batch_image_names(RocalContext context, unsigned batch_size)
+    {
+        std::vector<int> lengths(batch_size);
+        std::string names;
+        {
+            py::gil_scoped_release release;
+            names.resize(rocalGetImageNameLen(context, lengths.data()));
+            rocalGetImageName(context, &names[0]);
+        }
+        py::list names_list;
+        size_t offset = 0;
+        for (auto length : lengths)
+        {
+            names_list.append(py::str(names.data() + offset, length));
+            offset += length;
+        }
+        return names_list;
+    }
+
+    RocalPipelineStats wrapper_pipeline_stats(RocalContext context)
+    {
+        RocalPipelineStats stats;
+        if (rocalGetPipelineStats(context, &stats) != ROCAL_OK)
+            throw std::runtime_error(rocalGetErrorMessage(context));
+        return stats;
+    }
+
+    RocalAutoTuneConfig wrapper_auto_tune_config(RocalContext context)
+    {
+        RocalAutoTuneConfig config;
+        if (rocalGetAutoTuneConfig(context, &config) != ROCAL_OK)
+            throw std::runtime_error(rocalGetErrorMessage(context));
+        return config;
+    }
+
     py::object wrapper_one_hot_label_copy(RocalContext context, py::object p , unsigned numOfClasses, int dest)
     {
         auto ptr = ctypes_void_ptr(p);
         // call pure C++ function
-        rocalGetOneHotImageLabels(context, ptr, numOfClasses, dest);
+        {
+            py::gil_scoped_release release;
+            rocalGetOneHotImageLabels(context, ptr, numOfClasses, dest);
+        }
         return py::cast<py::none>(Py_None);
     }
 
@@ -284,10 +596,51 @@ namespace rocal{
     {
         void * ptr = (void*) array_ptr;
         // call pure C++ function
-        rocalGetOneHotImageLabels(context, ptr, numOfClasses, dest);
+        {
+            py::gil_scoped_release release;
+            rocalGetOneHotImageLabels(context, ptr, numOfClasses, dest);
+        }
         return py::cast<py::none>(Py_None);
     }
 
+    py::object wrapper_encoded_labels_copy(RocalContext context, py::object p, int dest)
+    {
+        auto ptr = ctypes_void_ptr(p);
+        {
+            py::gil_scoped_release release;
+            rocalCopyEncodedLabels(context, ptr, nullptr, dest);
+        }
+        return py::cast<py::none>(Py_None);
+    }
+
+    py::object wrapper_cupy_encoded_labels_copy(RocalContext context, size_t array_ptr, int dest)
+    {
+        void * ptr = (void*) array_ptr;
+        {
+            py::gil_scoped_release release;
+            rocalCopyEncodedLabels(context, ptr, nullptr, dest);
+        }
+        return py::cast<py::none>(Py_None);
+    }
+
+    std::pair<py::array_t<float>, py::array_t<float>> wrapper_get_encoded_labels(RocalContext context, int batch_size, int num_classes)
+    {
+        float* targets_ptr; float* mix_params_ptr;
+        rocalGetEncodedLabels(context, &targets_ptr, &mix_params_ptr);
+        // numpy views of the ring buffer, the memory is owned by the c++ lib
+        py::array_t<float> targets_array = py::array_t<float>(
+                                                          {batch_size, num_classes},
+                                                          {sizeof(float)*num_classes, sizeof(float)},
+                                                          targets_ptr,
+                                                          py::cast<py::none>(Py_None));
+        py::array_t<float> mix_params_array = py::array_t<float>(
+                                                          {batch_size, 6},
+                                                          {sizeof(float)*6, sizeof(float)},
+                                                          mix_params_ptr,
+                                                          py::cast<py::none>(Py_None));
+        return std::make_pair(targets_array, mix_params_array);
+    }
+
     py::object wrapper_random_bbox_crop(RocalContext context, bool all_boxes_overlap, bool no_crop, RocalFloatParam p_aspect_ratio, bool has_shape, int crop_width, int crop_height, int num_attempts, RocalFloatParam p_scaling, int total_num_attempts )
     {
         // call pure C++ function
@@ -306,16 +659,52 @@ namespace rocal{
                 py::arg("gpu_id") = 0,
                 py::arg("cpu_thread_count") = 1,
                 py::arg("prefetch_queue_depth") = 3,
-                py::arg("output_data_type") = 0);
+                py::arg("output_data_type") = 0,
+                py::arg("cpu_placement") = 0);
         m.def("rocalVerify",&rocalVerify);
-        m.def("rocalRun",&rocalRun);
-        m.def("rocalRelease",&rocalRelease);
+        m.def("rocalRun",&rocalRun, py::call_guard<py::gil_scoped_release>());
+        m.def("rocalRelease",&wrapper_release);
         // rocal_api_types.h
         py::class_<TimingInfo>(m, "TimingInfo")
             .def_readwrite("load_time",&TimingInfo::load_time)
             .def_readwrite("decode_time",&TimingInfo::decode_time)
             .def_readwrite("process_time",&TimingInfo::process_time)
-            .def_readwrite("transfer_time",&TimingInfo::transfer_time);
+            .def_readwrite("transfer_time",&TimingInfo::transfer_time)
+            .def_readwrite("decode_failure_count",&TimingInfo::decode_failure_count)
+            .def_readwrite("substitution_count",&TimingInfo::substitution_count)
+            .def_readwrite("pipeline_time",&TimingInfo::pipeline_time)
+            .def_readwrite("prepare_stage_time",&TimingInfo::prepare_stage_time)
+            .def_readwrite("meta_data_stage_time",&TimingInfo::meta_data_stage_time)
+            .def_readwrite("graph_stage_time",&TimingInfo::graph_stage_time)
+            .def_readwrite("commit_stage_time",&TimingInfo::commit_stage_time);
+        py::class_<RocalLatencyStats>(m, "LatencyStats")
+            .def_readonly("count",&RocalLatencyStats::count)
+            .def_readonly("total",&RocalLatencyStats::total)
+            .def_readonly("p50",&RocalLatencyStats::p50)
+            .def_readonly("p95",&RocalLatencyStats::p95)
+            .def_readonly("p99",&RocalLatencyStats::p99)
+            .def_readonly("max",&RocalLatencyStats::max);
+        py::class_<RocalAutoTuneConfig>(m, "AutoTuneConfig")
+            .def_readonly("prefetch_queue_depth",&RocalAutoTuneConfig::prefetch_queue_depth)
+            .def_readonly("cpu_thread_count",&RocalAutoTuneConfig::cpu_thread_count)
+            .def_readonly("done",&RocalAutoTuneConfig::done);
+        py::class_<RocalPipelineStats>(m, "PipelineStats")
+            .def_readonly("read",&RocalPipelineStats::read)
+            .def_readonly("decode",&RocalPipelineStats::decode)
+            .def_readonly("output_wait",&RocalPipelineStats::output_wait)
+            .def_readonly("consumer_wait",&RocalPipelineStats::consumer_wait)
+            .def_readonly("process",&RocalPipelineStats::process)
+            .def_readonly("graph",&RocalPipelineStats::graph)
+            .def_readonly("meta_data",&RocalPipelineStats::meta_data)
+            .def_readonly("box_encode",&RocalPipelineStats::box_encode)
+            .def_readonly("copy_out",&RocalPipelineStats::copy_out)
+            .def_readonly("bytes_read",&RocalPipelineStats::bytes_read)
+            .def_readonly("ring_buffer_level",&RocalPipelineStats::ring_buffer_level)
+            .def_readonly("ring_buffer_depth",&RocalPipelineStats::ring_buffer_depth)
+            .def_readonly("ring_buffer_mean_level",&RocalPipelineStats::ring_buffer_mean_level)
+            .def_readonly("circular_buffer_level",&RocalPipelineStats::circular_buffer_level)
+            .def_readonly("circular_buffer_depth",&RocalPipelineStats::circular_buffer_depth)
+            .def_readonly("circular_buffer_mean_level",&RocalPipelineStats::circular_buffer_mean_level);
         py::module types_m = m.def_submodule("types");
         types_m.doc() = "Datatypes and options used by ROCAL";
         py::enum_<RocalStatus>(types_m, "RocalStatus", "Status info")
@@ -334,6 +723,10 @@ namespace rocal{
             .value("FLOAT16",ROCAL_FP16)
             .value("UINT8",ROCAL_U8)
             .export_values();
+        py::enum_<RocalCpuPlacement>(types_m, "RocalCpuPlacement", "Placement of the threads and buffers on the NUMA nodes")
+            .value("CPU_PLACEMENT_NONE", ROCAL_CPU_PLACEMENT_NONE)
+            .value("CPU_PLACEMENT_NUMA", ROCAL_CPU_PLACEMENT_NUMA)
+            .export_values();
         py::enum_<RocalOutputMemType>(types_m, "RocalOutputMemType", "Output memory types")
             .value("CPU_MEMORY", ROCAL_MEMCPY_HOST)
             .value("GPU_MEMORY", ROCAL_MEMCPY_GPU)
@@ -405,6 +798,7 @@ namespace rocal{
         m.def("Cifar10LabelReader",&rocalCreateTextCifar10LabelReader);
         m.def("RandomBBoxCrop",&wrapper_random_bbox_crop);
         m.def("COCOReader",&rocalCreateCOCOReader);
+        m.def("COCOReaderKeyPoints",&rocalCreateCOCOReaderKeyPoints);
         m.def("VideoMetaDataReader",&rocalCreateVideoLabelReader);
         m.def("getImageLabels",&wrapper_label_copy);
         m.def("getCupyImageLabels",&wrapper_cupy_label_copy);
@@ -414,11 +808,30 @@ namespace rocal{
         m.def("rocalGetEncodedBoxesAndLables",&wrapper_get_encoded_bbox_label);
         m.def("getImgSizes",&wrapper_img_sizes_copy);
         m.def("getBoundingBoxCount",&wrapper_labels_BB_count_copy);
+        m.def("getBatchBoundingBoxes",&wrapper_batch_BB_copy);
+        m.def("getBatchMaskPolygons",&wrapper_batch_mask_polygons);
+        m.def("getBatchMasks",&wrapper_batch_masks);
+        m.def("getMetaDataFields",&wrapper_meta_data_fields);
+        m.def("getBatchImageSizes",&wrapper_batch_img_sizes_copy);
+        m.def("getBatchImageNames",&wrapper_batch_image_names);
         m.def("getOneHotEncodedLabels",&wrapper_one_hot_label_copy);
         m.def("getCupyOneHotEncodedLabels",&wrapper_cupy_one_hot_label_copy);
         m.def("isEmpty",&rocalIsEmpty);
         m.def("BoxEncoder",&rocalBoxEncoder);
+        m.def("HeatmapTargets",&rocalHeatmapTargets);
+        m.def("rocalGetHeatmapTargets",&wrapper_get_heatmap_targets);
+        m.def("rocalCopyHeatmapTargets",&wrapper_copy_heatmap_targets);
+        m.def("LabelEncoder",&rocalLabelEncoder);
+        m.def("rocalGetEncodedLabels",&wrapper_get_encoded_labels);
+        m.def("getEncodedLabels",&wrapper_encoded_labels_copy);
+        m.def("getCupyEncodedLabels",&wrapper_cupy_encoded_labels_copy);
         m.def("getTimingInfo",rocalGetTimingInfo);
+        m.def("enableStats",&rocalEnableStats);
+        m.def("enableTracing",&rocalEnableTracing);
+        m.def("dumpTrace",&rocalDumpTrace, py::arg("trace_file") = nullptr);
+        m.def("getPipelineStats",&wrapper_pipeline_stats, py::call_guard<py::gil_scoped_release>());
+        m.def("enableAutoTune",&rocalEnableAutoTune);
+        m.def("getAutoTuneConfig",&wrapper_auto_tune_config);
         // rocal_api_parameter.h
         m.def("setSeed",&rocalSetSeed);
         m.def("getSeed",&rocalGetSeed);
@@ -438,6 +851,8 @@ namespace rocal{
         m.def("GetFloatValue",&rocalGetFloatValue);
         // rocal_api_data_transfer.h
         m.def("rocalCopyToOutput",&wrapper_copy_to_output);
+        m.def("rocalCopyToOutputRagged",&wrapper_copy_to_output_ragged);
+        m.def("rocalLeaseOutput",&wrapper_lease_output);
         m.def("rocalToTensor",&wrapper_tensor);
         m.def("rocalToTensor32",&wrapper_tensor32);
         m.def("rocalToTensor16",&wrapper_tensor16);
@@ -492,7 +907,10 @@ namespace rocal{
             py::arg("loop") = false,
             py::arg("frame_step"),
             py::arg("frame_stride"));
-        m.def("rocalResetLoaders",&rocalResetLoaders);
+        m.def("rocalResetLoaders",&rocalResetLoaders, py::call_guard<py::gil_scoped_release>());
+        m.def("setSampleInfoCacheDir",&rocalSetSampleInfoCacheDir);
+        m.def("setDecodeThreadBudget",&rocalSetDecodeThreadBudget);
+        m.def("setDecodeShare",&rocalSetDecodeShare);
         // rocal_api_augmentation.h
         m.def("SSDRandomCrop",&rocalSSDRandomCrop,
             py::return_value_policy::reference,
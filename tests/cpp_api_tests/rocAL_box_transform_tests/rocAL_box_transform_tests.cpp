@@ -0,0 +1,103 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <omp.h>
+
+#include "box_transform_cpu.h"
+
+// Crops a masked batch with the threaded crop_boxes(), the label of every box is its mask id so a kept box must keep both paired
+#define SAMPLE_COUNT 64
+#define BOXES_PER_SAMPLE 100
+
+static BoundingBoxBatchData make_batch()
+{
+    BoundingBoxBatchData bb;
+    auto store = std::make_shared<MaskStore>();
+    store->entries.resize(SAMPLE_COUNT * BOXES_PER_SAMPLE);
+    bb.masks = store;
+    int id = 0;
+    for (int i = 0; i < SAMPLE_COUNT; i++)
+    {
+        for (int j = 0; j < BOXES_PER_SAMPLE; j++, id++)
+        {
+            float x = (j % 10) * 0.1f, y = (j / 10) * 0.1f;
+            bb.add({x, y, x + 0.1f, y + 0.1f}, id, id);
+        }
+        bb.end_sample();
+    }
+    return bb;
+}
+
+static int check(const char *name, const BoundingBoxBatchData &in, const BoundingBoxBatchData &out)
+{
+    int errors = 0;
+    if (out.sample_count() != in.sample_count() || out.labels.size() != out.cords.size() || out.mask_ids.size() != out.cords.size())
+    {
+        std::cout << name << ": inconsistent output sizes\n";
+        return 1;
+    }
+    for (size_t i = 0; i < out.sample_count(); i++)
+    {
+        if (out.count(i) == 0)
+            errors++;
+        for (size_t k = out.offsets[i]; k < out.offsets[i + 1]; k++)
+        {
+            // The boxes of a sample must come from that sample
+            int first = i * BOXES_PER_SAMPLE;
+            if (out.labels[k] != out.mask_ids[k] || out.mask_ids[k] < first || out.mask_ids[k] >= first + BOXES_PER_SAMPLE)
+                errors++;
+        }
+    }
+    std::cout << name << ": " << out.cords.size() << " boxes kept, " << errors << " errors\n";
+    return errors;
+}
+
+int main()
+{
+    std::cout << "Running the box transform tests on " << omp_get_max_threads() << " threads\n";
+    const BoundingBoxBatchData in = make_batch();
+    BoxCropOptions options;
+    options.center_in_window = true;
+    // A different window per sample so the threads do not all keep the same boxes
+    auto window_of = [](int i) {
+        float l = (i % 4) * 0.1f;
+        return BoxCropWindow{{l, 0.2f, l + 0.5f, 0.8f}, 0.f};
+    };
+    std::vector<BoxCropWindow> windows(SAMPLE_COUNT);
+    for (int i = 0; i < SAMPLE_COUNT; i++)
+        windows[i] = window_of(i);
+
+    int errors = 0;
+    BoundingBoxBatchData out;
+    crop_boxes(in, out, window_of, options);
+    errors += check("crop_boxes with window_of", in, out);
+    crop_boxes(in, out, windows.data(), options);
+    errors += check("crop_boxes with windows", in, out);
+
+    std::cout << (errors ? "FAILED" : "PASSED") << std::endl;
+    return errors ? -1 : 0;
+}
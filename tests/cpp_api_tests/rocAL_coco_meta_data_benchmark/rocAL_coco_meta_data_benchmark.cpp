@@ -0,0 +1,174 @@
+/*
+MIT License
+
+Copyright (c) 2018 - 2023 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+#include "rocal_api.h"
+
+using namespace std::chrono;
+
+// Measures the per batch cost of the COCO meta data: the reader lookup, the box updates of the SSD random crop and flip
+// meta nodes, the optional box encoder and the copy of the boxes to the user, with the image work kept small
+int test(const char *path, const char *json_path, int batch_size, int processing_device, int iterations, int box_encoder);
+int main(int argc, const char **argv)
+{
+    // check command-line usage
+    const int MIN_ARG_COUNT = 3;
+    printf("Usage: rocal_coco_meta_data_benchmark <image-dataset-folder> <annotation-json> <batch_size> <gpu=1/cpu=0> <iterations> <box_encoder=1>\n");
+    if (argc < MIN_ARG_COUNT)
+        return -1;
+
+    int argIdx = 0;
+    const char *path = argv[++argIdx];
+    const char *json_path = argv[++argIdx];
+    int batch_size = 128;
+    int processing_device = 0;
+    int iterations = 100;
+    int box_encoder = 1;
+
+    if (argc >= argIdx + MIN_ARG_COUNT)
+        batch_size = atoi(argv[++argIdx]);
+
+    if (argc >= argIdx + MIN_ARG_COUNT)
+        processing_device = atoi(argv[++argIdx]);
+
+    if (argc >= argIdx + MIN_ARG_COUNT)
+        iterations = atoi(argv[++argIdx]);
+
+    if (argc >= argIdx + MIN_ARG_COUNT)
+        box_encoder = atoi(argv[++argIdx]);
+
+    return test(path, json_path, batch_size, processing_device, iterations, box_encoder);
+}
+
+static void print_percentiles(const char *name, std::vector<long long> &samples)
+{
+    if (samples.empty())
+        return;
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double p) { return samples[std::min(samples.size() - 1, (size_t)(p * samples.size()))]; };
+    long long total = 0;
+    for (auto s : samples)
+        total += s;
+    printf("%-14s count %8lu mean %8lld us p50 %8lld us p95 %8lld us max %8lld us\n", name, samples.size(), total / (long long)samples.size(),
+           at(0.5), at(0.95), samples.back());
+}
+
+int test(const char *path, const char *json_path, int batch_size, int processing_device, int iterations, int box_encoder)
+{
+    std::cout << ">>> Running on " << (processing_device ? "GPU" : "CPU") << std::endl;
+    printf(">>> Batch size = %d -- iterations = %d -- box encoder %s\n", batch_size, iterations, box_encoder ? "on" : "off");
+
+    auto handle = rocalCreate(batch_size, processing_device ? RocalProcessMode::ROCAL_PROCESS_GPU : RocalProcessMode::ROCAL_PROCESS_CPU, 0, 1);
+
+    if (rocalGetStatus(handle) != ROCAL_OK) {
+        std::cout << "Could not create the Rocal context\n";
+        return -1;
+    }
+
+    /*>>>>>>>>>>>>>>>>>>> Graph description <<<<<<<<<<<<<<<<<<<*/
+    rocalSetSeed(0);
+    rocalCreateCOCOReader(handle, json_path, true);
+    RocalImage input = rocalJpegCOCOFileSource(handle, path, json_path, RocalImageColor::ROCAL_COLOR_RGB24, 1, false, true, false,
+                                               ROCAL_USE_USER_GIVEN_SIZE_RESTRICTED, 300, 300);
+    if (rocalGetStatus(handle) != ROCAL_OK) {
+        std::cout << "COCO source could not initialize : " << rocalGetErrorMessage(handle) << std::endl;
+        return -1;
+    }
+    RocalImage cropped = rocalSSDRandomCrop(handle, input, false);
+    RocalImage resized = rocalResize(handle, cropped, 300, 300, false);
+    rocalFlip(handle, resized, true);
+
+    if (box_encoder) {
+        // A single anchor per cell of a 38x38 grid, the size of the first feature map of SSD300
+        const int grid = 38;
+        std::vector<float> anchors;
+        for (int y = 0; y < grid; y++) {
+            for (int x = 0; x < grid; x++) {
+                float cx = (x + 0.5f) / grid, cy = (y + 0.5f) / grid, half = 0.1f;
+                anchors.insert(anchors.end(), {std::max(0.f, cx - half), std::max(0.f, cy - half), std::min(1.f, cx + half), std::min(1.f, cy + half)});
+            }
+        }
+        std::vector<float> means = {0, 0, 0, 0}, stds = {0.1f, 0.1f, 0.2f, 0.2f};
+        rocalBoxEncoder(handle, anchors, 0.5, means, stds, true, 1.0);
+    }
+
+    rocalVerify(handle);
+    if (rocalGetStatus(handle) != ROCAL_OK) {
+        std::cout << "Could not verify the augmentation graph " << rocalGetErrorMessage(handle);
+        return -1;
+    }
+
+    /*>>>>>>>>>>>>>>>>>>> Benchmark <<<<<<<<<<<<<<<<<<<*/
+    std::vector<long long> run_times, copy_times;
+    std::vector<int> box_counts(batch_size);
+    std::vector<int> labels;
+    std::vector<float> cords;
+    long long total_boxes = 0;
+    int i = 0;
+    high_resolution_clock::time_point t1 = high_resolution_clock::now();
+    while (i++ < iterations) {
+        if (rocalIsEmpty(handle))
+            rocalResetLoaders(handle);
+        auto run_start = high_resolution_clock::now();
+        if (rocalRun(handle) != 0)
+            break;
+        auto copy_start = high_resolution_clock::now();
+        int count = rocalGetBoundingBoxCount(handle, box_counts.data());
+        labels.resize(count);
+        cords.resize(count * 4);
+        rocalGetBoundingBoxLabel(handle, labels.data());
+        rocalGetBoundingBoxCords(handle, cords.data());
+        auto copy_end = high_resolution_clock::now();
+        run_times.push_back(duration_cast<microseconds>(copy_start - run_start).count());
+        copy_times.push_back(duration_cast<microseconds>(copy_end - copy_start).count());
+        total_boxes += count;
+    }
+    high_resolution_clock::time_point t2 = high_resolution_clock::now();
+    auto dur = duration_cast<microseconds>(t2 - t1).count();
+
+    printf("Batches %lu, boxes per batch %.1f\n", run_times.size(), run_times.empty() ? 0. : (double)total_boxes / run_times.size());
+    print_percentiles("rocalRun", run_times);
+    print_percentiles("Boxes copy", copy_times);
+    RocalPipelineStats stats;
+    if (rocalGetPipelineStats(handle, &stats) == ROCAL_OK) {
+        auto print_stage = [](const char *name, const RocalLatencyStats &stage) {
+            printf("%-14s count %8llu p50 %8llu us p95 %8llu us p99 %8llu us max %8llu us\n", name, stage.count, stage.p50, stage.p95, stage.p99, stage.max);
+        };
+        // The meta data stage covers the box updates of the meta nodes, the box encoder is timed separately
+        print_stage("Meta data", stats.meta_data);
+        print_stage("Box encode", stats.box_encode);
+        print_stage("Process", stats.process);
+    }
+    std::cout << ">>>>> Total Elapsed Time " << dur / 1000000 << " sec " << dur % 1000000 << " us " << std::endl;
+
+    rocalRelease(handle);
+
+    return 0;
+}
@@ -49,12 +49,12 @@ using namespace cv;
 using namespace std::chrono;
 
 
-int test(int test_case, const char* path, int rgb, int processing_device, int width, int height, int batch_size, int shards, int shuffle);
+int test(int test_case, const char* path, int rgb, int processing_device, int width, int height, int batch_size, int shards, int shuffle, int ragged);
 int main(int argc, const char ** argv)
 {
     // check command-line usage
     const int MIN_ARG_COUNT = 2;
-    printf( "Usage: rocal_performance_tests <image-dataset-folder> <width> <height> <test_case> <batch_size> <gpu=1/cpu=0> <rgb=1/grayscale=0> <shard_count>  <shuffle=1>\n" );
+    printf( "Usage: rocal_performance_tests <image-dataset-folder> <width> <height> <test_case> <batch_size> <gpu=1/cpu=0> <rgb=1/grayscale=0> <shard_count>  <shuffle=1> <ragged_output=1/padded_output=0>\n" );
     if(argc < MIN_ARG_COUNT)
         return -1;
 
@@ -69,6 +69,7 @@ int main(int argc, const char ** argv)
     int batch_size = 10;
     int shards = 4;
     int shuffle = 0;
+    int ragged = 0;
 
     if (argc >= argIdx + MIN_ARG_COUNT)
         test_case = atoi(argv[++argIdx]);
@@ -88,12 +89,15 @@ int main(int argc, const char ** argv)
     if (argc >= argIdx + MIN_ARG_COUNT)
 	shuffle = atoi(argv[++argIdx]);
 
-    test(test_case, path, rgb, processing_device, width, height, batch_size, shards, shuffle);
+    if (argc >= argIdx + MIN_ARG_COUNT)
+        ragged = atoi(argv[++argIdx]);
+
+    test(test_case, path, rgb, processing_device, width, height, batch_size, shards, shuffle, ragged);
 
     return 0;
 }
 
-int test(int test_case, const char* path, int rgb, int processing_device, int width, int height, int batch_size, int shards, int shuffle)
+int test(int test_case, const char* path, int rgb, int processing_device, int width, int height, int batch_size, int shards, int shuffle, int ragged)
 {
     size_t num_threads = shards;
     int inputBatchSize = batch_size;
@@ -309,6 +313,8 @@ int test(int test_case, const char* path, int rgb, int processing_device, int wi
         std::cout << "Could not verify the augmentation graph " << rocalGetErrorMessage(handle);
         return -1;
     }
+    // Records the latency distribution of every stage, printed along with the timing info at the end
+    rocalEnableStats(handle, true);
 
 
 
@@ -320,12 +326,23 @@ int test(int test_case, const char* path, int rgb, int processing_device, int wi
 //    printf("Remaining images %d \n", rocalGetRemainingImages(handle));
     high_resolution_clock::time_point t1 = high_resolution_clock::now();
 
+    // Compares the bytes copied out per batch with every sample padded to the output size against the packed ragged output
+    size_t padded_batch_size = rocalGetOutputWidth(handle) * rocalGetOutputHeight(handle) * (rgb ? 3 : 1) * rocalGetAugmentationBranchCount(handle);
+    size_t padded_bytes = 0, ragged_bytes = 0;
+    std::vector<unsigned char> output_buffer(ragged ? padded_batch_size : 0);
     int i = 0;
     while (i++ < 100 && !rocalIsEmpty(handle)){
 
         if (rocalRun(handle) != 0)
             break;
 
+        if (ragged)
+        {
+            padded_bytes += padded_batch_size;
+            ragged_bytes += rocalGetOutputRaggedSize(handle);
+            rocalCopyToOutputRagged(handle, output_buffer.data(), output_buffer.size(), nullptr, nullptr);
+        }
+
         //auto last_colot_temp = rocalGetIntValue(color_temp_adj);
         //rocalUpdateIntParameter(last_colot_temp + 1, color_temp_adj);
 
@@ -341,6 +358,22 @@ int test(int test_case, const char* path, int rgb, int processing_device, int wi
     std::cout << "Process  time " << rocal_timing.process_time << std::endl;
     std::cout << "Transfer time " << rocal_timing.transfer_time << std::endl;
     std::cout << "Total time " << dur << std::endl;
+    RocalPipelineStats stats;
+    if (rocalGetPipelineStats(handle, &stats) == ROCAL_OK) {
+        auto print_stage = [](const char *name, const RocalLatencyStats &stage) {
+            printf("%-14s count %8llu p50 %8llu us p95 %8llu us p99 %8llu us max %8llu us\n", name, stage.count, stage.p50, stage.p95, stage.p99, stage.max);
+        };
+        print_stage("Read", stats.read);
+        print_stage("Decode", stats.decode);
+        print_stage("Output wait", stats.output_wait);
+        print_stage("Consumer wait", stats.consumer_wait);
+        print_stage("Process", stats.process);
+        print_stage("Copy out", stats.copy_out);
+        printf("Bytes read %llu, ring buffer mean level %.2f of %llu, circular buffers mean level %.2f of %llu\n", stats.bytes_read,
+               stats.ring_buffer_mean_level, stats.ring_buffer_depth, stats.circular_buffer_mean_level, stats.circular_buffer_depth);
+    }
+    if (ragged && padded_bytes)
+        std::cout << "Output bytes padded " << padded_bytes << " ragged " << ragged_bytes << " (" << (100 * ragged_bytes / padded_bytes) << "%)" << std::endl;
     std::cout << ">>>>> Total Elapsed Time " << dur / 1000000 << " sec " << dur % 1000000 << " us " << std::endl;
 
     rocalRelease(handle);
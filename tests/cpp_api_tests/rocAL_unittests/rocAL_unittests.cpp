@@ -937,6 +937,12 @@ int test(int test_case, int reader_type, const char *path, const char *outName,
     std::cout << "Decode   time " << rocal_timing.decode_time << std::endl;
     std::cout << "Process  time " << rocal_timing.process_time << std::endl;
     std::cout << "Transfer time " << rocal_timing.transfer_time << std::endl;
+    if (rocal_timing.decode_failure_count)
+        std::cout << "Decode failures " << rocal_timing.decode_failure_count << " substituted samples " << rocal_timing.substitution_count << std::endl;
+    if (rocal_timing.pipeline_time)
+        std::cout << "Stage occupancy prepare " << (100 * rocal_timing.prepare_stage_time / rocal_timing.pipeline_time) << "% meta data "
+                  << (100 * rocal_timing.meta_data_stage_time / rocal_timing.pipeline_time) << "% graph " << (100 * rocal_timing.graph_stage_time / rocal_timing.pipeline_time)
+                  << "% commit " << (100 * rocal_timing.commit_stage_time / rocal_timing.pipeline_time) << "%" << std::endl;
     std::cout << ">>>>> Total Elapsed Time " << dur / 1000000 << " sec " << dur % 1000000 << " us " << std::endl;
     rocalRelease(handle);
     mat_input.release();
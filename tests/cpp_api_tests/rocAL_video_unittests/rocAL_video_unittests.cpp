@@ -71,7 +71,7 @@ int main(int argc, const char **argv)
     const int MIN_ARG_COUNT = 2;
     if (argc < MIN_ARG_COUNT)
     {
-        printf("Usage: rocal_video_unittests <video_file/video_dataset_folder/text file> <reader_case> <processing_device=1/cpu=0> <hardware_decode_mode=0/1> <batch_size> <sequence_length> <frame_step> <frame_stride> <gray_scale/rgb> <display_on_off> <shuffle:0/1> <resize_width> <resize_height> <filelist_framenum:0/1> <enable_meta_data:0/1> <enable_framenumber:0/1> <enable_timestamps:0/1> <enable_sequence_rearrange:0/1>\n");
+        printf("Usage: rocal_video_unittests <video_file/video_dataset_folder/text file> <reader_case> <processing_device=1/cpu=0> <hardware_decode_mode=0/1> <batch_size> <sequence_length> <frame_step> <frame_stride> <gray_scale/rgb> <display_on_off> <shuffle:0/1> <resize_width> <resize_height> <filelist_framenum:0/1> <enable_meta_data:0/1> <enable_framenumber:0/1> <enable_timestamps:0/1> <enable_sequence_rearrange:0/1> <benchmark:0/1>\n");
         return -1;
     }
 
@@ -96,6 +96,7 @@ int main(int argc, const char **argv)
     bool enable_timestamps = true;
     bool enable_sequence_rearrange = false;
     bool is_output = true;
+    bool benchmark = false;
     unsigned hardware_decode_mode = 0;
     if (argc >= argIdx + MIN_ARG_COUNT)
         reader_case = atoi(argv[++argIdx]);
@@ -131,6 +132,8 @@ int main(int argc, const char **argv)
         enable_timestamps = atoi(argv[++argIdx]) ? true : false;
     if (argc >= argIdx + MIN_ARG_COUNT)
         enable_sequence_rearrange = atoi(argv[++argIdx]) ? true : false;
+    if (argc >= argIdx + MIN_ARG_COUNT)
+        benchmark = atoi(argv[++argIdx]) ? true : false;
 
     auto decoder_mode = ((hardware_decode_mode == 1) ? RocalDecodeDevice::ROCAL_HW_DECODE : RocalDecodeDevice::ROCAL_SW_DECODE);
     if (!IsPathExist(source_path))
@@ -142,6 +145,12 @@ int main(int argc, const char **argv)
     {
         is_output = false;
     }
+    if (benchmark)
+    {
+        // Only the load and decode throughput is measured, the outputs are not saved or printed
+        save_frames = false;
+        enable_metadata = enable_framenumbers = enable_timestamps = false;
+    }
     std::cerr << "Batch size : " << input_batch_size << std::endl;
     std::cerr << "Sequence length : " << sequence_length << std::endl;
     std::cerr << "Frame step : " << frame_step << std::endl;
@@ -354,6 +363,13 @@ int main(int argc, const char **argv)
     std::cout << "Process  time " << rocal_timing.process_time << std::endl;
     std::cout << "Transfer time " << rocal_timing.transfer_time << std::endl;
     std::cout << ">>>>> " << counter << " images/frames Processed. Total Elapsed Time " << dur / 1000000 << " sec " << dur % 1000000 << " us " << std::endl;
+    if (benchmark && dur)
+    {
+        double elapsed_sec = dur / 1000000.0;
+        std::cout << ">>>>> Benchmark : " << count << " batches, " << counter / elapsed_sec << " sequences/sec, "
+                  << (counter * ouput_frames_per_sequence) / elapsed_sec << " frames/sec, average decode time per batch "
+                  << (count ? rocal_timing.decode_time / count : 0) << std::endl;
+    }
     rocalRelease(handle);
     mat_input.release();
     return 0;